@@ -87,6 +87,8 @@ def _array1d_from_pointer(pointer, dtype, size):
 libwarpx.amrex_init.argtypes = (ctypes.c_int, _LP_LP_c_char)
 libwarpx.warpx_getParticleStructs.restype = _LP_particle_p
 libwarpx.warpx_getParticleArrays.restype = _LP_LP_c_double
+libwarpx.warpx_getParticleCompIndex.argtypes = [ctypes.c_char_p]
+libwarpx.warpx_getParticleCompIndex.restype = ctypes.c_int
 libwarpx.warpx_getEfield.restype = _LP_LP_c_double
 libwarpx.warpx_getEfieldLoVects.restype = _LP_c_int
 libwarpx.warpx_getEfieldCP.restype = _LP_LP_c_double
@@ -154,6 +156,22 @@ def get_nattr():
     # --- The -3 is because the comps include the velocites
     return libwarpx.warpx_nComps() - 3
 
+def get_particle_comp_index(name):
+    '''
+
+    Get the index of the particle attribute called name ('w', 'ux', 'Ex', ...)
+    in the particle array data. The layout depends on the build options, so the
+    accessors must not hard-code it. Raises an error if the attribute is not
+    stored with this build. With TRANSIENT_PARTICLE_FIELDS=TRUE, the fields
+    ('Ex', ..., 'Bz') are not stored with the particles: they are gathered
+    when requested, and changing them does not affect the particle push.
+
+    '''
+    comp = libwarpx.warpx_getParticleCompIndex(name.encode('utf-8'))
+    if comp < 0:
+        raise ValueError("The particle attribute '%s' is not stored by this build of WarpX"%name)
+    return comp
+
 def amrex_init(argv):
     # --- Construct the ctype list of strings to pass in
     argc = len(argv)
@@ -317,6 +335,11 @@ def get_particle_structs(species_number):
     The data for the numpy arrays are not copied, but share the underlying
     memory buffer with WarpX. The numpy arrays are fully writeable.
 
+    Note that WarpX works on the positions stored in the particle arrays
+    (see get_particle_x, etc.): the positions in the structs are only up to
+    date after the particles are redistributed, and changes to them are
+    overwritten at the next redistribution.
+
     Parameters
     ----------
 
@@ -391,8 +414,8 @@ def get_particle_x(species_number):
     positions on each tile.
 
     '''
-    structs = get_particle_structs(species_number)
-    return [struct['x'] for struct in structs]
+
+    return get_particle_arrays(species_number, get_particle_comp_index('x'))
 
 
 def get_particle_y(species_number):
@@ -402,8 +425,8 @@ def get_particle_y(species_number):
     positions on each tile.
 
     '''
-    structs = get_particle_structs(species_number)
-    return [struct['y'] for struct in structs]
+
+    return get_particle_arrays(species_number, get_particle_comp_index('y'))
 
 
 def get_particle_z(species_number):
@@ -413,8 +436,8 @@ def get_particle_z(species_number):
     positions on each tile.
 
     '''
-    structs = get_particle_structs(species_number)
-    return [struct['z'] for struct in structs]
+
+    return get_particle_arrays(species_number, get_particle_comp_index('z'))
 
 
 def get_particle_id(species_number):
@@ -447,7 +470,7 @@ def get_particle_weight(species_number):
 
     '''
 
-    return get_particle_arrays(species_number, 0)
+    return get_particle_arrays(species_number, get_particle_comp_index('w'))
 
 
 def get_particle_ux(species_number):
@@ -458,7 +481,7 @@ def get_particle_ux(species_number):
 
     '''
 
-    return get_particle_arrays(species_number, 1)
+    return get_particle_arrays(species_number, get_particle_comp_index('ux'))
 
 
 def get_particle_uy(species_number):
@@ -469,7 +492,7 @@ def get_particle_uy(species_number):
 
     '''
 
-    return get_particle_arrays(species_number, 2)
+    return get_particle_arrays(species_number, get_particle_comp_index('uy'))
 
 
 def get_particle_uz(species_number):
@@ -480,7 +503,7 @@ def get_particle_uz(species_number):
 
     '''
 
-    return get_particle_arrays(species_number, 3)
+    return get_particle_arrays(species_number, get_particle_comp_index('uz'))
 
 
 def get_particle_Ex(species_number):
@@ -491,7 +514,7 @@ def get_particle_Ex(species_number):
 
     '''
 
-    return get_particle_arrays(species_number, 4)
+    return get_particle_arrays(species_number, get_particle_comp_index('Ex'))
 
 
 def get_particle_Ey(species_number):
@@ -502,7 +525,7 @@ def get_particle_Ey(species_number):
 
     '''
 
-    return get_particle_arrays(species_number, 5)
+    return get_particle_arrays(species_number, get_particle_comp_index('Ey'))
 
 
 def get_particle_Ez(species_number):
@@ -513,7 +536,7 @@ def get_particle_Ez(species_number):
 
     '''
 
-    return get_particle_arrays(species_number, 6)
+    return get_particle_arrays(species_number, get_particle_comp_index('Ez'))
 
 
 def get_particle_Bx(species_number):
@@ -524,7 +547,7 @@ def get_particle_Bx(species_number):
 
     '''
 
-    return get_particle_arrays(species_number, 7)
+    return get_particle_arrays(species_number, get_particle_comp_index('Bx'))
 
 
 def get_particle_By(species_number):
@@ -535,7 +558,7 @@ def get_particle_By(species_number):
 
     '''
 
-    return get_particle_arrays(species_number, 8)
+    return get_particle_arrays(species_number, get_particle_comp_index('By'))
 
 
 def get_particle_Bz(species_number):
@@ -546,7 +569,7 @@ def get_particle_Bz(species_number):
 
     '''
 
-    return get_particle_arrays(species_number, 9)
+    return get_particle_arrays(species_number, get_particle_comp_index('Bz'))
 
 
 def get_mesh_electric_field(level, direction, include_ghosts=True):
@@ -7,6 +7,7 @@
 #include <WarpX.H>
 #include <WarpXConst.H>
 #include <WarpX_f.H>
+#include <WarpXParticleKernels.H>
 #include <ParticleContainer.H>
 
 using namespace amrex;
@@ -301,10 +302,13 @@ LaserParticleContainer::Evolve (int lev,
                                 MultiFab* rho, MultiFab*,
                                 const MultiFab*, const MultiFab*, const MultiFab*,
                                 const MultiFab*, const MultiFab*, const MultiFab*,
-                                Real t, Real dt)
+                                Real t, Real dt, EvolvePhase phase)
 {
+    // The laser particles do not gather fields: they are all evolved in the Interior phase.
+    if (phase == EvolvePhase::Boundary) return;
+    if (NumActiveTiles(lev) == 0) return;
+
     BL_PROFILE("Laser::Evolve()");
-    BL_PROFILE_VAR_NS("Laser::Evolve::Copy", blp_copy);
     BL_PROFILE_VAR_NS("PICSAR::LaserParticlePush", blp_pxr_pp);
     BL_PROFILE_VAR_NS("PICSAR::LaserCurrentDepo", blp_pxr_cd);
 
@@ -329,8 +333,15 @@ LaserParticleContainer::Evolve (int lev,
 #pragma omp parallel
 #endif
     {
-	Vector<Real> xp, yp, zp, giv, plane_Xp, plane_Yp, amplitude_E;
-        FArrayBox local_rho, local_jx, local_jy, local_jz;
+        ParticleScratch& scratch = ParticleScratch::ThreadLocal();
+        Vector<Real>& giv = scratch.giv;
+        Vector<Real>& plane_Xp = scratch.plane_Xp;
+        Vector<Real>& plane_Yp = scratch.plane_Yp;
+        Vector<Real>& amplitude_E = scratch.amplitude_E;
+        FArrayBox& local_rho = scratch.local_rho;
+        FArrayBox& local_jx = scratch.local_jx;
+        FArrayBox& local_jy = scratch.local_jy;
+        FArrayBox& local_jz = scratch.local_jz;
 
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
 	{
@@ -340,6 +351,9 @@ LaserParticleContainer::Evolve (int lev,
 
             auto& attribs = pti.GetAttribs();
 
+            auto&  xp = attribs[PIdx::x ];
+            auto&  yp = attribs[PIdx::y ];
+            auto&  zp = attribs[PIdx::z ];
             auto&  wp = attribs[PIdx::w ];
             auto& uxp = attribs[PIdx::ux];
             auto& uyp = attribs[PIdx::uy];
@@ -352,17 +366,10 @@ LaserParticleContainer::Evolve (int lev,
 	    FArrayBox& jyfab = jy[pti];
 	    FArrayBox& jzfab = jz[pti];
 
-	            giv.resize(np);
-               plane_Xp.resize(np);
-               plane_Yp.resize(np);
-            amplitude_E.resize(np);
-
-	    //
-	    // copy data from particle container to temp arrays
-	    //
-	    BL_PROFILE_VAR_START(blp_copy);
-            pti.GetPosition(xp, yp, zp);
-	    BL_PROFILE_VAR_STOP(blp_copy);
+            scratch.resize(giv, np);
+            scratch.resize(plane_Xp, np);
+            scratch.resize(plane_Yp, np);
+            scratch.resize(amplitude_E, np);
 
 	    for (int i = 0; i < np; ++i)
             {
@@ -397,7 +404,7 @@ LaserParticleContainer::Evolve (int lev,
                 Box grown_box;
                 const std::array<Real, 3>& xyzmin = xyzmin_tile;
                 tile_box.grow(ngRho);
-                local_rho.resize(tile_box);
+                scratch.resize(local_rho, tile_box);
                 local_rho = 0.0;
                 data_ptr = local_rho.dataPtr();
                 rholen = local_rho.length();
@@ -411,14 +418,14 @@ LaserParticleContainer::Evolve (int lev,
                 const long ny = 0;
                 const long nz = rholen[1]-1-2*ngRho;
 #endif
-            	warpx_charge_deposition(data_ptr, &np,
-					xp.data(), yp.data(), zp.data(), wp.data(),
-                                        &this->charge,
-					&xyzmin[0], &xyzmin[1], &xyzmin[2],
-                                        &dx[0], &dx[1], &dx[2], &nx, &ny, &nz,
-                                        &ngRho, &ngRho, &ngRho,
-					&WarpX::nox,&WarpX::noy,&WarpX::noz,
-                                        &lvect, &WarpX::charge_deposition_algo);
+            	ParticleKernels::charge_deposition(data_ptr, &np,
+                                                  xp.data(), yp.data(), zp.data(), wp.data(),
+                                                  &this->charge,
+                                                  &xyzmin[0], &xyzmin[1], &xyzmin[2],
+                                                  &dx[0], &dx[1], &dx[2], &nx, &ny, &nz,
+                                                  &ngRho, &ngRho, &ngRho,
+                                                  &WarpX::nox,&WarpX::noy,&WarpX::noz,
+                                                  &lvect, &WarpX::charge_deposition_algo);
 
                 const int ncomp = 1;
                 amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(local_rho),
@@ -502,9 +509,9 @@ LaserParticleContainer::Evolve (int lev,
             tby.grow(ngJ);
             tbz.grow(ngJ);
 
-            local_jx.resize(tbx);
-            local_jy.resize(tby);
-            local_jz.resize(tbz);
+            scratch.resize(local_jx, tbx);
+            scratch.resize(local_jy, tby);
+            scratch.resize(local_jz, tbz);
 
             local_jx = 0.0;
             local_jy = 0.0;
@@ -518,7 +525,7 @@ LaserParticleContainer::Evolve (int lev,
             jyntot = local_jy.length();
             jzntot = local_jz.length();
 
-            warpx_current_deposition(
+            ParticleKernels::current_deposition(
                 jx_ptr, &ngJ, jxntot,
                 jy_ptr, &ngJ, jyntot,
                 jz_ptr, &ngJ, jzntot,
@@ -542,13 +549,6 @@ LaserParticleContainer::Evolve (int lev,
 
             if (rho) depositCharge(rho,1);
 
-	    //
-	    // copy particle data back
-	    //
-	    BL_PROFILE_VAR_START(blp_copy);
-            pti.SetPosition(xp, yp, zp);
-            BL_PROFILE_VAR_STOP(blp_copy);
-
             if (cost) {
                 const Box& tbx = pti.tilebox();
                 wt = (amrex::second() - wt) / tbx.d_numPts();
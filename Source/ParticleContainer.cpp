@@ -70,6 +70,22 @@ MultiParticleContainer::ReadParameters ()
             }
         }
 	pp.query("use_fdtd_nci_corr", use_fdtd_nci_corr);
+	pp.query("nci_corr_once_per_step", nci_corr_once_per_step);
+	pp.query("fuse_species", fuse_species);
+
+	pp.query("tune_tile_size", tune_tile_size);
+	pp.query("tune_tile_size_steps", tune_tile_size_steps);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(tune_tile_size_steps > 0,
+                                         "particles.tune_tile_size_steps must be positive");
+        std::vector<int> candidates;
+        pp.queryarr("tile_size_candidates", candidates);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(candidates.size() % AMREX_SPACEDIM == 0,
+            "particles.tile_size_candidates must have AMREX_SPACEDIM numbers per candidate");
+        for (unsigned i = 0; i < candidates.size(); i += AMREX_SPACEDIM) {
+            tile_size_candidates.push_back(IntVect(AMREX_D_DECL(candidates[i],
+                                                                candidates[i+1],
+                                                                candidates[i+2])));
+        }
 	pp.query("l_lower_order_in_v", l_lower_order_in_v);
 	initialized = true;
     }
@@ -88,6 +104,7 @@ MultiParticleContainer::InitData ()
 {
     for (auto& pc : allcontainers) {
 	pc->InitData();
+        pc->MarkActiveTilesDirty();
     }
 }
 
@@ -211,19 +228,164 @@ MultiParticleContainer::Evolve (int lev,
                                 MultiFab* rho, MultiFab* crho,
                                 const MultiFab* cEx, const MultiFab* cEy, const MultiFab* cEz,
                                 const MultiFab* cBx, const MultiFab* cBy, const MultiFab* cBz,
-                                Real t, Real dt)
+                                Real t, Real dt, EvolvePhase phase)
 {
-    jx.setVal(0.0);
-    jy.setVal(0.0);
-    jz.setVal(0.0);
-    if (cjx) cjx->setVal(0.0);
-    if (cjy) cjy->setVal(0.0);
-    if (cjz) cjz->setVal(0.0);
-    if (rho) rho->setVal(0.0);
-    if (crho) crho->setVal(0.0);
+    if (phase != EvolvePhase::Boundary)
+    {
+        jx.setVal(0.0);
+        jy.setVal(0.0);
+        jz.setVal(0.0);
+        if (cjx) cjx->setVal(0.0);
+        if (cjy) cjy->setVal(0.0);
+        if (cjz) cjz->setVal(0.0);
+        if (rho) rho->setVal(0.0);
+        if (crho) crho->setVal(0.0);
+    }
+    Vector<PhysicalParticleContainer*> fused_species;
     for (auto& pc : allcontainers) {
-	pc->Evolve(lev, Ex, Ey, Ez, Bx, By, Bz, jx, jy, jz, cjx, cjy, cjz,
-                   rho, crho, cEx, cEy, cEz, cBx, cBy, cBz, t, dt);
+        auto ppc = dynamic_cast<PhysicalParticleContainer*>(pc.get());
+        if (fuse_species && ppc && ppc->SpeciesFusionSupported()) {
+            fused_species.push_back(ppc);
+        } else {
+            pc->Evolve(lev, Ex, Ey, Ez, Bx, By, Bz, jx, jy, jz, cjx, cjy, cjz,
+                       rho, crho, cEx, cEy, cEz, cBx, cBy, cBz, t, dt, phase);
+        }
+    }
+    if (!fused_species.empty()) {
+        EvolveFused(fused_species, lev, Ex, Ey, Ez, Bx, By, Bz, jx, jy, jz, cjx, cjy, cjz,
+                    rho, crho, cEx, cEy, cEz, cBx, cBy, cBz, t, dt, phase);
+    }
+}
+
+void
+MultiParticleContainer::EvolveFused (const Vector<PhysicalParticleContainer*>& all_species, int lev,
+                                     const MultiFab& Ex, const MultiFab& Ey, const MultiFab& Ez,
+                                     const MultiFab& Bx, const MultiFab& By, const MultiFab& Bz,
+                                     MultiFab& jx, MultiFab& jy, MultiFab& jz,
+                                     MultiFab* cjx,  MultiFab* cjy, MultiFab* cjz,
+                                     MultiFab* rho, MultiFab* crho,
+                                     const MultiFab* cEx, const MultiFab* cEy, const MultiFab* cEz,
+                                     const MultiFab* cBx, const MultiFab* cBy, const MultiFab* cBz,
+                                     Real t, Real dt, EvolvePhase phase)
+{
+    BL_PROFILE("MPC::EvolveFused()");
+    BL_PROFILE_VAR_NS("MPC::EvolveFused::Accumulate", blp_accumulate);
+
+    // The species without particles on this level are left out
+    Vector<PhysicalParticleContainer*> species;
+    for (auto pc : all_species) {
+        if (pc->NumActiveTiles(lev) > 0) species.push_back(pc);
+    }
+    if (species.empty()) return;
+
+    for (auto pc : species) {
+        if (phase != EvolvePhase::Boundary) {
+            pc->SortParticlesIfDue(lev);
+        }
+        pc->InitPhase(lev, phase);
+    }
+
+    // See PhysicalParticleContainer::Evolve. Without tile coloring, the current of
+    // all species of a tile is deposited onto one thread-local buffer, which is
+    // added to jx, jy, jz once per tile.
+    const int ngDeposit = (rho) ? std::max(jx.nGrow(), rho->nGrow()) : jx.nGrow();
+    const int ncolors = species[0]->NumTileColors(ngDeposit);
+    const bool deposit_in_place = (ncolors > 1);
+    const int ngJ = jx.nGrow();
+    const int nfused = species.size();
+
+    // Only the colors of the tiles where at least one species is active are processed
+    Vector<int> colors;
+    for (int color = 0; color < ncolors; ++color) {
+        bool active = (ncolors == 1);
+        for (auto pc : species) {
+            active = active || pc->NumActiveTiles(lev, color) > 0;
+        }
+        if (active) colors.push_back(color);
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        ParticleScratch& scratch = ParticleScratch::ThreadLocal();
+        scratch.shared_j = !deposit_in_place;
+
+        for (int color : colors)
+        {
+#ifdef _OPENMP
+            // The tiles of the previous color must be done before this color starts.
+#pragma omp barrier
+#endif
+            // One iterator per species. They all use static scheduling, so that
+            // a thread gets the same tiles for all species, in the same order.
+            MFItInfo info;
+            Vector<std::unique_ptr<WarpXParIter> > ptis;
+            for (auto pc : species) {
+                ptis.emplace_back(new WarpXParIter(*pc, lev, info));
+            }
+
+            while (true)
+            {
+                // The next tile where at least one species has particles
+                std::pair<int,int> tile(std::numeric_limits<int>::max(), 0);
+                const WarpXParIter* first = nullptr;
+                for (const auto& pti : ptis) {
+                    if (pti->isValid()) {
+                        std::pair<int,int> key(pti->index(), pti->LocalTileIndex());
+                        if (key < tile) {
+                            tile = key;
+                            first = pti.get();
+                        }
+                    }
+                }
+                if (first == nullptr) break;
+
+                const bool skip = (ncolors > 1 && first->TileColor() != color);
+                const int grid = first->index();
+                const Box tilebox = first->tilebox();
+
+                if (!skip && scratch.shared_j)
+                {
+                    scratch.resize(scratch.shared_jx, amrex::grow(amrex::convert(tilebox, WarpX::jx_nodal_flag), ngJ));
+                    scratch.resize(scratch.shared_jy, amrex::grow(amrex::convert(tilebox, WarpX::jy_nodal_flag), ngJ));
+                    scratch.resize(scratch.shared_jz, amrex::grow(amrex::convert(tilebox, WarpX::jz_nodal_flag), ngJ));
+                    scratch.shared_jx = 0.0;
+                    scratch.shared_jy = 0.0;
+                    scratch.shared_jz = 0.0;
+                }
+
+                for (int i = 0; i < nfused; ++i)
+                {
+                    WarpXParIter& pti = *ptis[i];
+                    if (pti.isValid() && pti.index() == tile.first && pti.LocalTileIndex() == tile.second)
+                    {
+                        if (!skip) {
+                            const auto range = species[i]->PhaseRange(pti, lev, phase);
+                            species[i]->EvolveTile(pti, range.first, range.second,
+                                                   lev, Ex, Ey, Ez, Bx, By, Bz, jx, jy, jz,
+                                                   cjx, cjy, cjz, rho, crho,
+                                                   cEx, cEy, cEz, cBx, cBy, cBz, t, dt,
+                                                   deposit_in_place, scratch);
+                        }
+                        ++pti;
+                    }
+                }
+
+                if (!skip && scratch.shared_j)
+                {
+                    BL_PROFILE_VAR_START(blp_accumulate);
+                    const int ncomp = 1;
+                    amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(scratch.shared_jx),
+                                                BL_TO_FORTRAN_3D(jx[grid]), ncomp);
+                    amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(scratch.shared_jy),
+                                                BL_TO_FORTRAN_3D(jy[grid]), ncomp);
+                    amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(scratch.shared_jz),
+                                                BL_TO_FORTRAN_3D(jz[grid]), ncomp);
+                    BL_PROFILE_VAR_STOP(blp_accumulate);
+                }
+            }
+        }
     }
 }
 
@@ -276,6 +438,15 @@ MultiParticleContainer::RedistributeLocal (const int num_ghost)
     }
 }
 
+void
+MultiParticleContainer::ResampleParticles (int step)
+{
+    for (auto& pc : allcontainers) {
+        auto ppc = dynamic_cast<PhysicalParticleContainer*>(pc.get());
+        if (ppc) ppc->ResampleParticles(step);
+    }
+}
+
 Vector<long>
 MultiParticleContainer::NumberOfParticlesInGrid(int lev) const
 {
@@ -291,6 +462,98 @@ MultiParticleContainer::NumberOfParticlesInGrid(int lev) const
     return r;
 }
 
+std::pair<long,long>
+MultiParticleContainer::NumActiveTiles ()
+{
+    long n[2] = {0, 0};
+    for (auto& pc : allcontainers) {
+        for (int lev = 0; lev <= pc->finestLevel(); ++lev) {
+            n[0] += pc->NumActiveTiles(lev);
+            n[1] += pc->NumTiles(lev);
+        }
+    }
+    ParallelDescriptor::ReduceLongSum(n, 2);
+    return std::make_pair(n[0], n[1]);
+}
+
+void
+MultiParticleContainer::TuneTileSize (Real step_time)
+{
+    if (!tune_tile_size) return;
+    if (tune_candidate > 0 && tune_candidate >= tile_size_candidates.size()) return;
+
+    BL_PROFILE("MPC::TuneTileSize()");
+
+    if (tune_candidate == 0 && tune_step == 0)
+    {
+        // The current tile size is the first candidate. By default, the others
+        // halve, double and quadruple the tiled directions.
+        const IntVect ts0 = WarpXParticleContainer::TileSize();
+        Vector<IntVect> candidates {ts0};
+        if (tile_size_candidates.empty()) {
+            const std::array<std::pair<int,int>, 3> factors {{ {1,2}, {2,1}, {4,1} }};
+            for (const auto& f : factors) {
+                IntVect ts = ts0;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    // Very large tile sizes mean that the direction is not tiled
+                    if (ts0[idim] >= 1024) continue;
+                    ts[idim] = std::max(4, ts0[idim]*f.first/f.second);
+                }
+                candidates.push_back(ts);
+            }
+        } else {
+            candidates.insert(candidates.end(), tile_size_candidates.begin(), tile_size_candidates.end());
+        }
+        tile_size_candidates.clear();
+        for (const auto& ts : candidates) {
+            if (std::find(tile_size_candidates.begin(), tile_size_candidates.end(), ts)
+                == tile_size_candidates.end()) {
+                tile_size_candidates.push_back(ts);
+            }
+        }
+        tile_size_cost.assign(tile_size_candidates.size(), std::numeric_limits<Real>::max());
+    }
+
+    long np = 0;
+    for (auto& pc : allcontainers) {
+        np += pc->TotalNumberOfParticles(true, true);
+    }
+    ParallelDescriptor::ReduceLongSum(np);
+    ParallelDescriptor::ReduceRealMax(step_time);
+
+    // The minimum over the steps of a candidate filters out the noise
+    // and the first step after a tile size change.
+    const Real cost = step_time / std::max(np, 1L);
+    tile_size_cost[tune_candidate] = std::min(tile_size_cost[tune_candidate], cost);
+    if (++tune_step < tune_tile_size_steps) return;
+
+    tune_step = 0;
+    ++tune_candidate;
+    const int ncandidates = tile_size_candidates.size();
+    IntVect ts;
+    if (tune_candidate < ncandidates) {
+        ts = tile_size_candidates[tune_candidate];
+    } else {
+        const int best = std::distance(tile_size_cost.begin(),
+                                       std::min_element(tile_size_cost.begin(), tile_size_cost.end()));
+        ts = tile_size_candidates[best];
+        amrex::Print() << "Particle tile size tuning (wall time per particle and per step):\n";
+        for (int i = 0; i < ncandidates; ++i) {
+            amrex::Print() << "  " << tile_size_candidates[i] << ": " << tile_size_cost[i] << " s\n";
+        }
+        amrex::Print() << "Selected particles.tile_size =";
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            amrex::Print() << " " << ts[idim];
+        }
+        amrex::Print() << "\n";
+    }
+
+    if (ts != WarpXParticleContainer::TileSize()) {
+        WarpXParticleContainer::SetTileSize(ts);
+        Redistribute();  // moves the particles to the tiles of the new size
+    }
+}
+
 void
 MultiParticleContainer::Increment (MultiFab& mf, int lev)
 {
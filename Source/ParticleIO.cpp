@@ -28,11 +28,22 @@ MultiParticleContainer::Checkpoint (const std::string& dir,
     }
 }
 
+void
+MultiParticleContainer::WritePlotFile (const std::string& dir,
+                                       const Vector<std::string>& varnames)
+{
+    for (unsigned i = 0, n = species_names.size(); i < n; ++i) {
+        allcontainers[i]->WritePlotFile(dir, species_names[i], varnames);
+    }
+}
+
 void
 MultiParticleContainer::Restart (const std::string& dir)
 {
     for (unsigned i = 0, n = species_names.size(); i < n; ++i) {
 	allcontainers[i]->Restart(dir, species_names[i]);
+        allcontainers[i]->MarkActiveTilesDirty();
+        allcontainers[i]->SyncPositionsFromAoS();
     }
 }
 
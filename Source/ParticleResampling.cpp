@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cmath>
+
+#include <ParticleResampling.H>
+#include <WarpXConst.H>
+
+using namespace amrex;
+
+long
+ParticleResampling::MergeCell (long* first, long* last, int cap, const ParticleArrays& p,
+                               char* keep, Vector<long>& merged)
+{
+    const Real c = PhysConst::c;
+    const Real inv_c2 = 1.0/(c*c);
+    auto gamma = [&] (long ip) {
+        return std::sqrt(1.0 + (p.ux[ip]*p.ux[ip] + p.uy[ip]*p.uy[ip] + p.uz[ip]*p.uz[ip])*inv_c2);
+    };
+
+    // This is exact up to round-off, so resample_tolerance does not apply.
+    std::sort(first, last, [&] (long a, long b) { return gamma(a) < gamma(b); });
+    const long n = last - first;
+    const long ngroups = cap/2;
+    long nremoved = 0;
+    for (long ig = 0; ig < ngroups; ++ig)
+    {
+        long* gfirst = first + (n*ig)/ngroups;
+        long* glast  = first + (n*(ig+1))/ngroups;
+        if (glast - gfirst <= 2) continue;
+
+        Real W = 0.0, G = 0.0;
+        Real U[3] = {0.0, 0.0, 0.0};
+        Real X[3] = {0.0, 0.0, 0.0};
+        for (const long* q = gfirst; q != glast; ++q) {
+            const long ip = *q;
+            W += p.w[ip];
+            G += p.w[ip]*gamma(ip);
+            U[0] += p.w[ip]*p.ux[ip];
+            U[1] += p.w[ip]*p.uy[ip];
+            U[2] += p.w[ip]*p.uz[ip];
+            X[0] += p.w[ip]*p.x[ip];
+            X[1] += p.w[ip]*p.y[ip];
+            X[2] += p.w[ip]*p.z[ip];
+        }
+        if (W <= 0.0) continue;
+
+        // The two particles are put at the position of the particle of the group that
+        // is the closest to its mean position, so that the charge stays near where it
+        // was. The charge of the other particles is still moved without depositing
+        // the corresponding current, so the merge perturbs div(E) - rho/epsilon_0.
+        long ipos = *gfirst;
+        Real dmin = -1.0;
+        for (const long* q = gfirst; q != glast; ++q) {
+            const long ip = *q;
+            const Real dx = p.x[ip] - X[0]/W;
+            const Real dy = p.y[ip] - X[1]/W;
+            const Real dz = p.z[ip] - X[2]/W;
+            const Real d = dx*dx + dy*dy + dz*dz;
+            if (dmin < 0.0 || d < dmin) {
+                dmin = d;
+                ipos = ip;
+            }
+        }
+        const Real xpos = p.x[ipos], ypos = p.y[ipos], zpos = p.z[ipos];
+
+        // Both particles have the mean energy of the group; their momenta make
+        // an angle theta with the total momentum, on either side of it.
+        const Real ga = G/W;
+        const Real ua = c*std::sqrt(std::max(ga*ga - 1.0, 0.0));
+        const Real Umag = std::sqrt(U[0]*U[0] + U[1]*U[1] + U[2]*U[2]);
+        const Real cos_theta = (ua > 0.0) ? std::min(Umag/(W*ua), Real(1.0)) : 1.0;
+        const Real sin_theta = std::sqrt(1.0 - cos_theta*cos_theta);
+        Real e1[3] = {1.0, 0.0, 0.0};
+        if (Umag > 0.0) {
+            for (int d = 0; d < 3; ++d) e1[d] = U[d]/Umag;
+        }
+        // e2 is orthogonal to e1: the cross product of e1 with the axis
+        // that is the least aligned with it
+        int axis = 0;
+        for (int d = 1; d < 3; ++d) {
+            if (std::abs(e1[d]) < std::abs(e1[axis])) axis = d;
+        }
+        Real e2[3] = {0.0, 0.0, 0.0};
+        e2[(axis+1)%3] =  e1[(axis+2)%3];
+        e2[(axis+2)%3] = -e1[(axis+1)%3];
+        const Real e2mag = std::sqrt(e2[0]*e2[0] + e2[1]*e2[1] + e2[2]*e2[2]);
+        for (int d = 0; d < 3; ++d) e2[d] /= e2mag;
+
+        for (int k = 0; k < 2; ++k)
+        {
+            const long ip = gfirst[k];
+            const Real sign = (k == 0) ? 1.0 : -1.0;
+            p.w[ip] = 0.5*W;
+            p.ux[ip] = ua*(cos_theta*e1[0] + sign*sin_theta*e2[0]);
+            p.uy[ip] = ua*(cos_theta*e1[1] + sign*sin_theta*e2[1]);
+            p.uz[ip] = ua*(cos_theta*e1[2] + sign*sin_theta*e2[2]);
+            p.x[ip] = xpos;
+            p.y[ip] = ypos;
+            p.z[ip] = zpos;
+            merged.push_back(ip);
+        }
+        for (const long* q = gfirst+2; q != glast; ++q) keep[*q] = 0;
+        nremoved += (glast - gfirst) - 2;
+    }
+    return nremoved;
+}
@@ -0,0 +1,122 @@
+#include <memory>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_BLProfiler.H>
+#include <AMReX_ParallelDescriptor.H>
+
+#include <ParticleScratch.H>
+
+using namespace amrex;
+
+namespace
+{
+    Vector<std::unique_ptr<ParticleScratch> >& Arena ()
+    {
+#ifdef _OPENMP
+        static Vector<std::unique_ptr<ParticleScratch> > arena(omp_get_max_threads());
+#else
+        static Vector<std::unique_ptr<ParticleScratch> > arena(1);
+#endif
+        return arena;
+    }
+
+    bool finalize_registered = false;
+
+    void CountAllocation (long& num_allocs)
+    {
+        BL_PROFILE("ParticleScratch::Allocate");
+        ++num_allocs;
+    }
+}
+
+ParticleScratch&
+ParticleScratch::ThreadLocal ()
+{
+#ifdef _OPENMP
+    const int tid = omp_get_thread_num();
+#else
+    const int tid = 0;
+#endif
+    auto& arena = Arena();
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(tid < static_cast<int>(arena.size()),
+                                     "ParticleScratch: more OpenMP threads than at the first use");
+    // Each thread creates its own scratch, so there is no race on arena[tid].
+    if (arena[tid] == nullptr) {
+        arena[tid].reset(new ParticleScratch());
+#ifdef _OPENMP
+#pragma omp critical (particle_scratch_finalize)
+#endif
+        if (!finalize_registered) {
+            amrex::ExecOnFinalize(ParticleScratch::Finalize);
+            finalize_registered = true;
+        }
+    }
+    return *arena[tid];
+}
+
+void
+ParticleScratch::Finalize ()
+{
+    // The arena keeps its size, for the runs started after a new amrex::Initialize (Python)
+    for (auto& scratch : Arena()) {
+        scratch.reset();
+    }
+    finalize_registered = false;
+}
+
+void
+ParticleScratch::resize (FArrayBox& fab, const Box& bx, int ncomp)
+{
+    const Real* p = fab.dataPtr();
+    // FArrayBox::resize only reallocates if the new box does not fit in the current memory.
+    fab.resize(bx, ncomp);
+    if (fab.dataPtr() != p) {
+        CountAllocation(num_allocs);
+    }
+}
+
+void
+ParticleScratch::resize (Vector<Real>& v, long n)
+{
+    if (n > static_cast<long>(v.capacity())) {
+        CountAllocation(num_allocs);
+    }
+    v.resize(n);
+}
+
+long
+ParticleScratch::numBytes () const
+{
+    long nbytes = 0;
+    for (const auto* v : {&giv, &plane_Xp, &plane_Yp, &amplitude_E}) {
+        nbytes += v->capacity()*sizeof(Real);
+    }
+    for (const auto* fab : {&local_rho, &local_jx, &local_jy, &local_jz,
+                            &filtered_Ex, &filtered_Ey, &filtered_Ez,
+                            &filtered_Bx, &filtered_By, &filtered_Bz,
+                            &shared_jx, &shared_jy, &shared_jz}) {
+        nbytes += fab->nBytes();
+    }
+    return nbytes;
+}
+
+void
+ParticleScratch::PrintStatistics ()
+{
+    long num_allocs = 0, nbytes = 0;
+    for (const auto& scratch : Arena()) {
+        if (scratch) {
+            num_allocs += scratch->num_allocs;
+            nbytes += scratch->numBytes();
+        }
+    }
+    ParallelDescriptor::ReduceLongSum(num_allocs);
+    ParallelDescriptor::ReduceLongSum(nbytes);
+    amrex::Print() << "Particle scratch: " << num_allocs << " allocations, "
+                   << nbytes/(1024.*1024.) << " MB in use\n";
+}
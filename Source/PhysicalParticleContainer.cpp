@@ -1,8 +1,12 @@
+#include <algorithm>
 #include <limits>
+#include <random>
 #include <sstream>
 
 #include <ParticleContainer.H>
 #include <WarpX_f.H>
+#include <WarpXParticleKernels.H>
+#include <ParticleResampling.H>
 #include <WarpX.H>
 #include <WarpXConst.H>
 #include <WarpXWrappers.h>
@@ -10,6 +14,55 @@
 
 using namespace amrex;
 
+namespace
+{
+    //
+    // Partitions the particles [first, last) of the tile in place, such that
+    // the particles for which is_fine(ip) is true come first, and returns the
+    // partition point. Only the misplaced particles are moved, together with all
+    // their attributes, so that a tile that was already partitioned at the
+    // previous step only costs the evaluation of is_fine.
+    //
+    template <typename F>
+    long PartitionParticles (WarpXParIter& pti, long first, long last, F&& is_fine)
+    {
+        auto& aos = pti.GetArrayOfStructs();
+        auto& attribs = pti.GetAttribs();
+        long i = first;
+        long j = last-1;
+        while (true)
+        {
+            while (i <= j &&  is_fine(i)) ++i;
+            while (i <= j && !is_fine(j)) --j;
+            if (i > j) break;
+            std::swap(aos[i], aos[j]);
+            for (int comp = 0; comp < PIdx::nattribs; ++comp) {
+                std::swap(attribs[comp][i], attribs[comp][j]);
+            }
+            ++i;
+            --j;
+        }
+        return i;
+    }
+
+    // Cell index of particle ip of a tile, computed from its position attributes
+    IntVect CellIndex (const Geometry& geom, const Vector<Real>& xp, const Vector<Real>& yp,
+                       const Vector<Real>& zp, long ip)
+    {
+        const Real* plo = geom.ProbLo();
+        const Real* dxi = geom.InvCellSize();
+#if (AMREX_SPACEDIM == 3)
+        IntVect iv(static_cast<int>(std::floor((xp[ip]-plo[0])*dxi[0])),
+                   static_cast<int>(std::floor((yp[ip]-plo[1])*dxi[1])),
+                   static_cast<int>(std::floor((zp[ip]-plo[2])*dxi[2])));
+#else
+        IntVect iv(static_cast<int>(std::floor((xp[ip]-plo[0])*dxi[0])),
+                   static_cast<int>(std::floor((zp[ip]-plo[1])*dxi[1])));
+#endif
+        return iv + geom.Domain().smallEnd();
+    }
+}
+
 PhysicalParticleContainer::PhysicalParticleContainer (AmrCore* amr_core, int ispecies,
                                                       const std::string& name)
     : WarpXParticleContainer(amr_core, ispecies),
@@ -23,6 +76,25 @@ PhysicalParticleContainer::PhysicalParticleContainer (AmrCore* amr_core, int isp
 
     pp.query("boost_adjust_transverse_positions", boost_adjust_transverse_positions);
     pp.query("do_backward_propagation", do_backward_propagation);
+    pp.query("sort_interval", sort_interval);
+
+    pp.query("resample_interval", resample_interval);
+    if (resample_interval > 0)
+    {
+        if (plasma_injector->doInjection()) {
+            max_particles_per_cell = 2*plasma_injector->num_particles_per_cell;
+        }
+        pp.query("max_particles_per_cell", max_particles_per_cell);
+        std::string resample_algo = "merge";
+        pp.query("resample_algo", resample_algo);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(resample_algo == "merge" || resample_algo == "thin",
+            "<species>.resample_algo must be merge or thin");
+        resample_by_thinning = (resample_algo == "thin");
+        // The merge replaces each group of particles by a pair
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(max_particles_per_cell >= (resample_by_thinning ? 1 : 2),
+            "<species>.max_particles_per_cell must be at least 2 with resample_algo = merge, and 1 with thin");
+        pp.query("resample_tolerance", resample_tolerance);
+    }
 }
 
 void PhysicalParticleContainer::InitData()
@@ -375,6 +447,8 @@ PhysicalParticleContainer::AddPlasma(int lev, RealBox part_realbox)
             }
         }
     }
+
+    MarkActiveTilesDirty();
 }
 
 #ifdef WARPX_DO_ELECTROSTATIC
@@ -584,6 +658,8 @@ PhysicalParticleContainer::EvolveES (const Vector<std::array<std::unique_ptr<Mul
 #endif
                                &this->charge, &this->mass, &dt,
                                prob_domain.lo(), prob_domain.hi());
+
+            pti.SyncPositionsFromAoS();
         }
     }
 }
@@ -594,6 +670,17 @@ PhysicalParticleContainer::FieldGather (int lev,
                                         const MultiFab& Ex, const MultiFab& Ey, const MultiFab& Ez,
                                         const MultiFab& Bx, const MultiFab& By, const MultiFab& Bz)
 {
+#ifdef WARPX_TRANSIENT_PARTICLE_FIELDS
+    // The particles have no storage for the gathered fields, which are kept aside
+    // for the diagnostics (see GatheredFields). The map entries are created in serial.
+    if (gathered_fields.size() <= lev) gathered_fields.resize(lev+1);
+    for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti) {
+        gathered_fields[lev][std::make_pair(pti.index(), pti.LocalTileIndex())];
+    }
+#endif
+
+    if (NumActiveTiles(lev) == 0) return;
+
     const std::array<Real,3>& dx = WarpX::CellSize(lev);
 
     // WarpX assumes the same number of guard cells for Ex, Ey, Ez, Bx, By, Bz
@@ -607,8 +694,6 @@ PhysicalParticleContainer::FieldGather (int lev,
 #pragma omp parallel
 #endif
     {
-	Vector<Real> xp, yp, zp;
-
 	for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
 	{
             Real wt = amrex::second();
@@ -617,12 +702,22 @@ PhysicalParticleContainer::FieldGather (int lev,
 
             auto& attribs = pti.GetAttribs();
 
-            auto& Exp = attribs[PIdx::Ex];
-            auto& Eyp = attribs[PIdx::Ey];
-            auto& Ezp = attribs[PIdx::Ez];
-            auto& Bxp = attribs[PIdx::Bx];
-            auto& Byp = attribs[PIdx::By];
-            auto& Bzp = attribs[PIdx::Bz];
+            const auto& xp = attribs[PIdx::x];
+            const auto& yp = attribs[PIdx::y];
+            const auto& zp = attribs[PIdx::z];
+#ifdef WARPX_TRANSIENT_PARTICLE_FIELDS
+            auto& gathered = *GatheredFields(lev, pti.index(), pti.LocalTileIndex());
+            const ParticleFieldArrays particle_fields {&gathered[0], &gathered[1], &gathered[2],
+                                                       &gathered[3], &gathered[4], &gathered[5]};
+#else
+            auto particle_fields = GetParticleFields(pti);
+#endif
+            auto& Exp = *particle_fields[0];
+            auto& Eyp = *particle_fields[1];
+            auto& Ezp = *particle_fields[2];
+            auto& Bxp = *particle_fields[3];
+            auto& Byp = *particle_fields[4];
+            auto& Bzp = *particle_fields[5];
 
             const long np = pti.numParticles();
 
@@ -641,11 +736,6 @@ PhysicalParticleContainer::FieldGather (int lev,
 	    Byp.assign(np,0.0);
 	    Bzp.assign(np,0.0);
 
-	    //
-	    // copy data from particle container to temp arrays
-	    //
-            pti.GetPosition(xp, yp, zp);
-
             const std::array<Real,3>& xyzmin = WarpX::LowerCorner(box, lev);
             const int* ixyzmin = box.loVect();
 
@@ -655,7 +745,7 @@ PhysicalParticleContainer::FieldGather (int lev,
 	    const int ll4symtry          = false;
 	    const int l_lower_order_in_v = warpx_l_lower_order_in_v();
             long lvect_fieldgathe = 64;
-	    warpx_geteb_energy_conserving(
+	    ParticleKernels::geteb_energy_conserving(
 	       &np, xp.data(), yp.data(), zp.data(),
 	       Exp.data(),Eyp.data(),Ezp.data(),
 	       Bxp.data(),Byp.data(),Bzp.data(),
@@ -690,27 +780,368 @@ PhysicalParticleContainer::Evolve (int lev,
                                    MultiFab* rho, MultiFab* crho,
                                    const MultiFab* cEx, const MultiFab* cEy, const MultiFab* cEz,
                                    const MultiFab* cBx, const MultiFab* cBy, const MultiFab* cBz,
-                                   Real t, Real dt)
+                                   Real t, Real dt, EvolvePhase phase)
 {
     BL_PROFILE("PPC::Evolve()");
-    BL_PROFILE_VAR_NS("PPC::Evolve::Copy", blp_copy);
+
+    BL_ASSERT(OnSameGrids(lev,Ex));
+
+    if (NumActiveTiles(lev) == 0) return;
+
+    // The particles must stay in place between the Interior and the Boundary phase
+    if (phase != EvolvePhase::Boundary) {
+        SortParticlesIfDue(lev);
+#ifdef WARPX_TRANSIENT_PARTICLE_FIELDS
+        ClearGatheredFields();
+#endif
+    }
+    InitPhase(lev, phase);
+
+    // With tile coloring, the tiles of one color are processed concurrently and
+    // do not overlap, so the fine patch current and charge are deposited directly
+    // onto jx, jy, jz and rho. The coarse patch deposition of buffer particles
+    // always goes through the thread-local buffers.
+    const int ngDeposit = (rho) ? std::max(jx.nGrow(), rho->nGrow()) : jx.nGrow();
+    const int ncolors = NumTileColors(ngDeposit);
+    const bool deposit_in_place = (ncolors > 1);
+
+    // Only the colors of the active tiles are processed
+    Vector<int> colors;
+    for (int color = 0; color < ncolors; ++color) {
+        if (ncolors == 1 || NumActiveTiles(lev, color) > 0) colors.push_back(color);
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        ParticleScratch& scratch = ParticleScratch::ThreadLocal();
+        scratch.shared_j = false;
+
+        for (int color : colors)
+        {
+#ifdef _OPENMP
+            // The tiles of the previous color must be done before this color starts.
+#pragma omp barrier
+#endif
+            for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+            {
+                if (ncolors > 1 && pti.TileColor() != color) continue;
+
+                const auto range = PhaseRange(pti, lev, phase);
+                EvolveTile(pti, range.first, range.second,
+                           lev, Ex, Ey, Ez, Bx, By, Bz, jx, jy, jz, cjx, cjy, cjz,
+                           rho, crho, cEx, cEy, cEz, cBx, cBy, cBz, t, dt,
+                           deposit_in_place, scratch);
+            }
+        }
+    }
+}
+
+void
+PhysicalParticleContainer::SortParticlesIfDue (int lev)
+{
+    if (sort_interval > 0 && WarpX::GetInstance().getistep(lev) % sort_interval == 0) {
+        SortParticlesByCell(lev);
+    }
+}
+
+void
+PhysicalParticleContainer::InitPhase (int lev, EvolvePhase phase)
+{
+    if (phase == EvolvePhase::Interior)
+    {
+        num_interior.clear();
+        for (const auto& key : ActiveTiles(lev)) {
+            num_interior[key] = 0;
+        }
+    }
+}
+
+void
+PhysicalParticleContainer::ResampleParticles (int step)
+{
+    if (resample_interval <= 0 || step % resample_interval != 0) return;
+
+    BL_PROFILE("PPC::ResampleParticles()");
+
+    const Real t0 = amrex::second();
+    long counts[4] = {0, 0, 0, 0};  // particles before, removed, cells, rejected cells
+
+    for (int lev = 0; lev <= finestLevel(); ++lev)
+    {
+        if (NumActiveTiles(lev) == 0) continue;
+
+        MultiFab* cost = WarpX::getCosts(lev);
+
+        long np = 0, nremoved = 0, ncells = 0, nrejected = 0;
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:np, nremoved, ncells, nrejected)
+#endif
+        {
+            Vector<long> cell, cell_offset, pid;
+
+            for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+            {
+                Real wt = amrex::second();
+
+                np += pti.numParticles();
+                nremoved += ResampleTile(pti, lev, step, ncells, nrejected,
+                                         cell, cell_offset, pid);
+
+                if (cost) {
+                    const Box& tbx = pti.tilebox();
+                    wt = (amrex::second() - wt) / tbx.d_numPts();
+                    (*cost)[pti].plus(wt, tbx);
+                }
+            }
+        }
+        counts[0] += np;
+        counts[1] += nremoved;
+        counts[2] += ncells;
+        counts[3] += nrejected;
+    }
+
+    Real dt_resample = amrex::second() - t0;
+    ParallelDescriptor::ReduceLongSum(counts, 4);
+    ParallelDescriptor::ReduceRealMax(dt_resample);
+    resample_removed += counts[1];
+    resample_time += dt_resample;
+
+    amrex::Print() << "Resampled " << species_name << ": removed " << counts[1]
+                   << " of " << counts[0] << " particles in " << counts[2] << " cells";
+    if (counts[3] > 0) {
+        amrex::Print() << " (" << counts[3] << " cells left unchanged by the tolerance)";
+    }
+    amrex::Print() << " in " << dt_resample << " s; total removed " << resample_removed
+                   << " in " << resample_time << " s\n";
+}
+
+long
+PhysicalParticleContainer::ResampleTile (WarpXParIter& pti, int lev, int step,
+                                         long& ncells, long& nrejected,
+                                         Vector<long>& cell, Vector<long>& cell_offset,
+                                         Vector<long>& pid)
+{
+    const long np = pti.numParticles();
+    if (np <= max_particles_per_cell) return 0;
+
+    const Geometry& geom = Geom(lev);
+    const Box& tbx = pti.tilebox();
+    auto& attribs = pti.GetAttribs();
+    auto& wp = attribs[PIdx::w];
+    auto& xp = attribs[PIdx::x];
+    auto& yp = attribs[PIdx::y];
+    auto& zp = attribs[PIdx::z];
+    auto& uxp = attribs[PIdx::ux];
+    auto& uyp = attribs[PIdx::uy];
+    auto& uzp = attribs[PIdx::uz];
+
+    // Group the particles by cell (counting sort of their indices)
+    const long ncells_tile = tbx.numPts();
+    cell.resize(np);
+    cell_offset.assign(ncells_tile+1, 0);
+    for (long ip = 0; ip < np; ++ip) {
+        const IntVect iv = amrex::min(amrex::max(CellIndex(geom, xp, yp, zp, ip), tbx.smallEnd()),
+                                      tbx.bigEnd());
+        cell[ip] = tbx.index(iv);
+        ++cell_offset[cell[ip]+1];
+    }
+    for (long ic = 0; ic < ncells_tile; ++ic) {
+        cell_offset[ic+1] += cell_offset[ic];
+    }
+    pid.resize(np);
+    {
+        Vector<long> next(cell_offset.begin(), cell_offset.end()-1);
+        for (long ip = 0; ip < np; ++ip) {
+            pid[next[cell[ip]]++] = ip;
+        }
+    }
+
+    const Real c = PhysConst::c;
+    const Real inv_c2 = 1.0/(c*c);
+    auto gamma = [&] (long ip) {
+        return std::sqrt(1.0 + (uxp[ip]*uxp[ip] + uyp[ip]*uyp[ip] + uzp[ip]*uzp[ip])*inv_c2);
+    };
+
+    // Momentum, kinetic energy and sum of the momentum magnitudes of particles [first, last) of pid
+    auto moments = [&] (const long* first, const long* last, std::array<Real,5>& m) {
+        m.fill(0.0);
+        for (const long* p = first; p != last; ++p) {
+            const long ip = *p;
+            m[0] += wp[ip]*uxp[ip];
+            m[1] += wp[ip]*uyp[ip];
+            m[2] += wp[ip]*uzp[ip];
+            m[3] += wp[ip]*(gamma(ip) - 1.0);
+            m[4] += wp[ip]*std::sqrt(uxp[ip]*uxp[ip] + uyp[ip]*uyp[ip] + uzp[ip]*uzp[ip]);
+        }
+    };
+    auto within_tolerance = [&] (const std::array<Real,5>& m0, const std::array<Real,5>& m1) {
+        const Real dp = std::sqrt((m1[0]-m0[0])*(m1[0]-m0[0]) + (m1[1]-m0[1])*(m1[1]-m0[1])
+                                  + (m1[2]-m0[2])*(m1[2]-m0[2]));
+        return dp <= resample_tolerance*m0[4] && std::abs(m1[3]-m0[3]) <= resample_tolerance*m0[3];
+    };
+
+    std::mt19937 rng(static_cast<unsigned>(step) * 2654435761u
+                     ^ static_cast<unsigned>(pti.index()) * 40503u
+                     ^ static_cast<unsigned>(pti.LocalTileIndex()));
+
+    const int cap = max_particles_per_cell;
+    Vector<char> keep(np, 1);
+    const ParticleResampling::ParticleArrays particles {wp.data(), xp.data(), yp.data(), zp.data(),
+                                                        uxp.data(), uyp.data(), uzp.data()};
+    Vector<long> merged;
+    Vector<Real> wsave;
+    long nremoved = 0;
+    std::array<Real,5> m0, m1;
+
+    for (long ic = 0; ic < ncells_tile; ++ic)
+    {
+        long* first = pid.data() + cell_offset[ic];
+        long* last  = pid.data() + cell_offset[ic+1];
+        const long n = last - first;
+        if (n <= cap) continue;
+
+        ++ncells;
+
+        if (resample_by_thinning)
+        {
+            moments(first, last, m0);
+
+            // Keep cap particles at random, with the total weight of the cell
+            std::shuffle(first, last, rng);
+            Real wtot = 0.0, wkept = 0.0;
+            for (const long* p = first; p != last; ++p) wtot += wp[*p];
+            for (const long* p = first; p != first+cap; ++p) wkept += wp[*p];
+            if (wkept <= 0.0) { ++nrejected; continue; }
+            wsave.resize(cap);
+            for (int i = 0; i < cap; ++i) {
+                wsave[i] = wp[first[i]];
+                wp[first[i]] *= wtot/wkept;
+            }
+            moments(first, first+cap, m1);
+            if (!within_tolerance(m0, m1)) {
+                for (int i = 0; i < cap; ++i) wp[first[i]] = wsave[i];
+                ++nrejected;
+                continue;
+            }
+            for (const long* p = first+cap; p != last; ++p) keep[*p] = 0;
+            nremoved += n - cap;
+        }
+        else
+        {
+            merged.clear();
+            nremoved += ParticleResampling::MergeCell(first, last, cap, particles,
+                                                      keep.data(), merged);
+#ifdef WARPX_STORE_OLD_PARTICLE_ATTRIBS
+            for (const long ip : merged) {
+                attribs[PIdx::xold][ip] = xp[ip];
+                attribs[PIdx::yold][ip] = yp[ip];
+                attribs[PIdx::zold][ip] = zp[ip];
+                attribs[PIdx::uxold][ip] = uxp[ip];
+                attribs[PIdx::uyold][ip] = uyp[ip];
+                attribs[PIdx::uzold][ip] = uzp[ip];
+            }
+#endif
+        }
+    }
+
+    if (nremoved == 0) return 0;
+
+    // Remove the particles that are not kept, keeping the order of the others
+    auto& aos = pti.GetArrayOfStructs();
+    long j = 0;
+    for (long ip = 0; ip < np; ++ip) {
+        if (keep[ip]) aos[j++] = aos[ip];
+    }
+    aos().resize(j);
+    for (int comp = 0; comp < PIdx::nattribs; ++comp)
+    {
+        auto& attrib = attribs[comp];
+        j = 0;
+        for (long ip = 0; ip < np; ++ip) {
+            if (keep[ip]) attrib[j++] = attrib[ip];
+        }
+        attrib.resize(j);
+    }
+    // The merged particles have moved; the output reads the particle structs
+    pti.SyncPositionsToAoS();
+
+    return nremoved;
+}
+
+std::pair<long,long>
+PhysicalParticleContainer::PhaseRange (WarpXParIter& pti, int lev, EvolvePhase phase)
+{
+    const long np = pti.numParticles();
+    if (phase == EvolvePhase::All) {
+        return std::make_pair(0L, np);
+    }
+
+    long& ninterior = num_interior.at(std::make_pair(pti.index(), pti.LocalTileIndex()));
+
+    if (phase == EvolvePhase::Interior)
+    {
+        BL_PROFILE("PPC::Evolve::partition_interior");
+        // The field gather of a particle in cell i reads the fields at most
+        // nox+1 cells away (staggered components, lower order in v included).
+#if (AMREX_SPACEDIM == 3)
+        const IntVect margin(static_cast<int>(WarpX::nox)+1,
+                             static_cast<int>(WarpX::noy)+1,
+                             static_cast<int>(WarpX::noz)+1);
+#else
+        const IntVect margin(static_cast<int>(WarpX::nox)+1,
+                             static_cast<int>(WarpX::noz)+1);
+#endif
+        const Box& interior = amrex::grow(pti.validbox(), -margin);
+        const Geometry& geom = Geom(lev);
+        auto& attribs = pti.GetAttribs();
+        const auto& xp = attribs[PIdx::x];
+        const auto& yp = attribs[PIdx::y];
+        const auto& zp = attribs[PIdx::z];
+        if (interior.ok()) {
+            ninterior = PartitionParticles(pti, 0, np,
+                [&] (long ip) { return interior.contains(CellIndex(geom, xp, yp, zp, ip)); });
+        } else {
+            ninterior = 0;
+        }
+        return std::make_pair(0L, ninterior);
+    }
+
+    return std::make_pair(ninterior, np);
+}
+
+void
+PhysicalParticleContainer::EvolveTile (WarpXParIter& pti, long pbegin, long pend, int lev,
+                                       const MultiFab& Ex, const MultiFab& Ey, const MultiFab& Ez,
+                                       const MultiFab& Bx, const MultiFab& By, const MultiFab& Bz,
+                                       MultiFab& jx, MultiFab& jy, MultiFab& jz,
+                                       MultiFab* cjx, MultiFab* cjy, MultiFab* cjz,
+                                       MultiFab* rho, MultiFab* crho,
+                                       const MultiFab* cEx, const MultiFab* cEy, const MultiFab* cEz,
+                                       const MultiFab* cBx, const MultiFab* cBy, const MultiFab* cBz,
+                                       Real t, Real dt, bool deposit_in_place,
+                                       ParticleScratch& scratch)
+{
     BL_PROFILE_VAR_NS("PICSAR::FieldGather", blp_pxr_fg);
     BL_PROFILE_VAR_NS("PICSAR::ParticlePush", blp_pxr_pp);
     BL_PROFILE_VAR_NS("PICSAR::CurrentDeposition", blp_pxr_cd);
     BL_PROFILE_VAR_NS("PPC::Evolve::Accumulate", blp_accumulate);
     BL_PROFILE_VAR_NS("PPC::Evolve::partition", blp_partition);
+    BL_PROFILE_VAR_NS("PPC::Evolve::FusedGatherPushDeposit", blp_fused);
+    BL_PROFILE_VAR_NS("PPC::Evolve::NCIFilter", blp_nci);
 
     const std::array<Real,3>& dx = WarpX::CellSize(lev);
     const std::array<Real,3>& cdx = WarpX::CellSize(std::max(lev-1,0));
 
     const auto& mypc = WarpX::GetInstance().GetPartContainer();
     const int nstencilz_fdtd_nci_corr = mypc.nstencilz_fdtd_nci_corr;
+    // With particles.nci_corr_once_per_step, the fields passed in are already filtered.
+    const bool nci_filter_tiles = warpx_use_fdtd_nci_corr() && !mypc.Nci_corr_once_per_step();
 
     // WarpX assumes the same number of guard cells for Jx, Jy, Jz
     long ngJ = jx.nGrow();
 
-    BL_ASSERT(OnSameGrids(lev,Ex));
-
     MultiFab* cost = WarpX::getCosts(lev);
 
     const iMultiFab* current_masks = WarpX::CurrentBufferMasks(lev);
@@ -718,336 +1149,345 @@ PhysicalParticleContainer::Evolve (int lev,
 
     bool has_buffer = cEx || cjx;
 
-#ifdef _OPENMP
-#pragma omp parallel
-#endif
-    {
-	Vector<Real> xp, yp, zp, giv;
-        FArrayBox local_rho, local_jx, local_jy, local_jz;
-        FArrayBox filtered_Ex, filtered_Ey, filtered_Ez;
-        FArrayBox filtered_Bx, filtered_By, filtered_Bz;
-        std::vector<bool> inexflag;
-        Vector<long> pid;
-        Vector<Real> tmp;
-        Vector<ParticleType> particle_tmp;
-
-	for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
-	{
-            Real wt = amrex::second();
+    // The fine patch current is deposited directly onto jx, jy, jz (with tile
+    // coloring), onto the current buffers of the tile shared by all species (in the
+    // species-fused loop of MultiParticleContainer::Evolve, which adds them to jx, jy,
+    // jz), or onto thread-local buffers that are added to jx, jy, jz here.
+    const bool use_local_j = !deposit_in_place && !scratch.shared_j;
 
-	    const Box& box = pti.validbox();
+    const Geometry& geom = Geom(lev);
 
-            auto& attribs = pti.GetAttribs();
+    Vector<Real>& giv = scratch.giv;
+    FArrayBox& local_rho = scratch.local_rho;
+    FArrayBox& local_jx = scratch.local_jx;
+    FArrayBox& local_jy = scratch.local_jy;
+    FArrayBox& local_jz = scratch.local_jz;
+    FArrayBox& filtered_Ex = scratch.filtered_Ex;
+    FArrayBox& filtered_Ey = scratch.filtered_Ey;
+    FArrayBox& filtered_Ez = scratch.filtered_Ez;
+    FArrayBox& filtered_Bx = scratch.filtered_Bx;
+    FArrayBox& filtered_By = scratch.filtered_By;
+    FArrayBox& filtered_Bz = scratch.filtered_Bz;
+    Real wt = amrex::second();
+
+    const Box& box = pti.validbox();
 
-            auto&  wp = attribs[PIdx::w];
-            auto& uxp = attribs[PIdx::ux];
-            auto& uyp = attribs[PIdx::uy];
-            auto& uzp = attribs[PIdx::uz];
-            auto& Exp = attribs[PIdx::Ex];
-            auto& Eyp = attribs[PIdx::Ey];
-            auto& Ezp = attribs[PIdx::Ez];
-            auto& Bxp = attribs[PIdx::Bx];
-            auto& Byp = attribs[PIdx::By];
-            auto& Bzp = attribs[PIdx::Bz];
-
-            const long np = pti.numParticles();
+    auto& attribs = pti.GetAttribs();
 
-	    // Data on the grid
-            FArrayBox const* exfab = &(Ex[pti]);
-            FArrayBox const* eyfab = &(Ey[pti]);
-            FArrayBox const* ezfab = &(Ez[pti]);
-            FArrayBox const* bxfab = &(Bx[pti]);
-            FArrayBox const* byfab = &(By[pti]);
-            FArrayBox const* bzfab = &(Bz[pti]);
-
-            if (warpx_use_fdtd_nci_corr())
-            {
+    auto&  xp = attribs[PIdx::x];
+    auto&  yp = attribs[PIdx::y];
+    auto&  zp = attribs[PIdx::z];
+    auto&  wp = attribs[PIdx::w];
+    auto& uxp = attribs[PIdx::ux];
+    auto& uyp = attribs[PIdx::uy];
+    auto& uzp = attribs[PIdx::uz];
+    auto particle_fields = GetParticleFields(pti);
+    auto& Exp = *particle_fields[0];
+    auto& Eyp = *particle_fields[1];
+    auto& Ezp = *particle_fields[2];
+    auto& Bxp = *particle_fields[3];
+    auto& Byp = *particle_fields[4];
+    auto& Bzp = *particle_fields[5];
+
+    // Below, the particle arrays are offset by i0, and np is the number of particles processed
+    const long np_tile = pti.numParticles();
+    const long i0 = pbegin;
+    const long np = pend - pbegin;
+
+    // Data on the grid
+    FArrayBox const* exfab = &(Ex[pti]);
+    FArrayBox const* eyfab = &(Ey[pti]);
+    FArrayBox const* ezfab = &(Ez[pti]);
+    FArrayBox const* bxfab = &(Bx[pti]);
+    FArrayBox const* byfab = &(By[pti]);
+    FArrayBox const* bzfab = &(Bz[pti]);
+
+    if (nci_filter_tiles)
+    {
+        BL_PROFILE_VAR_START(blp_nci);
 #if (AMREX_SPACEDIM == 2)
-                const Box& tbox = amrex::grow(pti.tilebox(),{static_cast<int>(WarpX::nox),
-                            static_cast<int>(WarpX::noz)});
+        const Box& tbox = amrex::grow(pti.tilebox(),{static_cast<int>(WarpX::nox),
+                    static_cast<int>(WarpX::noz)});
 #else
-                const Box& tbox = amrex::grow(pti.tilebox(),{static_cast<int>(WarpX::nox),
-                            static_cast<int>(WarpX::noy),
-                            static_cast<int>(WarpX::noz)});
+        const Box& tbox = amrex::grow(pti.tilebox(),{static_cast<int>(WarpX::nox),
+                    static_cast<int>(WarpX::noy),
+                    static_cast<int>(WarpX::noz)});
 #endif
 
-                // both 2d and 3d
-                filtered_Ex.resize(amrex::convert(tbox,WarpX::Ex_nodal_flag));
-                WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Ex),
-                                        BL_TO_FORTRAN_ANYD(filtered_Ex),
-                                        BL_TO_FORTRAN_ANYD(Ex[pti]),
-                                        mypc.fdtd_nci_stencilz_ex[lev].data(),
-                                        &nstencilz_fdtd_nci_corr);
-                exfab = &filtered_Ex;
-
-                filtered_Ez.resize(amrex::convert(tbox,WarpX::Ez_nodal_flag));
-                WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Ez),
-                                        BL_TO_FORTRAN_ANYD(filtered_Ez),
-                                        BL_TO_FORTRAN_ANYD(Ez[pti]),
-                                        mypc.fdtd_nci_stencilz_by[lev].data(),
-                                        &nstencilz_fdtd_nci_corr);
-                ezfab = &filtered_Ez;
-
-                filtered_By.resize(amrex::convert(tbox,WarpX::By_nodal_flag));
-                WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_By),
-                                        BL_TO_FORTRAN_ANYD(filtered_By),
-                                        BL_TO_FORTRAN_ANYD(By[pti]),
-                                        mypc.fdtd_nci_stencilz_by[lev].data(),
-                                        &nstencilz_fdtd_nci_corr);
-                byfab = &filtered_By;
+        // both 2d and 3d
+        scratch.resize(filtered_Ex, amrex::convert(tbox,WarpX::Ex_nodal_flag));
+        WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Ex),
+                                BL_TO_FORTRAN_ANYD(filtered_Ex),
+                                BL_TO_FORTRAN_ANYD(Ex[pti]),
+                                mypc.fdtd_nci_stencilz_ex[lev].data(),
+                                &nstencilz_fdtd_nci_corr);
+        exfab = &filtered_Ex;
+
+        scratch.resize(filtered_Ez, amrex::convert(tbox,WarpX::Ez_nodal_flag));
+        WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Ez),
+                                BL_TO_FORTRAN_ANYD(filtered_Ez),
+                                BL_TO_FORTRAN_ANYD(Ez[pti]),
+                                mypc.fdtd_nci_stencilz_by[lev].data(),
+                                &nstencilz_fdtd_nci_corr);
+        ezfab = &filtered_Ez;
+
+        scratch.resize(filtered_By, amrex::convert(tbox,WarpX::By_nodal_flag));
+        WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_By),
+                                BL_TO_FORTRAN_ANYD(filtered_By),
+                                BL_TO_FORTRAN_ANYD(By[pti]),
+                                mypc.fdtd_nci_stencilz_by[lev].data(),
+                                &nstencilz_fdtd_nci_corr);
+        byfab = &filtered_By;
 
 #if (AMREX_SPACEDIM == 3)
-                filtered_Ey.resize(amrex::convert(tbox,WarpX::Ey_nodal_flag));
-                WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Ey),
-                                        BL_TO_FORTRAN_ANYD(filtered_Ey),
-                                        BL_TO_FORTRAN_ANYD(Ey[pti]),
-                                        mypc.fdtd_nci_stencilz_ex[lev].data(),
-                                        &nstencilz_fdtd_nci_corr);
-                eyfab = &filtered_Ey;
-
-                filtered_Bx.resize(amrex::convert(tbox,WarpX::Bx_nodal_flag));
-                WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Bx),
-                                        BL_TO_FORTRAN_ANYD(filtered_Bx),
-                                        BL_TO_FORTRAN_ANYD(Bx[pti]),
-                                        mypc.fdtd_nci_stencilz_by[lev].data(),
-                                        &nstencilz_fdtd_nci_corr);
-                bxfab = &filtered_Bx;
-
-                filtered_Bz.resize(amrex::convert(tbox,WarpX::Bz_nodal_flag));
-                WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Bz),
-                                        BL_TO_FORTRAN_ANYD(filtered_Bz),
-                                        BL_TO_FORTRAN_ANYD(Bz[pti]),
-                                        mypc.fdtd_nci_stencilz_ex[lev].data(),
-                                        &nstencilz_fdtd_nci_corr);
-                bzfab = &filtered_Bz;
+        scratch.resize(filtered_Ey, amrex::convert(tbox,WarpX::Ey_nodal_flag));
+        WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Ey),
+                                BL_TO_FORTRAN_ANYD(filtered_Ey),
+                                BL_TO_FORTRAN_ANYD(Ey[pti]),
+                                mypc.fdtd_nci_stencilz_ex[lev].data(),
+                                &nstencilz_fdtd_nci_corr);
+        eyfab = &filtered_Ey;
+
+        scratch.resize(filtered_Bx, amrex::convert(tbox,WarpX::Bx_nodal_flag));
+        WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Bx),
+                                BL_TO_FORTRAN_ANYD(filtered_Bx),
+                                BL_TO_FORTRAN_ANYD(Bx[pti]),
+                                mypc.fdtd_nci_stencilz_by[lev].data(),
+                                &nstencilz_fdtd_nci_corr);
+        bxfab = &filtered_Bx;
+
+        scratch.resize(filtered_Bz, amrex::convert(tbox,WarpX::Bz_nodal_flag));
+        WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Bz),
+                                BL_TO_FORTRAN_ANYD(filtered_Bz),
+                                BL_TO_FORTRAN_ANYD(Bz[pti]),
+                                mypc.fdtd_nci_stencilz_ex[lev].data(),
+                                &nstencilz_fdtd_nci_corr);
+        bzfab = &filtered_Bz;
 #endif
-            }
-
-	    FArrayBox& jxfab = jx[pti];
-	    FArrayBox& jyfab = jy[pti];
-	    FArrayBox& jzfab = jz[pti];
-
-	    Exp.assign(np,0.0);
-	    Eyp.assign(np,0.0);
-	    Ezp.assign(np,0.0);
-	    Bxp.assign(np,WarpX::B_external[0]);
-	    Byp.assign(np,WarpX::B_external[1]);
-	    Bzp.assign(np,WarpX::B_external[2]);
-
-	    giv.resize(np);
+        BL_PROFILE_VAR_STOP(blp_nci);
+    }
 
-            long nfine_current = np;
-            long nfine_gather = np;
-            if (has_buffer && !do_not_push)
-            {
-                BL_PROFILE_VAR_START(blp_partition);
-                inexflag.resize(np);
-                auto& aos = pti.GetArrayOfStructs();
-                // We need to partition the large buffer first
-                iMultiFab const* bmasks = (WarpX::n_field_gather_buffer >= WarpX::n_current_deposition_buffer) ?
-                    gather_masks : current_masks;
-                int i = 0;
-                const auto& msk = (*bmasks)[pti];
-                for (const auto& p : aos) {
-                    const IntVect& iv = Index(p, lev);
-                    inexflag[i++] = msk(iv);
+    FArrayBox& jxfab = jx[pti];
+    FArrayBox& jyfab = jy[pti];
+    FArrayBox& jzfab = jz[pti];
+
+    auto resetField = [&] (Vector<Real>& f, Real val) {
+        f.resize(np_tile);
+        std::fill(f.begin()+i0, f.begin()+i0+np, val);
+    };
+    resetField(Exp, 0.0);
+    resetField(Eyp, 0.0);
+    resetField(Ezp, 0.0);
+    resetField(Bxp, WarpX::B_external[0]);
+    resetField(Byp, WarpX::B_external[1]);
+    resetField(Bzp, WarpX::B_external[2]);
+
+    scratch.resize(giv, np_tile);
+
+    long nfine_current = np;
+    long nfine_gather = np;
+    if (has_buffer && !do_not_push)
+    {
+        BL_PROFILE_VAR_START(blp_partition);
+        // We need to partition the large buffer first
+        iMultiFab const* bmasks = (WarpX::n_field_gather_buffer >= WarpX::n_current_deposition_buffer) ?
+            gather_masks : current_masks;
+        const auto& msk = (*bmasks)[pti];
+
+        // The particles are within one cell of the tile. If the mask is one
+        // everywhere there, no particle is in the buffers and there is nothing to do.
+        const Box& pbox = amrex::grow(pti.tilebox(),1) & msk.box();
+        if (msk.min(pbox,0) == 0)
+        {
+            long sep = PartitionParticles(pti, i0, i0+np,
+                [&] (long ip) { return msk(CellIndex(geom, xp, yp, zp, ip)) != 0; }) - i0;
+
+            if (WarpX::n_current_deposition_buffer == WarpX::n_field_gather_buffer) {
+                nfine_current = nfine_gather = sep;
+            } else if (sep != np) {
+                int n_buf;
+                if (bmasks == gather_masks) {
+                    nfine_gather = sep;
+                    bmasks = current_masks;
+                    n_buf = WarpX::n_current_deposition_buffer;
+                } else {
+                    nfine_current = sep;
+                    bmasks = gather_masks;
+                    n_buf = WarpX::n_field_gather_buffer;
                 }
-
-                pid.resize(np);
-                std::iota(pid.begin(), pid.end(), 0L);
-
-                auto sep = std::stable_partition(pid.begin(), pid.end(),
-                                                 [&inexflag](long id) { return inexflag[id]; });
-
-                if (WarpX::n_current_deposition_buffer == WarpX::n_field_gather_buffer) {
-                    nfine_current = nfine_gather = std::distance(pid.begin(), sep);
-                } else if (sep != pid.end()) {
-                    int n_buf;
+                if (n_buf > 0)
+                {
+                    const auto& msk2 = (*bmasks)[pti];
+                    long sep2 = PartitionParticles(pti, i0+sep, i0+np,
+                        [&] (long ip) { return msk2(CellIndex(geom, xp, yp, zp, ip)) != 0; }) - i0;
                     if (bmasks == gather_masks) {
-                        nfine_gather = std::distance(pid.begin(), sep);
-                        bmasks = current_masks;
-                        n_buf = WarpX::n_current_deposition_buffer;
+                        nfine_gather = sep2;
                     } else {
-                        nfine_current = std::distance(pid.begin(), sep);
-                        bmasks = gather_masks;
-                        n_buf = WarpX::n_field_gather_buffer;
-                    }
-                    if (n_buf > 0)
-                    {
-                        const auto& msk2 = (*bmasks)[pti];
-                        for (auto it = sep; it != pid.end(); ++it) {
-                            const long id = *it;
-                            const IntVect& iv = Index(aos[id], lev);
-                            inexflag[id] = msk2(iv);
-                        }
-
-                        auto sep2 = std::stable_partition(sep, pid.end(),
-                                                          [&inexflag](long id) {return inexflag[id];});
-                        if (bmasks == gather_masks) {
-                            nfine_gather = std::distance(pid.begin(), sep2);
-                        } else {
-                            nfine_current = std::distance(pid.begin(), sep2);
-                        }
+                        nfine_current = sep2;
                     }
                 }
+            }
+        }
 
-                if (deposit_on_main_grid && lev > 0) {
-                    nfine_current = 0;
-                }
+        if (deposit_on_main_grid && lev > 0) {
+            nfine_current = 0;
+        }
+        BL_PROFILE_VAR_STOP(blp_partition);
+    }
 
-                if (nfine_current != np || nfine_gather != np)
-                {
-                    particle_tmp.resize(np);
-                    for (long ip = 0; ip < np; ++ip) {
-                        particle_tmp[ip] = aos[pid[ip]];
-                    }
-                    std::swap(aos(), particle_tmp);
+    const long np_current = (cjx) ? nfine_current : np;
 
-                    tmp.resize(np);
-                    for (long ip = 0; ip < np; ++ip) {
-                        tmp[ip] = wp[pid[ip]];
-                    }
-                    std::swap(wp, tmp);
+    const std::array<Real,3>& xyzmin_tile = WarpX::LowerCorner(pti.tilebox(), lev);
+    const std::array<Real,3>& xyzmin_grid = WarpX::LowerCorner(box, lev);
+    const int* ixyzmin_grid = box.loVect();
 
-                    for (long ip = 0; ip < np; ++ip) {
-                        tmp[ip] = uxp[pid[ip]];
-                    }
-                    std::swap(uxp, tmp);
+    long lvect = 8;
 
-                    for (long ip = 0; ip < np; ++ip) {
-                        tmp[ip] = uyp[pid[ip]];
-                    }
-                    std::swap(uyp, tmp);
-
-                    for (long ip = 0; ip < np; ++ip) {
-                        tmp[ip] = uzp[pid[ip]];
-                    }
-                    std::swap(uzp, tmp);
-                }
-                BL_PROFILE_VAR_STOP(blp_partition);
+    auto depositCharge = [&] (MultiFab* rhomf, MultiFab* crhomf, int icomp)
+    {
+        long ngRho = rhomf->nGrow();
+        Real* data_ptr;
+        Box tile_box = convert(pti.tilebox(), IntVect::TheUnitVector());
+        const int *rholen;
+
+        if (np_current > 0)
+        {                
+            FArrayBox& rhofab = (*rhomf)[pti];
+            const std::array<Real, 3>& xyzmin = (deposit_in_place) ? xyzmin_grid : xyzmin_tile;
+            if (deposit_in_place) {
+                data_ptr = rhofab.dataPtr(icomp);
+                rholen = rhofab.length();
+            } else {
+                tile_box.grow(ngRho);
+                scratch.resize(local_rho, tile_box);
+                local_rho = 0.0;
+                data_ptr = local_rho.dataPtr();
+                rholen = local_rho.length();
             }
 
-            const long np_current = (cjx) ? nfine_current : np;
-            
-	    //
-	    // copy data from particle container to temp arrays
-	    //
-	    BL_PROFILE_VAR_START(blp_copy);
-            pti.GetPosition(xp, yp, zp);
-	    BL_PROFILE_VAR_STOP(blp_copy);
-
-            const std::array<Real,3>& xyzmin_tile = WarpX::LowerCorner(pti.tilebox(), lev);
-            const std::array<Real,3>& xyzmin_grid = WarpX::LowerCorner(box, lev);
-            const int* ixyzmin_grid = box.loVect();
-
-	    long lvect = 8;
-
-            auto depositCharge = [&] (MultiFab* rhomf, MultiFab* crhomf, int icomp)
-            {
-                long ngRho = rhomf->nGrow();
-                Real* data_ptr;
-                Box tile_box = convert(pti.tilebox(), IntVect::TheUnitVector());
-                const int *rholen;
-                
-                if (np_current > 0)
-                {                
-                    FArrayBox& rhofab = (*rhomf)[pti];
-                    const std::array<Real, 3>& xyzmin = xyzmin_tile;
-                    tile_box.grow(ngRho);
-                    local_rho.resize(tile_box);
-                    local_rho = 0.0;
-                    data_ptr = local_rho.dataPtr();
-                    rholen = local_rho.length();
-                    
 #if (AMREX_SPACEDIM == 3)
-                    const long nx = rholen[0]-1-2*ngRho;
-                    const long ny = rholen[1]-1-2*ngRho;
-                    const long nz = rholen[2]-1-2*ngRho;
+            const long nx = rholen[0]-1-2*ngRho;
+            const long ny = rholen[1]-1-2*ngRho;
+            const long nz = rholen[2]-1-2*ngRho;
 #else
-                    const long nx = rholen[0]-1-2*ngRho;
-                    const long ny = 0;
-                    const long nz = rholen[1]-1-2*ngRho;
+            const long nx = rholen[0]-1-2*ngRho;
+            const long ny = 0;
+            const long nz = rholen[1]-1-2*ngRho;
 #endif
-                    warpx_charge_deposition(data_ptr, &np_current,
-                                            xp.data(), yp.data(), zp.data(), wp.data(),
-                                            &this->charge,
-                                            &xyzmin[0], &xyzmin[1], &xyzmin[2],
-                                            &dx[0], &dx[1], &dx[2], &nx, &ny, &nz,
-                                            &ngRho, &ngRho, &ngRho,
-                                            &WarpX::nox,&WarpX::noy,&WarpX::noz,
-                                            &lvect, &WarpX::charge_deposition_algo);
-
-                    const int ncomp = 1;
-                    amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(local_rho),
-                                                BL_TO_FORTRAN_N_3D(rhofab,icomp), ncomp);
-                }
+            ParticleKernels::charge_deposition(data_ptr, &np_current,
+                                              xp.data()+i0, yp.data()+i0, zp.data()+i0, wp.data()+i0,
+                                              &this->charge,
+                                              &xyzmin[0], &xyzmin[1], &xyzmin[2],
+                                              &dx[0], &dx[1], &dx[2], &nx, &ny, &nz,
+                                              &ngRho, &ngRho, &ngRho,
+                                              &WarpX::nox,&WarpX::noy,&WarpX::noz,
+                                              &lvect, &WarpX::charge_deposition_algo);
+
+            if (!deposit_in_place) {
+                const int ncomp = 1;
+                amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(local_rho),
+                                            BL_TO_FORTRAN_N_3D(rhofab,icomp), ncomp);
+            }
+        }
 
-                if (np_current < np)
-                {
-                    const IntVect& ref_ratio = WarpX::RefRatio(lev-1);
-                    const Box& ctilebox = amrex::coarsen(pti.tilebox(), ref_ratio);
-                    const std::array<Real,3>& cxyzmin_tile = WarpX::LowerCorner(ctilebox, lev-1);
+        if (np_current < np)
+        {
+            const IntVect& ref_ratio = WarpX::RefRatio(lev-1);
+            const Box& ctilebox = amrex::coarsen(pti.tilebox(), ref_ratio);
+            const std::array<Real,3>& cxyzmin_tile = WarpX::LowerCorner(ctilebox, lev-1);
 
-                    tile_box = amrex::convert(ctilebox, IntVect::TheUnitVector());
-                    tile_box.grow(ngRho);
+            tile_box = amrex::convert(ctilebox, IntVect::TheUnitVector());
+            tile_box.grow(ngRho);
 
-                    local_rho.resize(tile_box);
+            scratch.resize(local_rho, tile_box);
 
-                    local_rho = 0.0;
+            local_rho = 0.0;
 
-                    data_ptr = local_rho.dataPtr();
-                    rholen = local_rho.length();
+            data_ptr = local_rho.dataPtr();
+            rholen = local_rho.length();
 
 #if (AMREX_SPACEDIM == 3)
-                    const long nx = rholen[0]-1-2*ngRho;
-                    const long ny = rholen[1]-1-2*ngRho;
-                    const long nz = rholen[2]-1-2*ngRho;
+            const long nx = rholen[0]-1-2*ngRho;
+            const long ny = rholen[1]-1-2*ngRho;
+            const long nz = rholen[2]-1-2*ngRho;
 #else
-                    const long nx = rholen[0]-1-2*ngRho;
-                    const long ny = 0;
-                    const long nz = rholen[1]-1-2*ngRho;
+            const long nx = rholen[0]-1-2*ngRho;
+            const long ny = 0;
+            const long nz = rholen[1]-1-2*ngRho;
 #endif
-                    
-                    long ncrse = np - nfine_current;
-                    warpx_charge_deposition(data_ptr, &ncrse,
-                                            xp.data() + nfine_current,
-                                            yp.data() + nfine_current,
-                                            zp.data() + nfine_current,
-                                            wp.data() + nfine_current,
-                                            &this->charge,
-                                            &cxyzmin_tile[0], &cxyzmin_tile[1], &cxyzmin_tile[2],
-                                            &cdx[0], &cdx[1], &cdx[2], &nx, &ny, &nz,
-                                            &ngRho, &ngRho, &ngRho,
-                                            &WarpX::nox,&WarpX::noy,&WarpX::noz,
-                                            &lvect, &WarpX::charge_deposition_algo);
-
-                    FArrayBox& crhofab = (*crhomf)[pti];
-                    
-                    const int ncomp = 1;
-                    amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(local_rho),
-                                                BL_TO_FORTRAN_N_3D(crhofab,icomp), ncomp);
-                }                
-            };
 
-            if (rho) depositCharge(rho, crho, 0);
+            long ncrse = np - nfine_current;
+            ParticleKernels::charge_deposition(data_ptr, &ncrse,
+                                              xp.data()+i0+nfine_current,
+                                              yp.data()+i0+nfine_current,
+                                              zp.data()+i0+nfine_current,
+                                              wp.data()+i0+nfine_current,
+                                              &this->charge,
+                                              &cxyzmin_tile[0], &cxyzmin_tile[1], &cxyzmin_tile[2],
+                                              &cdx[0], &cdx[1], &cdx[2], &nx, &ny, &nz,
+                                              &ngRho, &ngRho, &ngRho,
+                                              &WarpX::nox,&WarpX::noy,&WarpX::noz,
+                                              &lvect, &WarpX::charge_deposition_algo);
+
+            FArrayBox& crhofab = (*crhomf)[pti];
+
+            const int ncomp = 1;
+            amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(local_rho),
+                                        BL_TO_FORTRAN_N_3D(crhofab,icomp), ncomp);
+        }                
+    };
+
+    if (rho) depositCharge(rho, crho, 0);
+
+    if (! do_not_push)
+    {
+        const int ll4symtry          = false;
+        const int l_lower_order_in_v = warpx_l_lower_order_in_v();
+        long lvect_fieldgathe = 64;
+
+        const long np_gather = (cEx) ? nfine_gather : np;
 
-            if (! do_not_push)
+        if (use_fused_kernel && FusedKernelSupported() &&
+            np_gather == np && np_current == np)
+        {
+            //
+            // Fused gather, push and current deposition onto the fine patch.
+            // The tile is processed in chunks of fused_chunk_size particles,
+            // so that the gathered fields and the pushed particle data are
+            // still in cache when the current is deposited.
+            //
+            BL_PROFILE_VAR_START(blp_fused);
+            if (use_local_j)
             {
-                //
-                // Field Gather of Aux Data (i.e., the full solution)
-                //
-                const int ll4symtry          = false;
-                const int l_lower_order_in_v = warpx_l_lower_order_in_v();
-                long lvect_fieldgathe = 64;
+                Box tbx = convert(pti.tilebox(), WarpX::jx_nodal_flag);
+                Box tby = convert(pti.tilebox(), WarpX::jy_nodal_flag);
+                Box tbz = convert(pti.tilebox(), WarpX::jz_nodal_flag);
+                tbx.grow(ngJ);
+                tby.grow(ngJ);
+                tbz.grow(ngJ);
 
-                const long np_gather = (cEx) ? nfine_gather : np;
+                scratch.resize(local_jx, tbx);
+                scratch.resize(local_jy, tby);
+                scratch.resize(local_jz, tbz);
 
-                BL_PROFILE_VAR_START(blp_pxr_fg);
+                local_jx = 0.0;
+                local_jy = 0.0;
+                local_jz = 0.0;
+            }
+
+            FArrayBox& djx = (deposit_in_place) ? jxfab : (scratch.shared_j) ? scratch.shared_jx : local_jx;
+            FArrayBox& djy = (deposit_in_place) ? jyfab : (scratch.shared_j) ? scratch.shared_jy : local_jy;
+            FArrayBox& djz = (deposit_in_place) ? jzfab : (scratch.shared_j) ? scratch.shared_jz : local_jz;
+            const std::array<Real, 3>& xyzmin = (deposit_in_place) ? xyzmin_grid : xyzmin_tile;
+
+            for (long ip = 0; ip < np; ip += fused_chunk_size)
+            {
+                long nchunk = std::min(fused_chunk_size, np - ip);
 
-                warpx_geteb_energy_conserving(
-                    &np_gather, xp.data(), yp.data(), zp.data(),
-                    Exp.data(),Eyp.data(),Ezp.data(),
-                    Bxp.data(),Byp.data(),Bzp.data(),
+                ParticleKernels::geteb_energy_conserving(
+                    &nchunk, xp.data()+i0+ip, yp.data()+i0+ip, zp.data()+i0+ip,
+                    Exp.data()+i0+ip, Eyp.data()+i0+ip, Ezp.data()+i0+ip,
+                    Bxp.data()+i0+ip, Byp.data()+i0+ip, Bzp.data()+i0+ip,
                     ixyzmin_grid,
                     &xyzmin_grid[0], &xyzmin_grid[1], &xyzmin_grid[2],
                     &dx[0], &dx[1], &dx[2],
@@ -1061,133 +1501,217 @@ PhysicalParticleContainer::Evolve (int lev,
                     &ll4symtry, &l_lower_order_in_v,
                     &lvect_fieldgathe, &WarpX::field_gathering_algo);
 
-                if (np_gather < np)
+                PushPXChunk(pti, i0+ip, nchunk, xp, yp, zp, giv, dt);
+
+                ParticleKernels::current_deposition(
+                    djx.dataPtr(), &ngJ, djx.length(),
+                    djy.dataPtr(), &ngJ, djy.length(),
+                    djz.dataPtr(), &ngJ, djz.length(),
+                    &nchunk, xp.data()+i0+ip, yp.data()+i0+ip, zp.data()+i0+ip,
+                    uxp.data()+i0+ip, uyp.data()+i0+ip, uzp.data()+i0+ip,
+                    giv.data()+i0+ip, wp.data()+i0+ip, &this->charge,
+                    &xyzmin[0], &xyzmin[1], &xyzmin[2],
+                    &dt, &dx[0], &dx[1], &dx[2],
+                    &WarpX::nox,&WarpX::noy,&WarpX::noz,
+                    &lvect,&WarpX::current_deposition_algo);
+            }
+            BL_PROFILE_VAR_STOP(blp_fused);
+
+            if (use_local_j)
+            {
+                BL_PROFILE_VAR_START(blp_accumulate);
+                const int ncomp = 1;
+                amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(local_jx),
+                                            BL_TO_FORTRAN_3D(jxfab), ncomp);
+
+                amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(local_jy),
+                                            BL_TO_FORTRAN_3D(jyfab), ncomp);
+
+                amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(local_jz),
+                                            BL_TO_FORTRAN_3D(jzfab), ncomp);
+                BL_PROFILE_VAR_STOP(blp_accumulate);
+            }
+        }
+        else
+        {
+            //
+            // Field Gather of Aux Data (i.e., the full solution)
+            //
+            BL_PROFILE_VAR_START(blp_pxr_fg);
+
+            ParticleKernels::geteb_energy_conserving(
+                &np_gather, xp.data()+i0, yp.data()+i0, zp.data()+i0,
+                Exp.data()+i0,Eyp.data()+i0,Ezp.data()+i0,
+                Bxp.data()+i0,Byp.data()+i0,Bzp.data()+i0,
+                ixyzmin_grid,
+                &xyzmin_grid[0], &xyzmin_grid[1], &xyzmin_grid[2],
+                &dx[0], &dx[1], &dx[2],
+                &WarpX::nox, &WarpX::noy, &WarpX::noz,
+                BL_TO_FORTRAN_ANYD(*exfab),
+                BL_TO_FORTRAN_ANYD(*eyfab),
+                BL_TO_FORTRAN_ANYD(*ezfab),
+                BL_TO_FORTRAN_ANYD(*bxfab),
+                BL_TO_FORTRAN_ANYD(*byfab),
+                BL_TO_FORTRAN_ANYD(*bzfab),
+                &ll4symtry, &l_lower_order_in_v,
+                &lvect_fieldgathe, &WarpX::field_gathering_algo);
+
+            if (np_gather < np)
+            {
+                const IntVect& ref_ratio = WarpX::RefRatio(lev-1);
+                const Box& cbox = amrex::coarsen(box,ref_ratio);
+                const std::array<Real,3>& cxyzmin_grid = WarpX::LowerCorner(cbox, lev-1);
+                const int* cixyzmin_grid = cbox.loVect();
+
+                const FArrayBox* cexfab = &(*cEx)[pti];
+                const FArrayBox* ceyfab = &(*cEy)[pti];
+                const FArrayBox* cezfab = &(*cEz)[pti];
+                const FArrayBox* cbxfab = &(*cBx)[pti];
+                const FArrayBox* cbyfab = &(*cBy)[pti];
+                const FArrayBox* cbzfab = &(*cBz)[pti];
+
+                if (nci_filter_tiles)
                 {
-                    const IntVect& ref_ratio = WarpX::RefRatio(lev-1);
-                    const Box& cbox = amrex::coarsen(box,ref_ratio);
-                    const std::array<Real,3>& cxyzmin_grid = WarpX::LowerCorner(cbox, lev-1);
-                    const int* cixyzmin_grid = cbox.loVect();
-
-                    const FArrayBox* cexfab = &(*cEx)[pti];
-                    const FArrayBox* ceyfab = &(*cEy)[pti];
-                    const FArrayBox* cezfab = &(*cEz)[pti];
-                    const FArrayBox* cbxfab = &(*cBx)[pti];
-                    const FArrayBox* cbyfab = &(*cBy)[pti];
-                    const FArrayBox* cbzfab = &(*cBz)[pti];
-
-                    if (warpx_use_fdtd_nci_corr())
-                    {
+                    BL_PROFILE_VAR_START(blp_nci);
 #if (AMREX_SPACEDIM == 2)
-                        const Box& tbox = amrex::grow(cbox,{static_cast<int>(WarpX::nox),
-                                    static_cast<int>(WarpX::noz)});
+                    const Box& tbox = amrex::grow(cbox,{static_cast<int>(WarpX::nox),
+                                static_cast<int>(WarpX::noz)});
 #else
-                        const Box& tbox = amrex::grow(cbox,{static_cast<int>(WarpX::nox),
-                                    static_cast<int>(WarpX::noy),
-                                    static_cast<int>(WarpX::noz)});
+                    const Box& tbox = amrex::grow(cbox,{static_cast<int>(WarpX::nox),
+                                static_cast<int>(WarpX::noy),
+                                static_cast<int>(WarpX::noz)});
 #endif
 
-                        // both 2d and 3d
-                        filtered_Ex.resize(amrex::convert(tbox,WarpX::Ex_nodal_flag));
-                        WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Ex),
-                                                BL_TO_FORTRAN_ANYD(filtered_Ex),
-                                                BL_TO_FORTRAN_ANYD((*cEx)[pti]),
-                                                mypc.fdtd_nci_stencilz_ex[lev-1].data(),
-                                                &nstencilz_fdtd_nci_corr);
-                        cexfab = &filtered_Ex;
-
-                        filtered_Ez.resize(amrex::convert(tbox,WarpX::Ez_nodal_flag));
-                        WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Ez),
-                                                BL_TO_FORTRAN_ANYD(filtered_Ez),
-                                                BL_TO_FORTRAN_ANYD((*cEz)[pti]),
-                                                mypc.fdtd_nci_stencilz_by[lev-1].data(),
-                                                &nstencilz_fdtd_nci_corr);
-                        cezfab = &filtered_Ez;
-                        filtered_By.resize(amrex::convert(tbox,WarpX::By_nodal_flag));
-                        WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_By),
-                                                BL_TO_FORTRAN_ANYD(filtered_By),
-                                                BL_TO_FORTRAN_ANYD((*cBy)[pti]),
-                                                mypc.fdtd_nci_stencilz_by[lev-1].data(),
-                                                &nstencilz_fdtd_nci_corr);
-                        cbyfab = &filtered_By;
+                    // both 2d and 3d
+                    scratch.resize(filtered_Ex, amrex::convert(tbox,WarpX::Ex_nodal_flag));
+                    WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Ex),
+                                            BL_TO_FORTRAN_ANYD(filtered_Ex),
+                                            BL_TO_FORTRAN_ANYD((*cEx)[pti]),
+                                            mypc.fdtd_nci_stencilz_ex[lev-1].data(),
+                                            &nstencilz_fdtd_nci_corr);
+                    cexfab = &filtered_Ex;
+
+                    scratch.resize(filtered_Ez, amrex::convert(tbox,WarpX::Ez_nodal_flag));
+                    WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Ez),
+                                            BL_TO_FORTRAN_ANYD(filtered_Ez),
+                                            BL_TO_FORTRAN_ANYD((*cEz)[pti]),
+                                            mypc.fdtd_nci_stencilz_by[lev-1].data(),
+                                            &nstencilz_fdtd_nci_corr);
+                    cezfab = &filtered_Ez;
+                    scratch.resize(filtered_By, amrex::convert(tbox,WarpX::By_nodal_flag));
+                    WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_By),
+                                            BL_TO_FORTRAN_ANYD(filtered_By),
+                                            BL_TO_FORTRAN_ANYD((*cBy)[pti]),
+                                            mypc.fdtd_nci_stencilz_by[lev-1].data(),
+                                            &nstencilz_fdtd_nci_corr);
+                    cbyfab = &filtered_By;
 
 #if (AMREX_SPACEDIM == 3)
-                        filtered_Ey.resize(amrex::convert(tbox,WarpX::Ey_nodal_flag));
-                        WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Ey),
-                                                BL_TO_FORTRAN_ANYD(filtered_Ey),
-                                                BL_TO_FORTRAN_ANYD((*cEy)[pti]),
-                                                mypc.fdtd_nci_stencilz_ex[lev-1].data(),
-                                                &nstencilz_fdtd_nci_corr);
-                        ceyfab = &filtered_Ey;
-                        
-                        filtered_Bx.resize(amrex::convert(tbox,WarpX::Bx_nodal_flag));
-                        WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Bx),
-                                                BL_TO_FORTRAN_ANYD(filtered_Bx),
-                                                BL_TO_FORTRAN_ANYD((*cBx)[pti]),
-                                                mypc.fdtd_nci_stencilz_by[lev-1].data(),
-                                                &nstencilz_fdtd_nci_corr);
-                        cbxfab = &filtered_Bx;
-                        
-                        filtered_Bz.resize(amrex::convert(tbox,WarpX::Bz_nodal_flag));
-                        WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Bz),
-                                                BL_TO_FORTRAN_ANYD(filtered_Bz),
-                                                BL_TO_FORTRAN_ANYD((*cBz)[pti]),
-                                                mypc.fdtd_nci_stencilz_ex[lev-1].data(),
-                                                &nstencilz_fdtd_nci_corr);
-                        cbzfab = &filtered_Bz;
+                    scratch.resize(filtered_Ey, amrex::convert(tbox,WarpX::Ey_nodal_flag));
+                    WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Ey),
+                                            BL_TO_FORTRAN_ANYD(filtered_Ey),
+                                            BL_TO_FORTRAN_ANYD((*cEy)[pti]),
+                                            mypc.fdtd_nci_stencilz_ex[lev-1].data(),
+                                            &nstencilz_fdtd_nci_corr);
+                    ceyfab = &filtered_Ey;
+
+                    scratch.resize(filtered_Bx, amrex::convert(tbox,WarpX::Bx_nodal_flag));
+                    WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Bx),
+                                            BL_TO_FORTRAN_ANYD(filtered_Bx),
+                                            BL_TO_FORTRAN_ANYD((*cBx)[pti]),
+                                            mypc.fdtd_nci_stencilz_by[lev-1].data(),
+                                            &nstencilz_fdtd_nci_corr);
+                    cbxfab = &filtered_Bx;
+
+                    scratch.resize(filtered_Bz, amrex::convert(tbox,WarpX::Bz_nodal_flag));
+                    WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(filtered_Bz),
+                                            BL_TO_FORTRAN_ANYD(filtered_Bz),
+                                            BL_TO_FORTRAN_ANYD((*cBz)[pti]),
+                                            mypc.fdtd_nci_stencilz_ex[lev-1].data(),
+                                            &nstencilz_fdtd_nci_corr);
+                    cbzfab = &filtered_Bz;
 #endif
-                    }
-                    
-                    long ncrse = np - nfine_gather;
-                    warpx_geteb_energy_conserving(
-                        &ncrse, xp.data()+nfine_gather, yp.data()+nfine_gather, zp.data()+nfine_gather,
-                        Exp.data()+nfine_gather, Eyp.data()+nfine_gather, Ezp.data()+nfine_gather,
-                        Bxp.data()+nfine_gather, Byp.data()+nfine_gather, Bzp.data()+nfine_gather,
-                        cixyzmin_grid,
-                        &cxyzmin_grid[0], &cxyzmin_grid[1], &cxyzmin_grid[2],
-                        &cdx[0], &cdx[1], &cdx[2],
-                        &WarpX::nox, &WarpX::noy, &WarpX::noz,
-                        BL_TO_FORTRAN_ANYD(*cexfab),
-                        BL_TO_FORTRAN_ANYD(*ceyfab),
-                        BL_TO_FORTRAN_ANYD(*cezfab),
-                        BL_TO_FORTRAN_ANYD(*cbxfab),
-                        BL_TO_FORTRAN_ANYD(*cbyfab),
-                        BL_TO_FORTRAN_ANYD(*cbzfab),
-                        &ll4symtry, &l_lower_order_in_v,
-                        &lvect_fieldgathe, &WarpX::field_gathering_algo);
+                    BL_PROFILE_VAR_STOP(blp_nci);
                 }
 
-                BL_PROFILE_VAR_STOP(blp_pxr_fg);
+                long ncrse = np - nfine_gather;
+                ParticleKernels::geteb_energy_conserving(
+                    &ncrse, xp.data()+i0+nfine_gather, yp.data()+i0+nfine_gather, zp.data()+i0+nfine_gather,
+                    Exp.data()+i0+nfine_gather, Eyp.data()+i0+nfine_gather, Ezp.data()+i0+nfine_gather,
+                    Bxp.data()+i0+nfine_gather, Byp.data()+i0+nfine_gather, Bzp.data()+i0+nfine_gather,
+                    cixyzmin_grid,
+                    &cxyzmin_grid[0], &cxyzmin_grid[1], &cxyzmin_grid[2],
+                    &cdx[0], &cdx[1], &cdx[2],
+                    &WarpX::nox, &WarpX::noy, &WarpX::noz,
+                    BL_TO_FORTRAN_ANYD(*cexfab),
+                    BL_TO_FORTRAN_ANYD(*ceyfab),
+                    BL_TO_FORTRAN_ANYD(*cezfab),
+                    BL_TO_FORTRAN_ANYD(*cbxfab),
+                    BL_TO_FORTRAN_ANYD(*cbyfab),
+                    BL_TO_FORTRAN_ANYD(*cbzfab),
+                    &ll4symtry, &l_lower_order_in_v,
+                    &lvect_fieldgathe, &WarpX::field_gathering_algo);
+            }
 
-                //
-                // Particle Push
-                //
-                BL_PROFILE_VAR_START(blp_pxr_pp);
+            BL_PROFILE_VAR_STOP(blp_pxr_fg);
+
+            //
+            // Particle Push
+            //
+            BL_PROFILE_VAR_START(blp_pxr_pp);
+            if (np == np_tile) {
                 PushPX(pti, xp, yp, zp, giv, dt);
-                BL_PROFILE_VAR_STOP(blp_pxr_pp);
+            } else {
+                // Containers that override PushPX process whole tiles (see PhaseRange)
+                PushPXChunk(pti, i0, np, xp, yp, zp, giv, dt);
+            }
+            BL_PROFILE_VAR_STOP(blp_pxr_pp);
 
-                //
-                // Current Deposition onto fine patch
-                //
+            //
+            // Current Deposition onto fine patch
+            //
 
-                BL_PROFILE_VAR_START(blp_pxr_cd);
-                Real *jx_ptr, *jy_ptr, *jz_ptr;
-                const int  *jxntot, *jyntot, *jzntot;
-                Box tbx = convert(pti.tilebox(), WarpX::jx_nodal_flag);
-                Box tby = convert(pti.tilebox(), WarpX::jy_nodal_flag);
-                Box tbz = convert(pti.tilebox(), WarpX::jz_nodal_flag);
-                Box gtbx, gtby, gtbz;
+            BL_PROFILE_VAR_START(blp_pxr_cd);
+            Real *jx_ptr, *jy_ptr, *jz_ptr;
+            const int  *jxntot, *jyntot, *jzntot;
+            Box tbx = convert(pti.tilebox(), WarpX::jx_nodal_flag);
+            Box tby = convert(pti.tilebox(), WarpX::jy_nodal_flag);
+            Box tbz = convert(pti.tilebox(), WarpX::jz_nodal_flag);
+            Box gtbx, gtby, gtbz;
 
-                const std::array<Real, 3>& xyzmin = xyzmin_tile;
+            const std::array<Real, 3>& xyzmin = (deposit_in_place) ? xyzmin_grid : xyzmin_tile;
 
-                if (np_current > 0)
+            if (np_current > 0)
+            {
+                if (deposit_in_place)
+                {
+                    jx_ptr = jxfab.dataPtr();
+                    jy_ptr = jyfab.dataPtr();
+                    jz_ptr = jzfab.dataPtr();
+
+                    jxntot = jxfab.length();
+                    jyntot = jyfab.length();
+                    jzntot = jzfab.length();
+                }
+                else if (scratch.shared_j)
+                {
+                    jx_ptr = scratch.shared_jx.dataPtr();
+                    jy_ptr = scratch.shared_jy.dataPtr();
+                    jz_ptr = scratch.shared_jz.dataPtr();
+
+                    jxntot = scratch.shared_jx.length();
+                    jyntot = scratch.shared_jy.length();
+                    jzntot = scratch.shared_jz.length();
+                }
+                else
                 {
                     tbx.grow(ngJ);
                     tby.grow(ngJ);
                     tbz.grow(ngJ);
-                    
-                    local_jx.resize(tbx);
-                    local_jy.resize(tby);
-                    local_jz.resize(tbz);
+
+                    scratch.resize(local_jx, tbx);
+                    scratch.resize(local_jy, tby);
+                    scratch.resize(local_jz, tbz);
 
                     local_jx = 0.0;
                     local_jy = 0.0;
@@ -1200,26 +1724,29 @@ PhysicalParticleContainer::Evolve (int lev,
                     jxntot = local_jx.length();
                     jyntot = local_jy.length();
                     jzntot = local_jz.length();
+                }
 
-                    warpx_current_deposition(
-                        jx_ptr, &ngJ, jxntot,
-                        jy_ptr, &ngJ, jyntot,
-                        jz_ptr, &ngJ, jzntot,
-                        &np_current, xp.data(), yp.data(), zp.data(),
-                        uxp.data(), uyp.data(), uzp.data(),
-                        giv.data(), wp.data(), &this->charge,
-                        &xyzmin[0], &xyzmin[1], &xyzmin[2],
-                        &dt, &dx[0], &dx[1], &dx[2],
-                        &WarpX::nox,&WarpX::noy,&WarpX::noz,
-                        &lvect,&WarpX::current_deposition_algo);
-
-                    BL_PROFILE_VAR_STOP(blp_pxr_cd);
-
+                ParticleKernels::current_deposition(
+                    jx_ptr, &ngJ, jxntot,
+                    jy_ptr, &ngJ, jyntot,
+                    jz_ptr, &ngJ, jzntot,
+                    &np_current, xp.data()+i0, yp.data()+i0, zp.data()+i0,
+                    uxp.data()+i0, uyp.data()+i0, uzp.data()+i0,
+                    giv.data()+i0, wp.data()+i0, &this->charge,
+                    &xyzmin[0], &xyzmin[1], &xyzmin[2],
+                    &dt, &dx[0], &dx[1], &dx[2],
+                    &WarpX::nox,&WarpX::noy,&WarpX::noz,
+                    &lvect,&WarpX::current_deposition_algo);
+
+                BL_PROFILE_VAR_STOP(blp_pxr_cd);
+
+                if (use_local_j)
+                {
                     BL_PROFILE_VAR_START(blp_accumulate);
                     const int ncomp = 1;
                     amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(local_jx),
                                                 BL_TO_FORTRAN_3D(jxfab), ncomp);
-                    
+
                     amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(local_jy),
                                                 BL_TO_FORTRAN_3D(jyfab), ncomp);
 
@@ -1227,79 +1754,72 @@ PhysicalParticleContainer::Evolve (int lev,
                                                 BL_TO_FORTRAN_3D(jzfab), ncomp);
                     BL_PROFILE_VAR_STOP(blp_accumulate);
                 }
-
-                if (np_current < np)
-                {
-                    const IntVect& ref_ratio = WarpX::RefRatio(lev-1);
-                    const Box& ctilebox = amrex::coarsen(pti.tilebox(),ref_ratio);
-                    const std::array<Real,3>& cxyzmin_tile = WarpX::LowerCorner(ctilebox, lev-1);
-
-                    tbx = amrex::convert(ctilebox, WarpX::jx_nodal_flag);
-                    tby = amrex::convert(ctilebox, WarpX::jy_nodal_flag);
-                    tbz = amrex::convert(ctilebox, WarpX::jz_nodal_flag);
-                    tbx.grow(ngJ);
-                    tby.grow(ngJ);
-                    tbz.grow(ngJ);
-
-                    local_jx.resize(tbx);
-                    local_jy.resize(tby);
-                    local_jz.resize(tbz);
-
-                    local_jx = 0.0;
-                    local_jy = 0.0;
-                    local_jz = 0.0;
-
-                    jx_ptr = local_jx.dataPtr();
-                    jy_ptr = local_jy.dataPtr();
-                    jz_ptr = local_jz.dataPtr();
-
-                    jxntot = local_jx.length();
-                    jyntot = local_jy.length();
-                    jzntot = local_jz.length();
-
-                    long ncrse = np - nfine_current;
-                    warpx_current_deposition(
-                        jx_ptr, &ngJ, jxntot,
-                        jy_ptr, &ngJ, jyntot,
-                        jz_ptr, &ngJ, jzntot,
-                        &ncrse, xp.data()+nfine_current, yp.data()+nfine_current, zp.data()+nfine_current,
-                        uxp.data()+nfine_current, uyp.data()+nfine_current, uzp.data()+nfine_current,
-                        giv.data()+nfine_current, wp.data()+nfine_current, &this->charge,
-                        &cxyzmin_tile[0], &cxyzmin_tile[1], &cxyzmin_tile[2],
-                        &dt, &cdx[0], &cdx[1], &cdx[2],
-                        &WarpX::nox,&WarpX::noy,&WarpX::noz,
-                        &lvect,&WarpX::current_deposition_algo);
-
-                    FArrayBox& cjxfab = (*cjx)[pti];
-                    FArrayBox& cjyfab = (*cjy)[pti];
-                    FArrayBox& cjzfab = (*cjz)[pti];
-
-                    const int ncomp = 1;
-                    amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(local_jx),
-                                                BL_TO_FORTRAN_3D(cjxfab), ncomp);
-                    amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(local_jy),
-                                                BL_TO_FORTRAN_3D(cjyfab), ncomp);
-                    amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(local_jz),
-                                                BL_TO_FORTRAN_3D(cjzfab), ncomp);
-                }
-
-                //
-                // copy particle data back
-                //
-                BL_PROFILE_VAR_START(blp_copy);
-                pti.SetPosition(xp, yp, zp);
-                BL_PROFILE_VAR_STOP(blp_copy);
             }
 
-            if (rho) depositCharge(rho, crho, 1);
-
-            if (cost) {
-                const Box& tbx = pti.tilebox();
-                wt = (amrex::second() - wt) / tbx.d_numPts();
-                (*cost)[pti].plus(wt, tbx);
+            if (np_current < np)
+            {
+                const IntVect& ref_ratio = WarpX::RefRatio(lev-1);
+                const Box& ctilebox = amrex::coarsen(pti.tilebox(),ref_ratio);
+                const std::array<Real,3>& cxyzmin_tile = WarpX::LowerCorner(ctilebox, lev-1);
+
+                tbx = amrex::convert(ctilebox, WarpX::jx_nodal_flag);
+                tby = amrex::convert(ctilebox, WarpX::jy_nodal_flag);
+                tbz = amrex::convert(ctilebox, WarpX::jz_nodal_flag);
+                tbx.grow(ngJ);
+                tby.grow(ngJ);
+                tbz.grow(ngJ);
+
+                scratch.resize(local_jx, tbx);
+                scratch.resize(local_jy, tby);
+                scratch.resize(local_jz, tbz);
+
+                local_jx = 0.0;
+                local_jy = 0.0;
+                local_jz = 0.0;
+
+                jx_ptr = local_jx.dataPtr();
+                jy_ptr = local_jy.dataPtr();
+                jz_ptr = local_jz.dataPtr();
+
+                jxntot = local_jx.length();
+                jyntot = local_jy.length();
+                jzntot = local_jz.length();
+
+                long ncrse = np - nfine_current;
+                ParticleKernels::current_deposition(
+                    jx_ptr, &ngJ, jxntot,
+                    jy_ptr, &ngJ, jyntot,
+                    jz_ptr, &ngJ, jzntot,
+                    &ncrse, xp.data()+i0+nfine_current, yp.data()+i0+nfine_current, zp.data()+i0+nfine_current,
+                    uxp.data()+i0+nfine_current, uyp.data()+i0+nfine_current, uzp.data()+i0+nfine_current,
+                    giv.data()+i0+nfine_current, wp.data()+i0+nfine_current, &this->charge,
+                    &cxyzmin_tile[0], &cxyzmin_tile[1], &cxyzmin_tile[2],
+                    &dt, &cdx[0], &cdx[1], &cdx[2],
+                    &WarpX::nox,&WarpX::noy,&WarpX::noz,
+                    &lvect,&WarpX::current_deposition_algo);
+
+                FArrayBox& cjxfab = (*cjx)[pti];
+                FArrayBox& cjyfab = (*cjy)[pti];
+                FArrayBox& cjzfab = (*cjz)[pti];
+
+                const int ncomp = 1;
+                amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(local_jx),
+                                            BL_TO_FORTRAN_3D(cjxfab), ncomp);
+                amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(local_jy),
+                                            BL_TO_FORTRAN_3D(cjyfab), ncomp);
+                amrex_atomic_accumulate_fab(BL_TO_FORTRAN_3D(local_jz),
+                                            BL_TO_FORTRAN_3D(cjzfab), ncomp);
             }
         }
     }
+
+    if (rho) depositCharge(rho, crho, 1);
+
+    if (cost) {
+        const Box& tbx = pti.tilebox();
+        wt = (amrex::second() - wt) / tbx.d_numPts();
+        (*cost)[pti].plus(wt, tbx);
+    }
 }
 
 void
@@ -1310,17 +1830,28 @@ PhysicalParticleContainer::PushPX(WarpXParIter& pti,
 {
 
     // This wraps the call to warpx_particle_pusher so that inheritors can modify the call.
+    PushPXChunk(pti, 0, pti.numParticles(), xp, yp, zp, giv, dt);
+}
+
+void
+PhysicalParticleContainer::PushPXChunk(WarpXParIter& pti, long offset, long n,
+                                       Vector<Real>& xp, Vector<Real>& yp, Vector<Real>& zp,
+                                       Vector<Real>& giv,
+                                       Real dt)
+{
     auto& attribs = pti.GetAttribs();
     auto& uxp = attribs[PIdx::ux];
     auto& uyp = attribs[PIdx::uy];
     auto& uzp = attribs[PIdx::uz];
-    auto& Exp = attribs[PIdx::Ex];
-    auto& Eyp = attribs[PIdx::Ey];
-    auto& Ezp = attribs[PIdx::Ez];
-    auto& Bxp = attribs[PIdx::Bx];
-    auto& Byp = attribs[PIdx::By];
-    auto& Bzp = attribs[PIdx::Bz];
-    const long np  = pti.numParticles();
+    auto particle_fields = GetParticleFields(pti);
+    auto& Exp = *particle_fields[0];
+    auto& Eyp = *particle_fields[1];
+    auto& Ezp = *particle_fields[2];
+    auto& Bxp = *particle_fields[3];
+    auto& Byp = *particle_fields[4];
+    auto& Bzp = *particle_fields[5];
+    const long np  = n;
+    const long i0  = offset;
 
 #ifdef WARPX_STORE_OLD_PARTICLE_ATTRIBS
     auto& xpold  = attribs[PIdx::xold];
@@ -1330,20 +1861,19 @@ PhysicalParticleContainer::PushPX(WarpXParIter& pti,
     auto& uypold = attribs[PIdx::uyold];
     auto& uzpold = attribs[PIdx::uzold];
 
-    warpx_copy_attribs(&np, xp.data(), yp.data(), zp.data(),
-                       uxp.data(), uyp.data(), uzp.data(),
-                       xpold.data(), ypold.data(), zpold.data(),
-                       uxpold.data(), uypold.data(), uzpold.data());
+    warpx_copy_attribs(&np, xp.data()+i0, yp.data()+i0, zp.data()+i0,
+                       uxp.data()+i0, uyp.data()+i0, uzp.data()+i0,
+                       xpold.data()+i0, ypold.data()+i0, zpold.data()+i0,
+                       uxpold.data()+i0, uypold.data()+i0, uzpold.data()+i0);
 
 #endif
 
-    warpx_particle_pusher(&np, xp.data(), yp.data(), zp.data(),
-                          uxp.data(), uyp.data(), uzp.data(), giv.data(),
-                          Exp.dataPtr(), Eyp.dataPtr(), Ezp.dataPtr(),
-                          Bxp.dataPtr(), Byp.dataPtr(), Bzp.dataPtr(),
-                          &this->charge, &this->mass, &dt,
-                          &WarpX::particle_pusher_algo);
-
+    ParticleKernels::particle_pusher(&np, xp.data()+i0, yp.data()+i0, zp.data()+i0,
+                                     uxp.data()+i0, uyp.data()+i0, uzp.data()+i0, giv.data()+i0,
+                                     Exp.dataPtr()+i0, Eyp.dataPtr()+i0, Ezp.dataPtr()+i0,
+                                     Bxp.dataPtr()+i0, Byp.dataPtr()+i0, Bzp.dataPtr()+i0,
+                                     &this->charge, &this->mass, &dt,
+                                     &WarpX::particle_pusher_algo);
 }
 
 void
@@ -1352,6 +1882,7 @@ PhysicalParticleContainer::PushP (int lev, Real dt,
                                   const MultiFab& Bx, const MultiFab& By, const MultiFab& Bz)
 {
     if (do_not_push) return;
+    if (NumActiveTiles(lev) == 0) return;
 
     const std::array<Real,3>& dx = WarpX::CellSize(lev);
 
@@ -1359,7 +1890,8 @@ PhysicalParticleContainer::PushP (int lev, Real dt,
 #pragma omp parallel
 #endif
     {
-	Vector<Real> xp, yp, zp, giv;
+        ParticleScratch& scratch = ParticleScratch::ThreadLocal();
+        Vector<Real>& giv = scratch.giv;
 
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
 	{
@@ -1367,15 +1899,19 @@ PhysicalParticleContainer::PushP (int lev, Real dt,
 
             auto& attribs = pti.GetAttribs();
 
+            auto& xp = attribs[PIdx::x];
+            auto& yp = attribs[PIdx::y];
+            auto& zp = attribs[PIdx::z];
             auto& uxp = attribs[PIdx::ux];
             auto& uyp = attribs[PIdx::uy];
             auto& uzp = attribs[PIdx::uz];
-            auto& Exp = attribs[PIdx::Ex];
-            auto& Eyp = attribs[PIdx::Ey];
-            auto& Ezp = attribs[PIdx::Ez];
-            auto& Bxp = attribs[PIdx::Bx];
-            auto& Byp = attribs[PIdx::By];
-            auto& Bzp = attribs[PIdx::Bz];
+            auto particle_fields = GetParticleFields(pti);
+            auto& Exp = *particle_fields[0];
+            auto& Eyp = *particle_fields[1];
+            auto& Ezp = *particle_fields[2];
+            auto& Bxp = *particle_fields[3];
+            auto& Byp = *particle_fields[4];
+            auto& Bzp = *particle_fields[5];
 
             const long np = pti.numParticles();
 
@@ -1394,12 +1930,7 @@ PhysicalParticleContainer::PushP (int lev, Real dt,
 	    Byp.assign(np,WarpX::B_external[1]);
 	    Bzp.assign(np,WarpX::B_external[2]);
 
-	    giv.resize(np);
-
-	    //
-	    // copy data from particle container to temp arrays
-	    //
-            pti.GetPosition(xp, yp, zp);
+	    scratch.resize(giv, np);
 
             const std::array<Real,3>& xyzmin_grid = WarpX::LowerCorner(box, lev);
             const int* ixyzmin_grid = box.loVect();
@@ -1407,7 +1938,7 @@ PhysicalParticleContainer::PushP (int lev, Real dt,
             const int ll4symtry          = false;
             const int l_lower_order_in_v = true;
             long lvect_fieldgathe = 64;
-            warpx_geteb_energy_conserving(
+            ParticleKernels::geteb_energy_conserving(
                 &np, xp.data(), yp.data(), zp.data(),
                 Exp.data(),Eyp.data(),Ezp.data(),
                 Bxp.data(),Byp.data(),Bzp.data(),
@@ -1424,12 +1955,12 @@ PhysicalParticleContainer::PushP (int lev, Real dt,
                 &ll4symtry, &l_lower_order_in_v,
                 &lvect_fieldgathe, &WarpX::field_gathering_algo);
 
-            warpx_particle_pusher_momenta(&np, xp.data(), yp.data(), zp.data(),
-                                          uxp.data(), uyp.data(), uzp.data(), giv.data(),
-                                          Exp.dataPtr(), Eyp.dataPtr(), Ezp.dataPtr(),
-                                          Bxp.dataPtr(), Byp.dataPtr(), Bzp.dataPtr(),
-                                          &this->charge, &this->mass, &dt,
-                                          &WarpX::particle_pusher_algo);
+            ParticleKernels::particle_pusher_momenta(&np, xp.data(), yp.data(), zp.data(),
+                                                     uxp.data(), uyp.data(), uzp.data(), giv.data(),
+                                                     Exp.dataPtr(), Eyp.dataPtr(), Ezp.dataPtr(),
+                                                     Bxp.dataPtr(), Byp.dataPtr(), Bzp.dataPtr(),
+                                                     &this->charge, &this->mass, &dt,
+                                                     &WarpX::particle_pusher_algo);
         }
     }
 }
@@ -1482,8 +2013,6 @@ void PhysicalParticleContainer::GetParticleSlice(const int direction, const Real
 #pragma omp parallel
 #endif
         {
-            Vector<Real> xp_new, yp_new, zp_new;
-
             for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
             {
                 const Box& box = pti.validbox();
@@ -1494,10 +2023,12 @@ void PhysicalParticleContainer::GetParticleSlice(const int direction, const Real
 
                 if ( !slice_box.intersects(tile_real_box) ) continue;
 
-                pti.GetPosition(xp_new, yp_new, zp_new);
-
                 auto& attribs = pti.GetAttribs();
 
+                const auto& xp_new = attribs[PIdx::x];
+                const auto& yp_new = attribs[PIdx::y];
+                const auto& zp_new = attribs[PIdx::z];
+
                 auto& wp = attribs[PIdx::w ];
 
                 auto& uxp_new = attribs[PIdx::ux   ];
@@ -8,6 +8,7 @@
 
 #include <RigidInjectedParticleContainer.H>
 #include <WarpX_f.H>
+#include <WarpXParticleKernels.H>
 #include <WarpX.H>
 #include <WarpXConst.H>
 
@@ -73,8 +74,6 @@ RigidInjectedParticleContainer::RemapParticles()
                 // Note that the particles are already in the boosted frame.
                 // This value is saved to advance the particles not injected yet
 
-                Vector<Real> xp, yp, zp;
-
                 for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
                 {
 
@@ -83,8 +82,9 @@ RigidInjectedParticleContainer::RemapParticles()
                     auto& uyp = attribs[PIdx::uy];
                     auto& uzp = attribs[PIdx::uz];
 
-                    // Copy data from particle container to temp arrays
-                    pti.GetPosition(xp, yp, zp);
+                    auto& xp = attribs[PIdx::x];
+                    auto& yp = attribs[PIdx::y];
+                    auto& zp = attribs[PIdx::z];
 
                     // Loop over particles
                     const long np = pti.numParticles();
@@ -105,9 +105,6 @@ RigidInjectedParticleContainer::RemapParticles()
 
                     }
 
-                    // Copy the data back to the particle container
-                    pti.SetPosition(xp, yp, zp);
-
                 }
             }
         }
@@ -134,8 +131,6 @@ RigidInjectedParticleContainer::BoostandRemapParticles()
 #pragma omp parallel
 #endif
     {
-        Vector<Real> xp, yp, zp;
-
         for (WarpXParIter pti(*this, 0); pti.isValid(); ++pti)
         {
 
@@ -144,8 +139,9 @@ RigidInjectedParticleContainer::BoostandRemapParticles()
             auto& uyp = attribs[PIdx::uy];
             auto& uzp = attribs[PIdx::uz];
 
-            // Copy data from particle container to temp arrays
-            pti.GetPosition(xp, yp, zp);
+            auto& xp = attribs[PIdx::x];
+            auto& yp = attribs[PIdx::y];
+            auto& zp = attribs[PIdx::z];
 
             // Loop over particles
             const long np = pti.numParticles();
@@ -196,9 +192,6 @@ RigidInjectedParticleContainer::BoostandRemapParticles()
 
             }
 
-            // Copy the data back to the particle container
-            pti.SetPosition(xp, yp, zp);
-
         }
     }
 }
@@ -215,12 +208,13 @@ RigidInjectedParticleContainer::PushPX(WarpXParIter& pti,
     auto& uxp = attribs[PIdx::ux];
     auto& uyp = attribs[PIdx::uy];
     auto& uzp = attribs[PIdx::uz];
-    auto& Exp = attribs[PIdx::Ex];
-    auto& Eyp = attribs[PIdx::Ey];
-    auto& Ezp = attribs[PIdx::Ez];
-    auto& Bxp = attribs[PIdx::Bx];
-    auto& Byp = attribs[PIdx::By];
-    auto& Bzp = attribs[PIdx::Bz];
+    auto particle_fields = GetParticleFields(pti);
+    auto& Exp = *particle_fields[0];
+    auto& Eyp = *particle_fields[1];
+    auto& Ezp = *particle_fields[2];
+    auto& Bxp = *particle_fields[3];
+    auto& Byp = *particle_fields[4];
+    auto& Bzp = *particle_fields[5];
     const long np  = pti.numParticles();
 
 #ifdef WARPX_STORE_OLD_PARTICLE_ATTRIBS
@@ -265,12 +259,12 @@ RigidInjectedParticleContainer::PushPX(WarpXParIter& pti,
         }
     }
 
-    warpx_particle_pusher(&np, xp.data(), yp.data(), zp.data(),
-                          uxp.data(), uyp.data(), uzp.data(), giv.data(),
-                          Exp.dataPtr(), Eyp.dataPtr(), Ezp.dataPtr(),
-                          Bxp.dataPtr(), Byp.dataPtr(), Bzp.dataPtr(),
-                          &this->charge, &this->mass, &dt,
-                          &WarpX::particle_pusher_algo);
+    ParticleKernels::particle_pusher(&np, xp.data(), yp.data(), zp.data(),
+                                     uxp.data(), uyp.data(), uzp.data(), giv.data(),
+                                     Exp.dataPtr(), Eyp.dataPtr(), Ezp.dataPtr(),
+                                     Bxp.dataPtr(), Byp.dataPtr(), Bzp.dataPtr(),
+                                     &this->charge, &this->mass, &dt,
+                                     &WarpX::particle_pusher_algo);
 
     if (!done_injecting_lev) {
 #ifdef _OPENMP
@@ -310,8 +304,10 @@ RigidInjectedParticleContainer::Evolve (int lev,
                                         MultiFab* rho, MultiFab* crho,
                                         const MultiFab* cEx, const MultiFab* cEy, const MultiFab* cEz,
                                         const MultiFab* cBx, const MultiFab* cBy, const MultiFab* cBz,
-                                        Real t, Real dt)
+                                        Real t, Real dt, EvolvePhase phase)
 {
+    // PushPX needs whole tiles: the particles are all evolved in the Boundary phase.
+    if (phase == EvolvePhase::Interior) return;
 
     // Update location of injection plane in the boosted frame
     zinject_plane_lev_previous = zinject_plane_levels[lev];
@@ -335,7 +331,7 @@ RigidInjectedParticleContainer::Evolve (int lev,
                                        rho, crho,
                                        cEx, cEy, cEz,
                                        cBx, cBy, cBz,
-                                       t, dt);
+                                       t, dt, EvolvePhase::All);
 
     // Check if all done_injecting_temp are still true.
     done_injecting[lev] = std::all_of(done_injecting_temp.begin(), done_injecting_temp.end(),
@@ -348,6 +344,7 @@ RigidInjectedParticleContainer::PushP (int lev, Real dt,
                                        const MultiFab& Bx, const MultiFab& By, const MultiFab& Bz)
 {
     if (do_not_push) return;
+    if (NumActiveTiles(lev) == 0) return;
 
     const std::array<Real,3>& dx = WarpX::CellSize(lev);
 
@@ -355,7 +352,8 @@ RigidInjectedParticleContainer::PushP (int lev, Real dt,
 #pragma omp parallel
 #endif
     {
-        Vector<Real> xp, yp, zp, giv;
+        ParticleScratch& scratch = ParticleScratch::ThreadLocal();
+        Vector<Real>& giv = scratch.giv;
 
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
         {
@@ -363,15 +361,19 @@ RigidInjectedParticleContainer::PushP (int lev, Real dt,
 
             auto& attribs = pti.GetAttribs();
 
+            auto& xp = attribs[PIdx::x];
+            auto& yp = attribs[PIdx::y];
+            auto& zp = attribs[PIdx::z];
             auto& uxp = attribs[PIdx::ux];
             auto& uyp = attribs[PIdx::uy];
             auto& uzp = attribs[PIdx::uz];
-            auto& Exp = attribs[PIdx::Ex];
-            auto& Eyp = attribs[PIdx::Ey];
-            auto& Ezp = attribs[PIdx::Ez];
-            auto& Bxp = attribs[PIdx::Bx];
-            auto& Byp = attribs[PIdx::By];
-            auto& Bzp = attribs[PIdx::Bz];
+            auto particle_fields = GetParticleFields(pti);
+            auto& Exp = *particle_fields[0];
+            auto& Eyp = *particle_fields[1];
+            auto& Ezp = *particle_fields[2];
+            auto& Bxp = *particle_fields[3];
+            auto& Byp = *particle_fields[4];
+            auto& Bzp = *particle_fields[5];
 
             const long np = pti.numParticles();
 
@@ -390,12 +392,7 @@ RigidInjectedParticleContainer::PushP (int lev, Real dt,
             Byp.assign(np,WarpX::B_external[1]);
             Bzp.assign(np,WarpX::B_external[2]);
 
-            giv.resize(np);
-
-            //
-            // copy data from particle container to temp arrays
-            //
-            pti.GetPosition(xp, yp, zp);
+            scratch.resize(giv, np);
 
             const std::array<Real,3>& xyzmin_grid = WarpX::LowerCorner(box, lev);
             const int* ixyzmin_grid = box.loVect();
@@ -403,7 +400,7 @@ RigidInjectedParticleContainer::PushP (int lev, Real dt,
             const int ll4symtry          = false;
             const int l_lower_order_in_v = true;
             long lvect_fieldgathe = 64;
-            warpx_geteb_energy_conserving(
+            ParticleKernels::geteb_energy_conserving(
                 &np, xp.data(), yp.data(), zp.data(),
                 Exp.data(),Eyp.data(),Ezp.data(),
                 Bxp.data(),Byp.data(),Bzp.data(),
@@ -425,12 +422,12 @@ RigidInjectedParticleContainer::PushP (int lev, Real dt,
             auto uyp_save = uyp;
             auto uzp_save = uzp;
 
-            warpx_particle_pusher_momenta(&np, xp.data(), yp.data(), zp.data(),
-                                          uxp.data(), uyp.data(), uzp.data(), giv.data(),
-                                          Exp.dataPtr(), Eyp.dataPtr(), Ezp.dataPtr(),
-                                          Bxp.dataPtr(), Byp.dataPtr(), Bzp.dataPtr(),
-                                          &this->charge, &this->mass, &dt,
-                                          &WarpX::particle_pusher_algo);
+            ParticleKernels::particle_pusher_momenta(&np, xp.data(), yp.data(), zp.data(),
+                                                     uxp.data(), uyp.data(), uzp.data(), giv.data(),
+                                                     Exp.dataPtr(), Eyp.dataPtr(), Ezp.dataPtr(),
+                                                     Bxp.dataPtr(), Byp.dataPtr(), Bzp.dataPtr(),
+                                                     &this->charge, &this->mass, &dt,
+                                                     &WarpX::particle_pusher_algo);
 
             // Undo the push for particles not injected yet.
             // It is assumed that PushP will only be called on the first and last steps
@@ -14,6 +14,8 @@
 
 #include <WarpX.H>
 #include <WarpX_f.H>
+#include <WarpXParticleKernels.H>
+#include <WarpXFieldKernels.H>
 #include <WarpXConst.H>
 #include <WarpXWrappers.h>
 #include <WarpXUtil.H>
@@ -136,6 +138,9 @@ WarpX::WarpX ()
     // Particle Container
     mypc = std::unique_ptr<MultiParticleContainer> (new MultiParticleContainer(this));
 
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!overlap_comm || !mypc->Use_fdtd_nci_corr(),
+        "warpx.overlap_comm does not work with particles.use_fdtd_nci_corr.");
+
     if (do_plasma_injection) {
         for (int i = 0; i < num_injected_species; ++i) {
             int ispecies = injected_plasma_species[i];
@@ -164,13 +169,35 @@ WarpX::WarpX ()
 
     Efield_cax.resize(nlevs_max);
     Bfield_cax.resize(nlevs_max);
+    Efield_cdiff.resize(nlevs_max);
+    Bfield_cdiff.resize(nlevs_max);
     current_buffer_masks.resize(nlevs_max);
     gather_buffer_masks.resize(nlevs_max);
+    Efield_aux_nci.resize(nlevs_max);
+    Bfield_aux_nci.resize(nlevs_max);
+    Efield_cax_nci.resize(nlevs_max);
+    Bfield_cax_nci.resize(nlevs_max);
     current_buf.resize(nlevs_max);
     charge_buf.resize(nlevs_max);
+    current_fp_filtered.resize(nlevs_max);
+    current_cp_filtered.resize(nlevs_max);
+    current_buf_filtered.resize(nlevs_max);
+    current_from_fine.resize(nlevs_max);
+    rho_fp_filtered.resize(nlevs_max);
+    rho_cp_filtered.resize(nlevs_max);
+    charge_buf_filtered.resize(nlevs_max);
+    rho_from_fine.resize(nlevs_max);
 
     pml.resize(nlevs_max);
 
+    fill_boundary_E.resize(nlevs_max);
+    fill_boundary_B.resize(nlevs_max);
+    fill_boundary_F.resize(nlevs_max);
+    sum_boundary_J.resize(nlevs_max);
+    sum_boundary_rho.resize(nlevs_max);
+    sum_boundary_J_from_fine.resize(nlevs_max);
+    sum_boundary_rho_from_fine.resize(nlevs_max);
+
 #ifdef WARPX_DO_ELECTROSTATIC
     masks.resize(nlevs_max);
     gather_masks.resize(nlevs_max);
@@ -248,8 +275,35 @@ WarpX::ReadParameters ()
 	pp.query("regrid_int", regrid_int);
         pp.query("do_subcycling", do_subcycling);
 
-        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(do_subcycling != 1 || max_level <= 1,
-                                         "Subcycling method 1 only works for 2 levels.");
+        if (do_subcycling == 1) {
+            for (int lev = 0; lev < max_level; ++lev) {
+                const IntVect& rr = refRatio(lev);
+                AMREX_ALWAYS_ASSERT_WITH_MESSAGE((rr[0] == 2 || rr[0] == 4) && rr == IntVect(rr[0]),
+                    "Subcycling method 1 only works with a refinement ratio of 2 or 4, the same in all directions.");
+            }
+        }
+
+        pp.query("overlap_comm", overlap_comm);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!overlap_comm || max_level == 0,
+                                         "warpx.overlap_comm only works with a single level.");
+
+        pp.query("batch_fill_boundary", batch_fill_boundary);
+
+        pp.query("fdtd_temporal_blocking", fdtd_temporal_blocking);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!fdtd_temporal_blocking || max_level == 0,
+                                         "warpx.fdtd_temporal_blocking only works with a single level.");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!fdtd_temporal_blocking || !overlap_comm,
+                                         "warpx.fdtd_temporal_blocking does not work with warpx.overlap_comm.");
+
+        pp.query("deep_halo_steps", deep_halo_steps);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(deep_halo_steps >= 0, "warpx.deep_halo_steps must be >= 0.");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(deep_halo_steps == 0 || max_level == 0,
+                                         "warpx.deep_halo_steps only works with a single level.");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(deep_halo_steps == 0 || (!overlap_comm && !fdtd_temporal_blocking),
+            "warpx.deep_halo_steps does not work with warpx.overlap_comm and warpx.fdtd_temporal_blocking.");
+#ifdef WARPX_USE_PSATD
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(deep_halo_steps == 0, "warpx.deep_halo_steps requires the FDTD solver.");
+#endif
 
         ReadBoostedFrameParameters(gamma_boost, beta_boost, boost_direction);
 
@@ -339,6 +393,15 @@ WarpX::ReadParameters ()
         pp.query("do_pml", do_pml);
         pp.query("pml_ncell", pml_ncell);
         pp.query("pml_delta", pml_delta);
+        pp.query("pml_fused_damping", pml_fused_damping);
+
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!fdtd_temporal_blocking || (!do_pml && !do_dive_cleaning),
+            "warpx.fdtd_temporal_blocking requires warpx.do_pml = 0 and warpx.do_dive_cleaning = 0.");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(deep_halo_steps == 0 || !do_dive_cleaning,
+            "warpx.deep_halo_steps requires warpx.do_dive_cleaning = 0.");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!pml_fused_damping ||
+                                         (!do_dive_cleaning && (do_subcycling == 0 || max_level == 0)),
+            "warpx.pml_fused_damping requires warpx.do_dive_cleaning = 0, and no subcycling.");
 
         pp.query("plot_raw_fields", plot_raw_fields);
         pp.query("plot_raw_fields_guards", plot_raw_fields_guards);
@@ -415,6 +478,17 @@ WarpX::ReadParameters ()
 	pp.query("charge_deposition", charge_deposition_algo);
 	pp.query("field_gathering", field_gathering_algo);
 	pp.query("particle_pusher", particle_pusher_algo);
+        int use_native_kernels = 0;
+        pp.query("use_native_kernels", use_native_kernels);
+        ParticleKernels::Select(use_native_kernels, nox, noy, noz, current_deposition_algo);
+        int use_native_pusher = 0;
+        std::string pusher_isa = "auto";
+        pp.query("use_native_pusher", use_native_pusher);
+        pp.query("pusher_isa", pusher_isa);
+        ParticleKernels::SelectPusher(use_native_pusher, pusher_isa);
+        if (use_native_pusher) {
+            amrex::Print() << "Native particle pusher: " << ParticleKernels::PusherName() << "\n";
+        }
 	std::string s_solver = "";
 	pp.query("maxwell_fdtd_solver", s_solver);
     std::transform(s_solver.begin(),
@@ -433,6 +507,9 @@ WarpX::ReadParameters ()
             amrex::Abort("Unknown FDTD Solver type " + s_solver);
         }
       }
+        int use_native_field_solver = 0;
+        pp.query("use_native_field_solver", use_native_field_solver);
+        FieldKernels::Select(use_native_field_solver, maxwell_fdtd_solver_id);
     }
 
 #ifdef WARPX_USE_PSATD
@@ -475,6 +552,8 @@ WarpX::MakeNewLevelFromScratch (int lev, Real time, const BoxArray& new_grids,
 void
 WarpX::ClearLevel (int lev)
 {
+    aux_is_current = false;
+
     for (int i = 0; i < 3; ++i) {
 	Efield_aux[lev][i].reset();
 	Bfield_aux[lev][i].reset();
@@ -491,10 +570,25 @@ WarpX::ClearLevel (int lev)
 
 	Efield_cax[lev][i].reset();
 	Bfield_cax[lev][i].reset();
+        Efield_cdiff[lev][i].reset();
+        Bfield_cdiff[lev][i].reset();
         current_buf[lev][i].reset();
+        current_fp_filtered[lev][i].reset();
+        current_cp_filtered[lev][i].reset();
+        current_buf_filtered[lev][i].reset();
+        current_from_fine[lev][i].reset();
+
+        Efield_aux_nci[lev][i].reset();
+        Bfield_aux_nci[lev][i].reset();
+        Efield_cax_nci[lev][i].reset();
+        Bfield_cax_nci[lev][i].reset();
     }
 
     charge_buf[lev].reset();
+    rho_fp_filtered[lev].reset();
+    rho_cp_filtered[lev].reset();
+    charge_buf_filtered[lev].reset();
+    rho_from_fine[lev].reset();
 
     current_buffer_masks[lev].reset();
     gather_buffer_masks[lev].reset();
@@ -575,6 +669,14 @@ WarpX::AllocLevelData (int lev, const BoxArray& ba, const DistributionMapping& d
         ngJz = std::max(ngJz,2);
     }
 
+    // With warpx.fdtd_temporal_blocking, B is pushed to n+1/2 two cells into the guard
+    // cells, from E one cell further (single level, so the number need not be even).
+    if (fdtd_temporal_blocking) {
+        ngx = std::max(ngx,3);
+        ngy = std::max(ngy,3);
+        ngz = std::max(ngz,3);
+    }
+
 #if (AMREX_SPACEDIM == 3)
     IntVect ngE(ngx,ngy,ngz);
     IntVect ngJ(ngJx,ngJy,ngJz);
@@ -583,6 +685,18 @@ WarpX::AllocLevelData (int lev, const BoxArray& ba, const DistributionMapping& d
     IntVect ngJ(ngJx,ngJz);
 #endif
 
+    // With warpx.deep_halo_steps = k, the first step after an exchange uses three
+    // guard cells and the next ones two (B^{n+1/2}, E^{n+1} and B^{n+1} are each
+    // computed one cell less deep than the fields they are computed from, and B^{n+1}
+    // becomes B^{n} of the next step), so that k steps leave the guard cells that the
+    // particles gather from valid with 2k-1 more cells.
+    if (deep_halo_steps > 0) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!warpx_use_fdtd_nci_corr(),
+            "warpx.deep_halo_steps does not work with the NCI corrector.");
+        deep_halo_min_depth = ngE;
+        ngE += 2*deep_halo_steps-1;
+    }
+
     IntVect ngRho = ngJ+1; //One extra ghost cell, so that it's safe to deposit charge density
                            // after pushing particle.
 
@@ -613,7 +727,8 @@ WarpX::AllocLevelData (int lev, const BoxArray& ba, const DistributionMapping& d
     current_fp[lev][1].reset( new MultiFab(amrex::convert(ba,jy_nodal_flag),dm,1,ngJ));
     current_fp[lev][2].reset( new MultiFab(amrex::convert(ba,jz_nodal_flag),dm,1,ngJ));
 
-    if (do_subcycling == 1 && lev == 0) {
+    // The current deposited by the particles of lev, kept during the steps of lev+1
+    if (do_subcycling == 1 && lev < maxLevel()) {
         current_store[lev][0].reset( new MultiFab(amrex::convert(ba,jx_nodal_flag),dm,1,ngJ));
         current_store[lev][1].reset( new MultiFab(amrex::convert(ba,jy_nodal_flag),dm,1,ngJ));
         current_store[lev][2].reset( new MultiFab(amrex::convert(ba,jz_nodal_flag),dm,1,ngJ));
@@ -730,6 +845,41 @@ WarpX::AllocLevelData (int lev, const BoxArray& ba, const DistributionMapping& d
         }
     }
 
+    //
+    // NCI-filtered copies of the aux fields
+    //
+    if (mypc->Nci_corr_once_per_step())
+    {
+        // The filter reads nstencilz_fdtd_nci_corr-1 cells on each side in z,
+        // so the filtered fields have that many fewer ghost cells than the aux fields.
+        IntVect ngNCI = ngE;
+        ngNCI[AMREX_SPACEDIM-1] -= (mypc->nstencilz_fdtd_nci_corr-1);
+
+        Efield_aux_nci[lev][0].reset( new MultiFab(amrex::convert(ba,Ex_nodal_flag),dm,1,ngNCI));
+        Efield_aux_nci[lev][2].reset( new MultiFab(amrex::convert(ba,Ez_nodal_flag),dm,1,ngNCI));
+        Bfield_aux_nci[lev][1].reset( new MultiFab(amrex::convert(ba,By_nodal_flag),dm,1,ngNCI));
+#if (AMREX_SPACEDIM == 3)
+        Efield_aux_nci[lev][1].reset( new MultiFab(amrex::convert(ba,Ey_nodal_flag),dm,1,ngNCI));
+        Bfield_aux_nci[lev][0].reset( new MultiFab(amrex::convert(ba,Bx_nodal_flag),dm,1,ngNCI));
+        Bfield_aux_nci[lev][2].reset( new MultiFab(amrex::convert(ba,Bz_nodal_flag),dm,1,ngNCI));
+#endif
+
+        if (Efield_cax[lev][0])
+        {
+            BoxArray cba = ba;
+            cba.coarsen(refRatio(lev-1));
+
+            Efield_cax_nci[lev][0].reset( new MultiFab(amrex::convert(cba,Ex_nodal_flag),dm,1,ngNCI));
+            Efield_cax_nci[lev][2].reset( new MultiFab(amrex::convert(cba,Ez_nodal_flag),dm,1,ngNCI));
+            Bfield_cax_nci[lev][1].reset( new MultiFab(amrex::convert(cba,By_nodal_flag),dm,1,ngNCI));
+#if (AMREX_SPACEDIM == 3)
+            Efield_cax_nci[lev][1].reset( new MultiFab(amrex::convert(cba,Ey_nodal_flag),dm,1,ngNCI));
+            Bfield_cax_nci[lev][0].reset( new MultiFab(amrex::convert(cba,Bx_nodal_flag),dm,1,ngNCI));
+            Bfield_cax_nci[lev][2].reset( new MultiFab(amrex::convert(cba,Bz_nodal_flag),dm,1,ngNCI));
+#endif
+        }
+    }
+
     if (load_balance_int > 0) {
         costs[lev].reset(new MultiFab(ba, dm, 1, 0));
     }
@@ -854,6 +1004,40 @@ WarpX::applyFilter (MultiFab& dstmf, const MultiFab& srcmf, int scomp, int dcomp
     }
 }
 
+void
+WarpX::applyFilter (const Vector<MultiFab*>& dstmfs, const Vector<const MultiFab*>& srcmfs,
+                    int scomp, int ncomp)
+{
+    BL_ASSERT(dstmfs.size() == srcmfs.size());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        FArrayBox tmpfab;
+        for (int imf = 0; imf < dstmfs.size(); ++imf)
+        {
+            const MultiFab& srcmf = *srcmfs[imf];
+            MultiFab& dstmf = *dstmfs[imf];
+            const int nc = std::min(ncomp, srcmf.nComp());
+            for (MFIter mfi(dstmf,true); mfi.isValid(); ++mfi)
+            {
+                const auto& srcfab = srcmf[mfi];
+                auto& dstfab = dstmf[mfi];
+                const Box& tbx = mfi.growntilebox();
+                const Box& gbx = amrex::grow(tbx,1);
+                tmpfab.resize(gbx,nc);
+                tmpfab.setVal(0.0, gbx, 0, nc);
+                const Box& ibx = gbx & srcfab.box();
+                tmpfab.copy(srcfab, ibx, scomp, ibx, 0, nc);
+                WRPX_FILTER(BL_TO_FORTRAN_BOX(tbx),
+                            BL_TO_FORTRAN_ANYD(tmpfab),
+                            BL_TO_FORTRAN_ANYD(dstfab),
+                            nc);
+            }
+        }
+    }
+}
+
 void
 WarpX::BuildBufferMasks ()
 {
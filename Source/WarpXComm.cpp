@@ -9,6 +9,23 @@
 
 using namespace amrex;
 
+namespace
+{
+    // Work space with the boxes of mf, ncomp components and ng guard cells, allocated
+    // on first use and again when mf changes (regrid or load balance)
+    MultiFab&
+    GetScratch (std::unique_ptr<MultiFab>& scratch, const MultiFab& mf, int ncomp, const IntVect& ng)
+    {
+        if (scratch == nullptr || scratch->boxArray() != mf.boxArray() ||
+            scratch->DistributionMap() != mf.DistributionMap() ||
+            scratch->nComp() != ncomp || scratch->nGrowVect() != ng)
+        {
+            scratch.reset(new MultiFab(mf.boxArray(), mf.DistributionMap(), ncomp, ng));
+        }
+        return *scratch;
+    }
+}
+
 void
 WarpX::ExchangeWithPmlB (int lev)
 {
@@ -49,6 +66,9 @@ WarpX::UpdateAuxilaryData ()
 {
     BL_PROFILE("UpdateAuxilaryData()");
 
+    // Nothing was pushed since the aux fields were last computed
+    if (aux_is_current) return;
+
     const int use_limiter = 0;
 
     for (int lev = 1; lev <= finest_level; ++lev)
@@ -57,43 +77,63 @@ WarpX::UpdateAuxilaryData ()
         const IntVect& ng = Bfield_cp[lev][0]->nGrowVect();
         const DistributionMapping& dm = Bfield_cp[lev][0]->DistributionMap();
 
-        // B field
-        {
-            MultiFab dBx(Bfield_cp[lev][0]->boxArray(), dm, 1, ng);
-            MultiFab dBy(Bfield_cp[lev][1]->boxArray(), dm, 1, ng);
-            MultiFab dBz(Bfield_cp[lev][2]->boxArray(), dm, 1, ng);
-            dBx.setVal(0.0);
-            dBy.setVal(0.0);
-            dBz.setVal(0.0);
-            dBx.ParallelCopy(*Bfield_aux[lev-1][0], 0, 0, 1, ng, ng, crse_period);
-            dBy.ParallelCopy(*Bfield_aux[lev-1][1], 0, 0, 1, ng, ng, crse_period);
-            dBz.ParallelCopy(*Bfield_aux[lev-1][2], 0, 0, 1, ng, ng, crse_period);
-            if (Bfield_cax[lev][0])
-            {
-                MultiFab::Copy(*Bfield_cax[lev][0], dBx, 0, 0, 1, ng);
-                MultiFab::Copy(*Bfield_cax[lev][1], dBy, 0, 0, 1, ng);
-                MultiFab::Copy(*Bfield_cax[lev][2], dBz, 0, 0, 1, ng);
+        // Allocated on first use, and again after a regrid or a load balance
+        if (Bfield_cdiff[lev][0] == nullptr ||
+            Bfield_cdiff[lev][0]->boxArray() != Bfield_cp[lev][0]->boxArray() ||
+            Bfield_cdiff[lev][0]->DistributionMap() != dm)
+        {
+            for (int idim = 0; idim < 3; ++idim) {
+                Bfield_cdiff[lev][idim].reset(new MultiFab(Bfield_cp[lev][idim]->boxArray(), dm, 1, ng));
+                Efield_cdiff[lev][idim].reset(new MultiFab(Efield_cp[lev][idim]->boxArray(), dm, 1, ng));
             }
-            MultiFab::Subtract(dBx, *Bfield_cp[lev][0], 0, 0, 1, ng);
-            MultiFab::Subtract(dBy, *Bfield_cp[lev][1], 0, 0, 1, ng);
-            MultiFab::Subtract(dBz, *Bfield_cp[lev][2], 0, 0, 1, ng);
+        }
+
+        // Coarse aux fields on the coarse patch. Since the MultiFabs keep their
+        // layout, AMReX reuses the communication pattern of the ParallelCopy.
+        for (int idim = 0; idim < 3; ++idim)
+        {
+            Bfield_cdiff[lev][idim]->setVal(0.0);
+            Efield_cdiff[lev][idim]->setVal(0.0);
+            Bfield_cdiff[lev][idim]->ParallelCopy(*Bfield_aux[lev-1][idim], 0, 0, 1, ng, ng, crse_period);
+            Efield_cdiff[lev][idim]->ParallelCopy(*Efield_aux[lev-1][idim], 0, 0, 1, ng, ng, crse_period);
+        }
 
-            const Real* dx = Geom(lev-1).CellSize();
-            const int ref_ratio = refRatio(lev-1)[0];
+        const Real* dx = Geom(lev-1).CellSize();
+        const int ref_ratio = refRatio(lev-1)[0];
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
+        {
+            std::array<FArrayBox,3> bfab;
+            std::array<FArrayBox,3> efab;
+            for (MFIter mfi(*Bfield_aux[lev][0]); mfi.isValid(); ++mfi)
             {
-                std::array<FArrayBox,3> bfab;
-                for (MFIter mfi(*Bfield_aux[lev][0]); mfi.isValid(); ++mfi)
+                Box ccbx = mfi.fabbox();
+                ccbx.enclosedCells();
+                ccbx.coarsen(ref_ratio).refine(ref_ratio); // so that ccbx is coarsenable
+
+                // Keep a copy of the coarse aux fields, and subtract the coarse patch
+                for (int idim = 0; idim < 3; ++idim)
                 {
-                    Box ccbx = mfi.fabbox();
-                    ccbx.enclosedCells();
-                    ccbx.coarsen(ref_ratio).refine(ref_ratio); // so that ccbx is coarsenable
+                    FArrayBox& dbfab = (*Bfield_cdiff[lev][idim])[mfi];
+                    FArrayBox& defab = (*Efield_cdiff[lev][idim])[mfi];
+                    const Box& bbx = dbfab.box();
+                    const Box& ebx = defab.box();
+                    if (Bfield_cax[lev][idim]) {
+                        (*Bfield_cax[lev][idim])[mfi].copy(dbfab, bbx, 0, bbx, 0, 1);
+                    }
+                    if (Efield_cax[lev][idim]) {
+                        (*Efield_cax[lev][idim])[mfi].copy(defab, ebx, 0, ebx, 0, 1);
+                    }
+                    dbfab.minus((*Bfield_cp[lev][idim])[mfi], bbx, 0, 0, 1);
+                    defab.minus((*Efield_cp[lev][idim])[mfi], ebx, 0, 0, 1);
+                }
 
-                    const FArrayBox& cxfab = dBx[mfi];
-                    const FArrayBox& cyfab = dBy[mfi];
-                    const FArrayBox& czfab = dBz[mfi];
+                // B field
+                {
+                    const FArrayBox& cxfab = (*Bfield_cdiff[lev][0])[mfi];
+                    const FArrayBox& cyfab = (*Bfield_cdiff[lev][1])[mfi];
+                    const FArrayBox& czfab = (*Bfield_cdiff[lev][2])[mfi];
                     bfab[0].resize(amrex::convert(ccbx,Bx_nodal_flag));
                     bfab[1].resize(amrex::convert(ccbx,By_nodal_flag));
                     bfab[2].resize(amrex::convert(ccbx,Bz_nodal_flag));
@@ -129,45 +169,12 @@ WarpX::UpdateAuxilaryData ()
                         aux.plus(bfab[idim], bx, bx, 0, 0, 1);
                     }
                 }
-            }
-        }
 
-        // E field
-        {
-            MultiFab dEx(Efield_cp[lev][0]->boxArray(), dm, 1, ng);
-            MultiFab dEy(Efield_cp[lev][1]->boxArray(), dm, 1, ng);
-            MultiFab dEz(Efield_cp[lev][2]->boxArray(), dm, 1, ng);
-            dEx.setVal(0.0);
-            dEy.setVal(0.0);
-            dEz.setVal(0.0);
-            dEx.ParallelCopy(*Efield_aux[lev-1][0], 0, 0, 1, ng, ng, crse_period);
-            dEy.ParallelCopy(*Efield_aux[lev-1][1], 0, 0, 1, ng, ng, crse_period);
-            dEz.ParallelCopy(*Efield_aux[lev-1][2], 0, 0, 1, ng, ng, crse_period);
-            if (Efield_cax[lev][0])
-            {
-                MultiFab::Copy(*Efield_cax[lev][0], dEx, 0, 0, 1, ng);
-                MultiFab::Copy(*Efield_cax[lev][1], dEy, 0, 0, 1, ng);
-                MultiFab::Copy(*Efield_cax[lev][2], dEz, 0, 0, 1, ng);
-            }
-            MultiFab::Subtract(dEx, *Efield_cp[lev][0], 0, 0, 1, ng);
-            MultiFab::Subtract(dEy, *Efield_cp[lev][1], 0, 0, 1, ng);
-            MultiFab::Subtract(dEz, *Efield_cp[lev][2], 0, 0, 1, ng);
-
-            const int ref_ratio = refRatio(lev-1)[0];
-#ifdef _OPEMP
-#pragma omp parallel
-#endif
-            {
-                std::array<FArrayBox,3> efab;
-                for (MFIter mfi(*Efield_aux[lev][0]); mfi.isValid(); ++mfi)
+                // E field
                 {
-                    Box ccbx = mfi.fabbox();
-                    ccbx.enclosedCells();
-                    ccbx.coarsen(ref_ratio).refine(ref_ratio); // so that ccbx is coarsenable
-
-                    const FArrayBox& cxfab = dEx[mfi];
-                    const FArrayBox& cyfab = dEy[mfi];
-                    const FArrayBox& czfab = dEz[mfi];
+                    const FArrayBox& cxfab = (*Efield_cdiff[lev][0])[mfi];
+                    const FArrayBox& cyfab = (*Efield_cdiff[lev][1])[mfi];
+                    const FArrayBox& czfab = (*Efield_cdiff[lev][2])[mfi];
                     efab[0].resize(amrex::convert(ccbx,Ex_nodal_flag));
                     efab[1].resize(amrex::convert(ccbx,Ey_nodal_flag));
                     efab[2].resize(amrex::convert(ccbx,Ez_nodal_flag));
@@ -206,6 +213,140 @@ WarpX::UpdateAuxilaryData ()
             }
         }
     }
+
+    aux_is_current = true;
+}
+
+void
+WarpX::FilterAuxFieldsNCI ()
+{
+    if (!mypc->Nci_corr_once_per_step()) return;
+
+    BL_PROFILE("WarpX::FilterAuxFieldsNCI()");
+
+    Real wt = amrex::second();
+
+    const int nstencilz_fdtd_nci_corr = mypc->nstencilz_fdtd_nci_corr;
+
+    // Filter the components of src that have a filtered copy in dst
+    // (Ex, Ey, Bz with the Ex stencil and Ez, Bx, By with the By stencil)
+    auto filter = [&] (const std::array<std::unique_ptr<MultiFab>, 3>& Esrc,
+                       const std::array<std::unique_ptr<MultiFab>, 3>& Bsrc,
+                       const std::array<std::unique_ptr<MultiFab>, 3>& Edst,
+                       const std::array<std::unique_ptr<MultiFab>, 3>& Bdst,
+                       const Real* stencilz_ex, const Real* stencilz_by)
+    {
+        const std::array<const MultiFab*, 6> src
+            {Esrc[0].get(), Esrc[1].get(), Esrc[2].get(), Bsrc[0].get(), Bsrc[1].get(), Bsrc[2].get()};
+        const std::array<MultiFab*, 6> dst
+            {Edst[0].get(), Edst[1].get(), Edst[2].get(), Bdst[0].get(), Bdst[1].get(), Bdst[2].get()};
+        const std::array<const Real*, 6> stencil
+            {stencilz_ex, stencilz_ex, stencilz_by, stencilz_by, stencilz_by, stencilz_ex};
+
+        for (int icomp = 0; icomp < 6; ++icomp)
+        {
+            if (dst[icomp] == nullptr) continue;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+            for (MFIter mfi(*dst[icomp], true); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.growntilebox();
+                WRPX_PXR_GODFREY_FILTER(BL_TO_FORTRAN_BOX(bx),
+                                        BL_TO_FORTRAN_ANYD((*dst[icomp])[mfi]),
+                                        BL_TO_FORTRAN_ANYD((*src[icomp])[mfi]),
+                                        stencil[icomp],
+                                        &nstencilz_fdtd_nci_corr);
+            }
+        }
+    };
+
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        filter(Efield_aux[lev], Bfield_aux[lev], Efield_aux_nci[lev], Bfield_aux_nci[lev],
+               mypc->fdtd_nci_stencilz_ex[lev].data(), mypc->fdtd_nci_stencilz_by[lev].data());
+
+        if (lev > 0 && Efield_cax[lev][0])
+        {
+            filter(Efield_cax[lev], Bfield_cax[lev], Efield_cax_nci[lev], Bfield_cax_nci[lev],
+                   mypc->fdtd_nci_stencilz_ex[lev-1].data(), mypc->fdtd_nci_stencilz_by[lev-1].data());
+        }
+    }
+
+    nci_filter_time += amrex::second() - wt;
+}
+
+void
+WarpX::ReportNCIFilterCost () const
+{
+    if (!mypc->Nci_corr_once_per_step()) return;
+
+    long nbytes = 0;
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        for (const auto* nci : {&Efield_aux_nci, &Bfield_aux_nci, &Efield_cax_nci, &Bfield_cax_nci})
+        {
+            for (const auto& mf : (*nci)[lev])
+            {
+                if (mf == nullptr) continue;
+                for (MFIter mfi(*mf); mfi.isValid(); ++mfi) {
+                    nbytes += (*mf)[mfi].nBytes();
+                }
+            }
+        }
+    }
+    ParallelDescriptor::ReduceLongSum(nbytes);
+
+    Real t = nci_filter_time;
+    ParallelDescriptor::ReduceRealMax(t);
+
+    amrex::Print() << "NCI corrector: the filtered fields take " << nbytes/(1024.*1024.)
+                   << " MB; " << t << " s were spent filtering them\n";
+}
+
+void
+WarpX::FillBoundaryDeepHalo ()
+{
+    // The particles gather from deep_halo_min_depth guard cells, and the next step
+    // pushes B^{n+1} two cells less deep than B^{n+1/2} (see EvolveFieldsDeepHalo)
+    const IntVect& ngB1 = amrex::min(deep_halo_depth_B, deep_halo_depth_E - 1);
+    if (deep_halo_depth_E.allGE(deep_halo_min_depth) &&
+        deep_halo_depth_B.allGE(deep_halo_min_depth) && ngB1.min() >= 2)
+    {
+        ++deep_halo_exchanges_skipped;
+        return;
+    }
+
+    Real wt = amrex::second();
+    FillBoundaryE();
+    FillBoundaryB();
+    deep_halo_exchange_time += amrex::second() - wt;
+    ++deep_halo_exchanges;
+}
+
+void
+WarpX::ReportDeepHaloCost () const
+{
+    if (deep_halo_steps == 0) return;
+
+    long ncells[2] = {deep_halo_cells_valid, deep_halo_cells_redundant};
+    ParallelDescriptor::ReduceLongSum(ncells, 2);
+
+    Real t[3] = {deep_halo_exchange_time, deep_halo_current_time, deep_halo_push_time};
+    ParallelDescriptor::ReduceRealMax(t, 3);
+
+    // The time saved is estimated from the average time of the exchanges done, and
+    // the time of the redundant updates from their share of the cells pushed
+    const Real t_exchange = (deep_halo_exchanges > 0) ? t[0]/deep_halo_exchanges : 0.0;
+    const long ntot = ncells[0] + ncells[1];
+    const Real redundant = (ntot > 0) ? static_cast<Real>(ncells[1])/ntot : 0.0;
+
+    amrex::Print() << "Deep halo: E and B exchanged " << deep_halo_exchanges << " times, "
+                   << deep_halo_exchanges_skipped << " exchanges skipped ("
+                   << t_exchange*deep_halo_exchanges_skipped << " s saved); "
+                   << 100.*redundant << "% of the field updates were redundant ("
+                   << redundant*t[2] << " s); " << t[1]
+                   << " s were spent filling the guard cells of the current\n";
 }
 
 void
@@ -253,13 +394,28 @@ WarpX::FillBoundaryE (int lev, PatchType patch_type)
 	              		      { Efield_fp[lev][0].get(),
                                 Efield_fp[lev][1].get(),
                                 Efield_fp[lev][2].get() });
-    	    pml[lev]->FillBoundaryE(patch_type);
+    	    if (!batch_fill_boundary) pml[lev]->FillBoundaryE(patch_type);
         }
 
         const auto& period = Geom(lev).periodicity();
-        (*Efield_fp[lev][0]).FillBoundary(period);
-        (*Efield_fp[lev][1]).FillBoundary(period);
-        (*Efield_fp[lev][2]).FillBoundary(period);
+        if (batch_fill_boundary)
+        {
+            Vector<MultiFab*> mfs { Efield_fp[lev][0].get(),
+                                    Efield_fp[lev][1].get(),
+                                    Efield_fp[lev][2].get() };
+            if (do_pml && pml[lev]->ok()) {
+                for (auto mf : pml[lev]->GetE_fp()) mfs.push_back(mf);
+            }
+            FillBoundaryBatched(fill_boundary_E[lev][0], mfs, period);
+        }
+        else
+        {
+            (*Efield_fp[lev][0]).FillBoundary(period);
+            (*Efield_fp[lev][1]).FillBoundary(period);
+            (*Efield_fp[lev][2]).FillBoundary(period);
+        }
+        // All the guard cells are valid again (see warpx.deep_halo_steps)
+        if (lev == 0) deep_halo_depth_E = Efield_fp[lev][0]->nGrowVect();
     }
     else if (patch_type == PatchType::coarse)
     {
@@ -269,13 +425,26 @@ WarpX::FillBoundaryE (int lev, PatchType patch_type)
 			                { Efield_cp[lev][0].get(),
                               Efield_cp[lev][1].get(),
                               Efield_cp[lev][2].get() });
-        pml[lev]->FillBoundaryE(patch_type);
+        if (!batch_fill_boundary) pml[lev]->FillBoundaryE(patch_type);
         }
 
         const auto& cperiod = Geom(lev-1).periodicity();
-        (*Efield_cp[lev][0]).FillBoundary(cperiod);
-        (*Efield_cp[lev][1]).FillBoundary(cperiod);
-        (*Efield_cp[lev][2]).FillBoundary(cperiod);
+        if (batch_fill_boundary)
+        {
+            Vector<MultiFab*> mfs { Efield_cp[lev][0].get(),
+                                    Efield_cp[lev][1].get(),
+                                    Efield_cp[lev][2].get() };
+            if (do_pml && pml[lev]->ok()) {
+                for (auto mf : pml[lev]->GetE_cp()) mfs.push_back(mf);
+            }
+            FillBoundaryBatched(fill_boundary_E[lev][1], mfs, cperiod);
+        }
+        else
+        {
+            (*Efield_cp[lev][0]).FillBoundary(cperiod);
+            (*Efield_cp[lev][1]).FillBoundary(cperiod);
+            (*Efield_cp[lev][2]).FillBoundary(cperiod);
+        }
     }
 }
 
@@ -297,12 +466,27 @@ WarpX::FillBoundaryB (int lev, PatchType patch_type)
         			        { Bfield_fp[lev][0].get(),
                               Bfield_fp[lev][1].get(),
                               Bfield_fp[lev][2].get() });
-        pml[lev]->FillBoundaryB(patch_type);
+        if (!batch_fill_boundary) pml[lev]->FillBoundaryB(patch_type);
         }
         const auto& period = Geom(lev).periodicity();
-        (*Bfield_fp[lev][0]).FillBoundary(period);
-        (*Bfield_fp[lev][1]).FillBoundary(period);
-        (*Bfield_fp[lev][2]).FillBoundary(period);
+        if (batch_fill_boundary)
+        {
+            Vector<MultiFab*> mfs { Bfield_fp[lev][0].get(),
+                                    Bfield_fp[lev][1].get(),
+                                    Bfield_fp[lev][2].get() };
+            if (do_pml && pml[lev]->ok()) {
+                for (auto mf : pml[lev]->GetB_fp()) mfs.push_back(mf);
+            }
+            FillBoundaryBatched(fill_boundary_B[lev][0], mfs, period);
+        }
+        else
+        {
+            (*Bfield_fp[lev][0]).FillBoundary(period);
+            (*Bfield_fp[lev][1]).FillBoundary(period);
+            (*Bfield_fp[lev][2]).FillBoundary(period);
+        }
+        // All the guard cells are valid again (see warpx.deep_halo_steps)
+        if (lev == 0) deep_halo_depth_B = Bfield_fp[lev][0]->nGrowVect();
     }
     else if (patch_type == PatchType::coarse)
     {
@@ -312,12 +496,25 @@ WarpX::FillBoundaryB (int lev, PatchType patch_type)
 			                { Bfield_cp[lev][0].get(),
 			                  Bfield_cp[lev][1].get(),
 			                  Bfield_cp[lev][2].get() });
-        pml[lev]->FillBoundaryB(patch_type);
+        if (!batch_fill_boundary) pml[lev]->FillBoundaryB(patch_type);
         }
         const auto& cperiod = Geom(lev-1).periodicity();
-        (*Bfield_cp[lev][0]).FillBoundary(cperiod);
-        (*Bfield_cp[lev][1]).FillBoundary(cperiod);
-        (*Bfield_cp[lev][2]).FillBoundary(cperiod);
+        if (batch_fill_boundary)
+        {
+            Vector<MultiFab*> mfs { Bfield_cp[lev][0].get(),
+                                    Bfield_cp[lev][1].get(),
+                                    Bfield_cp[lev][2].get() };
+            if (do_pml && pml[lev]->ok()) {
+                for (auto mf : pml[lev]->GetB_cp()) mfs.push_back(mf);
+            }
+            FillBoundaryBatched(fill_boundary_B[lev][1], mfs, cperiod);
+        }
+        else
+        {
+            (*Bfield_cp[lev][0]).FillBoundary(cperiod);
+            (*Bfield_cp[lev][1]).FillBoundary(cperiod);
+            (*Bfield_cp[lev][2]).FillBoundary(cperiod);
+        }
     }
 }
 
@@ -336,23 +533,143 @@ WarpX::FillBoundaryF (int lev, PatchType patch_type)
         if (do_pml && pml[lev]->ok())
         {
             pml[lev]->ExchangeF(patch_type, F_fp[lev].get());
-            pml[lev]->FillBoundaryF(patch_type);
+            if (!batch_fill_boundary) pml[lev]->FillBoundaryF(patch_type);
         }
 
         const auto& period = Geom(lev).periodicity();
-        F_fp[lev]->FillBoundary(period);
+        if (batch_fill_boundary)
+        {
+            Vector<MultiFab*> mfs { F_fp[lev].get() };
+            if (do_pml && pml[lev]->ok()) mfs.push_back(pml[lev]->GetF_fp());
+            FillBoundaryBatched(fill_boundary_F[lev][0], mfs, period);
+        }
+        else
+        {
+            F_fp[lev]->FillBoundary(period);
+        }
     }
     else if (patch_type == PatchType::coarse && F_cp[lev])
     {
         if (do_pml && pml[lev]->ok())
         {
         pml[lev]->ExchangeF(patch_type, F_cp[lev].get());
-        pml[lev]->FillBoundaryF(patch_type);
+        if (!batch_fill_boundary) pml[lev]->FillBoundaryF(patch_type);
         }
 
         const auto& cperiod = Geom(lev-1).periodicity();
-        F_cp[lev]->FillBoundary(cperiod);
+        if (batch_fill_boundary)
+        {
+            Vector<MultiFab*> mfs { F_cp[lev].get() };
+            if (do_pml && pml[lev]->ok()) mfs.push_back(pml[lev]->GetF_cp());
+            FillBoundaryBatched(fill_boundary_F[lev][1], mfs, cperiod);
+        }
+        else
+        {
+            F_cp[lev]->FillBoundary(cperiod);
+        }
+    }
+}
+
+void
+WarpX::FillBoundaryBatched (std::unique_ptr<BatchedFillBoundary>& fb,
+                            const Vector<MultiFab*>& mfs, const Periodicity& period)
+{
+    BL_PROFILE("FillBoundaryBatched()");
+
+    // The PML fields that are not allocated are skipped
+    Vector<MultiFab*> allocated;
+    for (auto mf : mfs) {
+        if (mf) allocated.push_back(mf);
+    }
+
+    if (!fb) fb.reset(new BatchedFillBoundary());
+    fb->FillBoundary(allocated, period);
+}
+
+void
+WarpX::SumBoundaryBatched (std::unique_ptr<NonblockingSumBoundary>& sb,
+                           const Vector<MultiFab*>& mfs, int scomp, int ncomp,
+                           const Periodicity& period)
+{
+    BL_PROFILE("SumBoundaryBatched()");
+
+    if (!sb) sb.reset(new NonblockingSumBoundary());
+    sb->SumBoundary(mfs, scomp, ncomp, period);
+}
+
+void
+WarpX::FillBoundaryEB_nowait ()
+{
+    BL_PROFILE("FillBoundaryEB_nowait()");
+
+    AMREX_ALWAYS_ASSERT(finest_level == 0 && !eb_exchange_in_progress);
+
+    const int lev = 0;
+    if (do_pml && pml[lev]->ok())
+    {
+        pml[lev]->ExchangeE(PatchType::fine,
+                            { Efield_fp[lev][0].get(),
+                              Efield_fp[lev][1].get(),
+                              Efield_fp[lev][2].get() });
+        pml[lev]->ExchangeB(PatchType::fine,
+                            { Bfield_fp[lev][0].get(),
+                              Bfield_fp[lev][1].get(),
+                              Bfield_fp[lev][2].get() });
+        if (!batch_fill_boundary) {
+            pml[lev]->FillBoundaryE(PatchType::fine);
+            pml[lev]->FillBoundaryB(PatchType::fine);
+        }
+    }
+
+    const auto& period = Geom(lev).periodicity();
+    if (batch_fill_boundary)
+    {
+        Vector<MultiFab*> mfs;
+        for (int idim = 0; idim < 3; ++idim) {
+            mfs.push_back(Efield_fp[lev][idim].get());
+            mfs.push_back(Bfield_fp[lev][idim].get());
+        }
+        if (do_pml && pml[lev]->ok())
+        {
+            for (auto mf : pml[lev]->GetE_fp()) {
+                if (mf) mfs.push_back(mf);
+            }
+            for (auto mf : pml[lev]->GetB_fp()) {
+                if (mf) mfs.push_back(mf);
+            }
+        }
+        fill_boundary_EB.Start(mfs, period);
+    }
+    else
+    {
+        for (int idim = 0; idim < 3; ++idim) {
+            Efield_fp[lev][idim]->FillBoundary_nowait(period);
+            Bfield_fp[lev][idim]->FillBoundary_nowait(period);
+        }
+    }
+    eb_exchange_in_progress = true;
+}
+
+void
+WarpX::FillBoundaryEB_finish ()
+{
+    BL_PROFILE("FillBoundaryEB_finish()");
+
+    if (!eb_exchange_in_progress) return;
+
+    if (batch_fill_boundary)
+    {
+        fill_boundary_EB.Finish();
     }
+    else
+    {
+        const int lev = 0;
+        for (int idim = 0; idim < 3; ++idim) {
+            Efield_fp[lev][idim]->FillBoundary_finish();
+            Bfield_fp[lev][idim]->FillBoundary_finish();
+        }
+    }
+    eb_exchange_in_progress = false;
 }
 
 void
@@ -378,31 +695,29 @@ WarpX::SyncCurrent ()
         SyncCurrent(fine, crse, ref_ratio[0]);
     }
 
-    Vector<Array<std::unique_ptr<MultiFab>,3> > j_fp(finest_level+1);
-    Vector<Array<std::unique_ptr<MultiFab>,3> > j_cp(finest_level+1);
-    Vector<Array<std::unique_ptr<MultiFab>,3> > j_buf(finest_level+1);
+    // The filtered currents, kept from one step to the next
+    auto& j_fp = current_fp_filtered;
+    auto& j_cp = current_cp_filtered;
+    auto& j_buf = current_buf_filtered;
 
     if (WarpX::use_filter) {
+        // All the patches are filtered in one pass
+        Vector<MultiFab*> dst;
+        Vector<const MultiFab*> src;
         for (int lev = 0; lev <= finest_level; ++lev) {
             IntVect ng = current_fp[lev][0]->nGrowVect();
             ng += 1;
             for (int idim = 0; idim < 3; ++idim) {
-                j_fp[lev][idim].reset(new MultiFab(current_fp[lev][idim]->boxArray(),
-                                                   current_fp[lev][idim]->DistributionMap(),
-                                                   1, ng));
-                applyFilter(*j_fp[lev][idim], *current_fp[lev][idim]);
-                std::swap(j_fp[lev][idim], current_fp[lev][idim]);
+                dst.push_back(&GetScratch(j_fp[lev][idim], *current_fp[lev][idim], 1, ng));
+                src.push_back(current_fp[lev][idim].get());
             }
         }
         for (int lev = 1; lev <= finest_level; ++lev) {
             IntVect ng = current_cp[lev][0]->nGrowVect();
             ng += 1;
             for (int idim = 0; idim < 3; ++idim) {
-                j_cp[lev][idim].reset(new MultiFab(current_cp[lev][idim]->boxArray(),
-                                                   current_cp[lev][idim]->DistributionMap(),
-                                                   1, ng));
-                applyFilter(*j_cp[lev][idim], *current_cp[lev][idim]);
-                std::swap(j_cp[lev][idim], current_cp[lev][idim]);
+                dst.push_back(&GetScratch(j_cp[lev][idim], *current_cp[lev][idim], 1, ng));
+                src.push_back(current_cp[lev][idim].get());
             }
         }
         for (int lev = 1; lev <= finest_level; ++lev) {
@@ -410,23 +725,32 @@ WarpX::SyncCurrent ()
                 IntVect ng = current_buf[lev][0]->nGrowVect();
                 ng += 1;
                 for (int idim = 0; idim < 3; ++idim) {
-                    j_buf[lev][idim].reset(new MultiFab(current_buf[lev][idim]->boxArray(),
-                                                        current_buf[lev][idim]->DistributionMap(),
-                                                        1, ng));
-                    applyFilter(*j_buf[lev][idim], *current_buf[lev][idim]);
-                    std::swap(*j_buf[lev][idim], *current_buf[lev][idim]);
+                    dst.push_back(&GetScratch(j_buf[lev][idim], *current_buf[lev][idim], 1, ng));
+                    src.push_back(current_buf[lev][idim].get());
                 }
             }
         }
+        applyFilter(dst, src);
+
+        for (int lev = 0; lev <= finest_level; ++lev) {
+            for (int idim = 0; idim < 3; ++idim) {
+                std::swap(j_fp[lev][idim], current_fp[lev][idim]);
+            }
+        }
+        for (int lev = 1; lev <= finest_level; ++lev) {
+            for (int idim = 0; idim < 3; ++idim) {
+                std::swap(j_cp[lev][idim], current_cp[lev][idim]);
+            }
+        }
     }
 
-    // Sum up fine patch
+    // Sum up fine patch, the three components in one exchange
     for (int lev = 0; lev <= finest_level; ++lev)
     {
         const auto& period = Geom(lev).periodicity();
-        current_fp[lev][0]->SumBoundary(period);
-        current_fp[lev][1]->SumBoundary(period);
-        current_fp[lev][2]->SumBoundary(period);
+        SumBoundaryBatched(sum_boundary_J[lev][0],
+                           {current_fp[lev][0].get(), current_fp[lev][1].get(),
+                            current_fp[lev][2].get()}, 0, 1, period);
     }
 
     // Add fine level's coarse patch to coarse level's fine patch
@@ -440,12 +764,15 @@ WarpX::SyncCurrent ()
         const MultiFab* ccz = current_cp[lev+1][2].get();
         if (current_buf[lev+1][0])
         {
-            MultiFab::Add(*current_buf[lev+1][0], *current_cp[lev+1][0], 0, 0, 1, ngsrc);
-            MultiFab::Add(*current_buf[lev+1][1], *current_cp[lev+1][1], 0, 0, 1, ngsrc);
-            MultiFab::Add(*current_buf[lev+1][2], *current_cp[lev+1][2], 0, 0, 1, ngsrc);
-            ccx = current_buf[lev+1][0].get();
-            ccy = current_buf[lev+1][1].get();
-            ccz = current_buf[lev+1][2].get();
+            // With the filter, the filtered buffers: we don't care about the final
+            // state of the current buffers.
+            auto& jbuf = (WarpX::use_filter) ? j_buf[lev+1] : current_buf[lev+1];
+            MultiFab::Add(*jbuf[0], *current_cp[lev+1][0], 0, 0, 1, ngsrc);
+            MultiFab::Add(*jbuf[1], *current_cp[lev+1][1], 0, 0, 1, ngsrc);
+            MultiFab::Add(*jbuf[2], *current_cp[lev+1][2], 0, 0, 1, ngsrc);
+            ccx = jbuf[0].get();
+            ccy = jbuf[1].get();
+            ccz = jbuf[2].get();
         }
         current_fp[lev][0]->copy(*ccx,0,0,1,ngsrc,ngdst,period,FabArrayBase::ADD);
         current_fp[lev][1]->copy(*ccy,0,0,1,ngsrc,ngdst,period,FabArrayBase::ADD);
@@ -456,9 +783,9 @@ WarpX::SyncCurrent ()
     for (int lev = 1; lev <= finest_level; ++lev)
     {
         const auto& cperiod = Geom(lev-1).periodicity();
-        current_cp[lev][0]->SumBoundary(cperiod);
-        current_cp[lev][1]->SumBoundary(cperiod);
-        current_cp[lev][2]->SumBoundary(cperiod);
+        SumBoundaryBatched(sum_boundary_J[lev][1],
+                           {current_cp[lev][0].get(), current_cp[lev][1].get(),
+                            current_cp[lev][2].get()}, 0, 1, cperiod);
     }
 
     if (WarpX::use_filter) {
@@ -476,15 +803,6 @@ WarpX::SyncCurrent ()
                 MultiFab::Copy(*current_cp[lev][idim], *j_cp[lev][idim], 0, 0, 1, 0);
             }
         }
-        for (int lev = 1; lev <= finest_level; ++lev)
-        {
-            for (int idim = 0; idim < 3; ++idim) {
-                if (j_buf[lev][idim]) {
-                    std::swap(j_buf[lev][idim], current_buf[lev][idim]);
-                    MultiFab::Copy(*current_buf[lev][idim], *j_buf[lev][idim], 0, 0, 1, 0);
-                }
-            }
-        }
     }
 
     // sync shared nodal edges
@@ -504,6 +822,31 @@ WarpX::SyncCurrent ()
     }
 }
 
+void
+WarpX::SyncCurrent_nowait ()
+{
+    BL_PROFILE("SyncCurrent_nowait()");
+
+    AMREX_ALWAYS_ASSERT(finest_level == 0 && !WarpX::use_filter);
+
+    current_sum.Start({ current_fp[0][0].get(), current_fp[0][1].get(), current_fp[0][2].get() },
+                      Geom(0).periodicity());
+}
+
+void
+WarpX::SyncCurrent_finish ()
+{
+    BL_PROFILE("SyncCurrent_finish()");
+
+    current_sum.Finish();
+
+    // sync shared nodal edges
+    const auto& period = Geom(0).periodicity();
+    current_fp[0][0]->OverrideSync(period);
+    current_fp[0][1]->OverrideSync(period);
+    current_fp[0][2]->OverrideSync(period);
+}
+
 /** \brief Fills the values of the current on the coarse patch by
  *  averaging the values of the current of the fine patch (on the same level).
  */
@@ -512,28 +855,39 @@ WarpX::SyncCurrent (const std::array<const amrex::MultiFab*,3>& fine,
                     const std::array<      amrex::MultiFab*,3>& crse,
                     int ref_ratio)
 {
-    BL_ASSERT(ref_ratio == 2);
     const IntVect& ng = (fine[0]->nGrowVect() + 1) /ref_ratio;
 
-#ifdef _OPEMP
+#ifdef _OPENMP
 #pragma omp parallel
 #endif
     {
         FArrayBox ffab;
         for (int idim = 0; idim < 3; ++idim)
         {
+            int stag[3] = {0, 0, 0};
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                stag[d] = crse[idim]->ixType().cellCentered(d);
+            }
             for (MFIter mfi(*crse[idim],true); mfi.isValid(); ++mfi)
             {
                 const Box& bx = mfi.growntilebox(ng);
-                Box fbx = amrex::grow(amrex::refine(bx,ref_ratio),1);
+                Box fbx = amrex::grow(amrex::refine(bx,ref_ratio),ref_ratio-1);
                 ffab.resize(fbx);
                 fbx &= (*fine[idim])[mfi].box();
                 ffab.setVal(0.0);
                 ffab.copy((*fine[idim])[mfi], fbx, 0, fbx, 0, 1);
-                WRPX_SYNC_CURRENT(bx.loVect(), bx.hiVect(),
-                                   BL_TO_FORTRAN_ANYD((*crse[idim])[mfi]),
-                                   BL_TO_FORTRAN_ANYD(ffab),
-                                   &idim);
+                if (ref_ratio == 2) {
+                    WRPX_SYNC_CURRENT(bx.loVect(), bx.hiVect(),
+                                       BL_TO_FORTRAN_ANYD((*crse[idim])[mfi]),
+                                       BL_TO_FORTRAN_ANYD(ffab),
+                                       &idim);
+                } else {
+                    const int ncomp = 1;
+                    warpx_sync_ratio(BL_TO_FORTRAN_BOX(bx),
+                                     BL_TO_FORTRAN_ANYD((*crse[idim])[mfi]),
+                                     BL_TO_FORTRAN_ANYD(ffab),
+                                     &ncomp, stag, &ref_ratio);
+                }
             }
         }
     }
@@ -553,50 +907,52 @@ WarpX::SyncRho (amrex::Vector<std::unique_ptr<amrex::MultiFab> >& rhof,
         SyncRho(*rhof[lev], *rhoc[lev], ref_ratio[0]);
     }
 
-    Vector<std::unique_ptr<MultiFab> > rho_f_g(finest_level+1);
-    Vector<std::unique_ptr<MultiFab> > rho_c_g(finest_level+1);
-    Vector<std::unique_ptr<MultiFab> > rho_buf_g(finest_level+1);
+    // The filtered charge densities, kept from one step to the next
+    auto& rho_f_g = rho_fp_filtered;
+    auto& rho_c_g = rho_cp_filtered;
+    auto& rho_buf_g = charge_buf_filtered;
 
     if (WarpX::use_filter) {
+        // All the patches are filtered in one pass
+        Vector<MultiFab*> dst;
+        Vector<const MultiFab*> src;
         for (int lev = 0; lev <= finest_level; ++lev) {
-            const int ncomp = rhof[lev]->nComp();
             IntVect ng = rhof[lev]->nGrowVect();
             ng += 1;
-            rho_f_g[lev].reset(new MultiFab(rhof[lev]->boxArray(),
-                                            rhof[lev]->DistributionMap(),
-                                            ncomp, ng));
-            applyFilter(*rho_f_g[lev], *rhof[lev]);
-            std::swap(rho_f_g[lev], rhof[lev]);
+            dst.push_back(&GetScratch(rho_f_g[lev], *rhof[lev], rhof[lev]->nComp(), ng));
+            src.push_back(rhof[lev].get());
         }
         for (int lev = 1; lev <= finest_level; ++lev) {
-            const int ncomp = rhoc[lev]->nComp();
             IntVect ng = rhoc[lev]->nGrowVect();
             ng += 1;
-            rho_c_g[lev].reset(new MultiFab(rhoc[lev]->boxArray(),
-                                            rhoc[lev]->DistributionMap(),
-                                            ncomp, ng));
-            applyFilter(*rho_c_g[lev], *rhoc[lev]);
-            std::swap(rho_c_g[lev], rhoc[lev]);
+            dst.push_back(&GetScratch(rho_c_g[lev], *rhoc[lev], rhoc[lev]->nComp(), ng));
+            src.push_back(rhoc[lev].get());
         }
         for (int lev = 1; lev <= finest_level; ++lev) {
             if (charge_buf[lev]) {
-                const int ncomp = charge_buf[lev]->nComp();
                 IntVect ng = charge_buf[lev]->nGrowVect();
                 ng += 1;
-                rho_buf_g[lev].reset(new MultiFab(charge_buf[lev]->boxArray(),
-                                                  charge_buf[lev]->DistributionMap(),
-                                                  ncomp, ng));
-                applyFilter(*rho_buf_g[lev], *charge_buf[lev]);
-                std::swap(*rho_buf_g[lev], *charge_buf[lev]);
+                dst.push_back(&GetScratch(rho_buf_g[lev], *charge_buf[lev], charge_buf[lev]->nComp(), ng));
+                src.push_back(charge_buf[lev].get());
             }
         }
+        applyFilter(dst, src);
+
+        for (int lev = 0; lev <= finest_level; ++lev) {
+            std::swap(rho_f_g[lev], rhof[lev]);
+        }
+        for (int lev = 1; lev <= finest_level; ++lev) {
+            std::swap(rho_c_g[lev], rhoc[lev]);
+        }
     }
 
-    // Sum up fine patch
+    // Sum up fine patch. The levels have their own periodicity, and the coarse patches
+    // are summed after they are added to the coarser level, so each patch is summed
+    // in its own exchange.
     for (int lev = 0; lev <= finest_level; ++lev)
     {
         const auto& period = Geom(lev).periodicity();
-        rhof[lev]->SumBoundary(period);
+        SumBoundaryBatched(sum_boundary_rho[lev][0], {rhof[lev].get()}, 0, -1, period);
     }
 
     // Add fine level's coarse patch to coarse level's fine patch
@@ -609,8 +965,10 @@ WarpX::SyncRho (amrex::Vector<std::unique_ptr<amrex::MultiFab> >& rhof,
         const MultiFab* crho = rhoc[lev+1].get();
         if (charge_buf[lev+1])
         {
-            MultiFab::Add(*charge_buf[lev+1], *rhoc[lev+1], 0, 0, ncomp, ngsrc);
-            crho = charge_buf[lev+1].get();
+            // With the filter, the filtered buffer
+            auto& rbuf = (WarpX::use_filter) ? rho_buf_g[lev+1] : charge_buf[lev+1];
+            MultiFab::Add(*rbuf, *rhoc[lev+1], 0, 0, ncomp, ngsrc);
+            crho = rbuf.get();
         }
 
         rhof[lev]->copy(*crho,0,0,ncomp,ngsrc,ngdst,period,FabArrayBase::ADD);
@@ -620,7 +978,7 @@ WarpX::SyncRho (amrex::Vector<std::unique_ptr<amrex::MultiFab> >& rhof,
     for (int lev = 1; lev <= finest_level; ++lev)
     {
         const auto& cperiod = Geom(lev-1).periodicity();
-        rhoc[lev]->SumBoundary(cperiod);
+        SumBoundaryBatched(sum_boundary_rho[lev][1], {rhoc[lev].get()}, 0, -1, cperiod);
     }
 
     if (WarpX::use_filter) {
@@ -632,13 +990,6 @@ WarpX::SyncRho (amrex::Vector<std::unique_ptr<amrex::MultiFab> >& rhof,
             std::swap(rho_c_g[lev], rhoc[lev]);
             MultiFab::Copy(*rhoc[lev], *rho_c_g[lev], 0, 0, rhoc[lev]->nComp(), 0);
         }
-        for (int lev = 1; lev <= finest_level; ++lev)
-        {
-            if (rho_buf_g[lev]) {
-                std::swap(rho_buf_g[lev], charge_buf[lev]);
-                MultiFab::Copy(*charge_buf[lev], *rho_buf_g[lev], 0, 0, rhoc[lev]->nComp(), 0);
-            }
-        }
     }
 
     // sync shared nodal points
@@ -660,11 +1011,11 @@ WarpX::SyncRho (amrex::Vector<std::unique_ptr<amrex::MultiFab> >& rhof,
 void
 WarpX::SyncRho (const MultiFab& fine, MultiFab& crse, int ref_ratio)
 {
-    BL_ASSERT(ref_ratio == 2);
     const IntVect& ng = (fine.nGrowVect()+1)/ref_ratio;
     const int nc = fine.nComp();
+    const int stag[3] = {0, 0, 0};
 
-#ifdef _OPEMP
+#ifdef _OPENMP
 #pragma omp parallel
 #endif
     {
@@ -672,15 +1023,22 @@ WarpX::SyncRho (const MultiFab& fine, MultiFab& crse, int ref_ratio)
         for (MFIter mfi(crse,true); mfi.isValid(); ++mfi)
         {
             const Box& bx = mfi.growntilebox(ng);
-            Box fbx = amrex::grow(amrex::refine(bx,ref_ratio),1);
+            Box fbx = amrex::grow(amrex::refine(bx,ref_ratio),ref_ratio-1);
             ffab.resize(fbx, nc);
             fbx &= fine[mfi].box();
             ffab.setVal(0.0);
             ffab.copy(fine[mfi], fbx, 0, fbx, 0, nc);
-            WRPX_SYNC_RHO(bx.loVect(), bx.hiVect(),
-                          BL_TO_FORTRAN_ANYD(crse[mfi]),
-                          BL_TO_FORTRAN_ANYD(ffab),
-                          &nc);
+            if (ref_ratio == 2) {
+                WRPX_SYNC_RHO(bx.loVect(), bx.hiVect(),
+                              BL_TO_FORTRAN_ANYD(crse[mfi]),
+                              BL_TO_FORTRAN_ANYD(ffab),
+                              &nc);
+            } else {
+                warpx_sync_ratio(BL_TO_FORTRAN_BOX(bx),
+                                 BL_TO_FORTRAN_ANYD(crse[mfi]),
+                                 BL_TO_FORTRAN_ANYD(ffab),
+                                 &nc, stag, &ref_ratio);
+            }
         }
     }
 }
@@ -712,17 +1070,23 @@ WarpX::ApplyFilterandSumBoundaryJ (int lev, PatchType patch_type)
     const int glev = (patch_type == PatchType::fine) ? lev : lev-1;
     const auto& period = Geom(glev).periodicity();
     auto& j = (patch_type == PatchType::fine) ? current_fp[lev] : current_cp[lev];
-    for (int idim = 0; idim < 3; ++idim) {
-        if (use_filter) {
+    auto& jf = (patch_type == PatchType::fine) ? current_fp_filtered[lev] : current_cp_filtered[lev];
+    auto& sb = sum_boundary_J[lev][(patch_type == PatchType::fine) ? 0 : 1];
+    if (use_filter) {
+        // The three components are filtered in one pass, and summed in one exchange
+        Vector<MultiFab*> dst;
+        for (int idim = 0; idim < 3; ++idim) {
             IntVect ng = j[idim]->nGrowVect();
             ng += 1;
-            MultiFab jf(j[idim]->boxArray(), j[idim]->DistributionMap(), 1, ng);
-            applyFilter(jf, *j[idim]);
-            jf.SumBoundary(period);
-            MultiFab::Copy(*j[idim], jf, 0, 0, 1, 0);
-        } else {
-            j[idim]->SumBoundary(period);
+            dst.push_back(&GetScratch(jf[idim], *j[idim], 1, ng));
         }
+        applyFilter(dst, {j[0].get(), j[1].get(), j[2].get()});
+        SumBoundaryBatched(sb, dst, 0, 1, period);
+        for (int idim = 0; idim < 3; ++idim) {
+            MultiFab::Copy(*j[idim], *dst[idim], 0, 0, 1, 0);
+        }
+    } else {
+        SumBoundaryBatched(sb, {j[0].get(), j[1].get(), j[2].get()}, 0, 1, period);
     }
 }
 
@@ -742,66 +1106,82 @@ WarpX::ApplyFilterandSumBoundaryJ (int lev, PatchType patch_type)
 void
 WarpX::AddCurrentFromFineLevelandSumBoundary (int lev)
 {
-    ApplyFilterandSumBoundaryJ(lev, PatchType::fine);
-
-    // When there are current buffers, unlike coarse patch,
-    // we don't care about the final state of them.
-
     const auto& period = Geom(lev).periodicity();
+
+    // The patches to sum, and the buffers: with the filter, their filtered copies
+    std::array<MultiFab*,3> jfp, jcp, jbuf;
     for (int idim = 0; idim < 3; ++idim) {
-        MultiFab mf(current_fp[lev][idim]->boxArray(),
-                    current_fp[lev][idim]->DistributionMap(), 1, 0);
-        mf.setVal(0.0);
-        if (use_filter && current_buf[lev+1][idim])
+        jfp[idim] = current_fp[lev][idim].get();
+        jcp[idim] = current_cp[lev+1][idim].get();
+        jbuf[idim] = current_buf[lev+1][idim].get();
+    }
+
+    if (use_filter)
+    {
+        // All of them are filtered in one pass
+        Vector<MultiFab*> dst;
+        Vector<const MultiFab*> src;
+        for (int idim = 0; idim < 3; ++idim)
         {
-            // coarse patch of fine level
-            IntVect ng = current_cp[lev+1][idim]->nGrowVect();
+            IntVect ng = jfp[idim]->nGrowVect();
             ng += 1;
-            MultiFab jfc(current_cp[lev+1][idim]->boxArray(),
-                         current_cp[lev+1][idim]->DistributionMap(), 1, ng);
-            applyFilter(jfc, *current_cp[lev+1][idim]);
+            src.push_back(jfp[idim]);
+            jfp[idim] = &GetScratch(current_fp_filtered[lev][idim], *jfp[idim], 1, ng);
+            dst.push_back(jfp[idim]);
 
-            // buffer patch of fine level
-            MultiFab jfb(current_buf[lev+1][idim]->boxArray(),
-                         current_buf[lev+1][idim]->DistributionMap(), 1, ng);
-            applyFilter(jfb, *current_buf[lev+1][idim]);
+            ng = jcp[idim]->nGrowVect();
+            ng += 1;
+            src.push_back(jcp[idim]);
+            jcp[idim] = &GetScratch(current_cp_filtered[lev+1][idim], *jcp[idim], 1, ng);
+            dst.push_back(jcp[idim]);
+
+            if (jbuf[idim]) {
+                src.push_back(jbuf[idim]);
+                jbuf[idim] = &GetScratch(current_buf_filtered[lev+1][idim], *jbuf[idim], 1, ng);
+                dst.push_back(jbuf[idim]);
+            }
+        }
+        applyFilter(dst, src);
+    }
 
-            MultiFab::Add(jfb, jfc, 0, 0, 1, ng);
-            mf.ParallelAdd(jfb, 0, 0, 1, ng, IntVect::TheZeroVector(), period);
+    // When there are current buffers, unlike coarse patch,
+    // we don't care about the final state of them.
 
-            jfc.SumBoundary(period);
-            MultiFab::Copy(*current_cp[lev+1][idim], jfc, 0, 0, 1, 0);
-        }
-        else if (use_filter) // but no buffer
+    // The current of lev+1 is added to lev from the guard cells of the coarse
+    // patch (or buffer), before they are summed.
+    for (int idim = 0; idim < 3; ++idim)
+    {
+        MultiFab& mf = GetScratch(current_from_fine[lev][idim], *current_fp[lev][idim],
+                                  1, IntVect::TheZeroVector());
+        mf.setVal(0.0);
+        if (jbuf[idim])
         {
-            // coarse patch of fine level
-            IntVect ng = current_cp[lev+1][idim]->nGrowVect();
-            ng += 1;
-            MultiFab jf(current_cp[lev+1][idim]->boxArray(),
-                        current_cp[lev+1][idim]->DistributionMap(), 1, ng);
-            applyFilter(jf, *current_cp[lev+1][idim]);
-            mf.ParallelAdd(jf, 0, 0, 1, ng, IntVect::TheZeroVector(), period);
-            jf.SumBoundary(period);
-            MultiFab::Copy(*current_cp[lev+1][idim], jf, 0, 0, 1, 0);
+            const IntVect& ng = jcp[idim]->nGrowVect();
+            if (use_filter) {
+                MultiFab::Add(*jbuf[idim], *jcp[idim], 0, 0, 1, ng);
+            } else {
+                MultiFab::Copy(*jbuf[idim], *jcp[idim], 0, 0, 1, ng);
+            }
+            mf.ParallelAdd(*jbuf[idim], 0, 0, 1, jbuf[idim]->nGrowVect(),
+                           IntVect::TheZeroVector(), period);
         }
-        else if (current_buf[lev+1][idim]) // but no filter
+        else
         {
-            MultiFab::Copy(*current_buf[lev+1][idim],
-                           *current_cp [lev+1][idim], 0, 0, 1,
-                           current_cp[lev+1][idim]->nGrow());
-            mf.ParallelAdd(*current_buf[lev+1][idim], 0, 0, 1,
-                           current_buf[lev+1][idim]->nGrowVect(), IntVect::TheZeroVector(),
-                           period);
-            current_cp[lev+1][idim]->SumBoundary(period);
+            mf.ParallelAdd(*jcp[idim], 0, 0, 1, jcp[idim]->nGrowVect(),
+                           IntVect::TheZeroVector(), period);
         }
-        else // no filter, no buffer
-        {
-            mf.ParallelAdd(*current_cp[lev+1][idim], 0, 0, 1,
-                           current_cp[lev+1][idim]->nGrowVect(), IntVect::TheZeroVector(),
-                           period);
-            current_cp[lev+1][idim]->SumBoundary(period);
+    }
+
+    // The fine patch of lev and the coarse patch of lev+1 are summed in one exchange
+    SumBoundaryBatched(sum_boundary_J_from_fine[lev],
+                       {jfp[0], jfp[1], jfp[2], jcp[0], jcp[1], jcp[2]}, 0, 1, period);
+
+    for (int idim = 0; idim < 3; ++idim) {
+        if (use_filter) {
+            MultiFab::Copy(*current_fp[lev][idim], *jfp[idim], 0, 0, 1, 0);
+            MultiFab::Copy(*current_cp[lev+1][idim], *jcp[idim], 0, 0, 1, 0);
         }
-        MultiFab::Add(*current_fp[lev][idim], mf, 0, 0, 1, 0);
+        MultiFab::Add(*current_fp[lev][idim], *current_from_fine[lev][idim], 0, 0, 1, 0);
     }
     NodalSyncJ(lev, PatchType::fine);
     NodalSyncJ(lev+1, PatchType::coarse);
@@ -827,10 +1207,12 @@ WarpX::ApplyFilterandSumBoundaryRho (int lev, PatchType patch_type, int icomp, i
     if (use_filter) {
         IntVect ng = r->nGrowVect();
         ng += 1;
-        MultiFab rf(r->boxArray(), r->DistributionMap(), ncomp, ng);
-        applyFilter(rf, *r, icomp, 0, ncomp);
-        rf.SumBoundary(period);
-        MultiFab::Copy(*r, rf, 0, icomp, ncomp, 0);
+        auto& rf = (patch_type == PatchType::fine) ? rho_fp_filtered[lev] : rho_cp_filtered[lev];
+        // The scratch has all the components, as in SyncRho; the first ncomp are used
+        MultiFab& rfg = GetScratch(rf, *r, r->nComp(), ng);
+        applyFilter(rfg, *r, icomp, 0, ncomp);
+        rfg.SumBoundary(0, ncomp, period);
+        MultiFab::Copy(*r, rfg, 0, icomp, ncomp, 0);
     } else {
         r->SumBoundary(icomp, ncomp, period);
     }
@@ -854,59 +1236,62 @@ WarpX::AddRhoFromFineLevelandSumBoundary(int lev, int icomp, int ncomp)
 {
     if (rho_fp[lev]) {
         const auto& period = Geom(lev).periodicity();
-        MultiFab mf(rho_fp[lev]->boxArray(),
-                    rho_fp[lev]->DistributionMap(),
-                    ncomp, 0);
-        mf.setVal(0.0);
-        if (use_filter && charge_buf[lev+1])
+
+        // The patches to sum, and the buffer: with the filter, their filtered copies,
+        // in which the components start at 0
+        MultiFab* rfp = rho_fp[lev].get();
+        MultiFab* rcp = rho_cp[lev+1].get();
+        MultiFab* rbuf = charge_buf[lev+1].get();
+        int rcomp = icomp;
+
+        if (use_filter)
         {
-            // coarse patch of fine level
-            IntVect ng = rho_cp[lev+1]->nGrowVect();
+            // All of them are filtered in one pass
+            IntVect ng = rfp->nGrowVect();
             ng += 1;
-            MultiFab rhofc(rho_cp[lev+1]->boxArray(),
-                         rho_cp[lev+1]->DistributionMap(), ncomp, ng);
-            applyFilter(rhofc, *rho_cp[lev+1], icomp, 0, ncomp);
+            Vector<const MultiFab*> src {rfp, rcp};
+            rfp = &GetScratch(rho_fp_filtered[lev], *rfp, rfp->nComp(), ng);
+            ng = rcp->nGrowVect();
+            ng += 1;
+            rcp = &GetScratch(rho_cp_filtered[lev+1], *rcp, rcp->nComp(), ng);
+            Vector<MultiFab*> dst {rfp, rcp};
+            if (rbuf) {
+                src.push_back(rbuf);
+                rbuf = &GetScratch(charge_buf_filtered[lev+1], *rbuf, rbuf->nComp(), ng);
+                dst.push_back(rbuf);
+            }
+            applyFilter(dst, src, icomp, ncomp);
+            rcomp = 0;
+        }
 
-            // buffer patch of fine level
-            MultiFab rhofb(charge_buf[lev+1]->boxArray(),
-                           charge_buf[lev+1]->DistributionMap(), ncomp, ng);
-            applyFilter(rhofb, *charge_buf[lev+1], icomp, 0, ncomp);
+        // The charge density of lev+1 is added to lev from the guard cells of the
+        // coarse patch (or buffer), before they are summed.
+        MultiFab& mf = GetScratch(rho_from_fine[lev], *rho_fp[lev], ncomp, IntVect::TheZeroVector());
+        mf.setVal(0.0);
+        if (rbuf)
+        {
+            const IntVect& ng = rcp->nGrowVect();
+            if (use_filter) {
+                MultiFab::Add(*rbuf, *rcp, 0, 0, ncomp, ng);
+            } else {
+                MultiFab::Copy(*rbuf, *rcp, icomp, icomp, ncomp, ng);
+            }
+            mf.ParallelAdd(*rbuf, rcomp, 0, ncomp, rbuf->nGrowVect(),
+                           IntVect::TheZeroVector(), period);
+        }
+        else
+        {
+            mf.ParallelAdd(*rcp, rcomp, 0, ncomp, rcp->nGrowVect(),
+                           IntVect::TheZeroVector(), period);
+        }
 
-            MultiFab::Add(rhofb, rhofc, 0, 0, ncomp, ng);
-            mf.ParallelAdd(rhofb, 0, 0, ncomp, ng, IntVect::TheZeroVector(), period);
+        // The fine patch of lev and the coarse patch of lev+1 are summed in one exchange
+        SumBoundaryBatched(sum_boundary_rho_from_fine[lev], {rfp, rcp}, rcomp, ncomp, period);
 
-            rhofc.SumBoundary(period);
-            MultiFab::Copy(*rho_cp[lev+1], rhofc, 0, 0, ncomp, 0);
+        if (use_filter) {
+            MultiFab::Copy(*rho_fp[lev], *rfp, 0, icomp, ncomp, 0);
+            MultiFab::Copy(*rho_cp[lev+1], *rcp, 0, icomp, ncomp, 0);
         }
-        else if (use_filter) // but no buffer
-        {
-            IntVect ng = rho_cp[lev+1]->nGrowVect();
-            ng += 1;
-            MultiFab rf(rho_cp[lev+1]->boxArray(), rho_cp[lev+1]->DistributionMap(), ncomp, ng);
-            applyFilter(rf, *rho_cp[lev+1], icomp, 0, ncomp);
-            mf.ParallelAdd(rf, 0, 0, ncomp, ng, IntVect::TheZeroVector(), period);
-            rf.SumBoundary(0, ncomp, period);
-            MultiFab::Copy(*rho_cp[lev+1], rf, 0, icomp, ncomp, 0);
-        }
-        else if (charge_buf[lev+1]) // but no filter
-        {
-            MultiFab::Copy(*charge_buf[lev+1],
-                           *rho_cp[lev+1], icomp, icomp, ncomp,
-                           rho_cp[lev+1]->nGrow());
-            mf.ParallelAdd(*charge_buf[lev+1], icomp, 0,
-                           ncomp,
-                           charge_buf[lev+1]->nGrowVect(), IntVect::TheZeroVector(),
-                           period);
-            rho_cp[lev+1]->SumBoundary(icomp, ncomp, period);
-        }
-        else // no filter, no buffer
-        {
-            mf.ParallelAdd(*rho_cp[lev+1], icomp, 0, ncomp,
-                           rho_cp[lev+1]->nGrowVect(), IntVect::TheZeroVector(),
-                           period);
-            rho_cp[lev+1]->SumBoundary(icomp, ncomp, period);
-        }
-        ApplyFilterandSumBoundaryRho(lev, PatchType::fine, icomp, ncomp);
         MultiFab::Add(*rho_fp[lev], mf, 0, icomp, ncomp, 0);
 
         NodalSyncRho(lev, PatchType::fine, icomp, ncomp);
@@ -446,6 +446,10 @@ WritePlotFileES (const amrex::Vector<std::unique_ptr<amrex::MultiFab> >& rho,
     particle_varnames.push_back("By");
     particle_varnames.push_back("Bz");
 
+    particle_varnames.push_back("x");
+    particle_varnames.push_back("y");
+    particle_varnames.push_back("z");
+
     mypc->Checkpoint(plotfilename, true, particle_varnames);
 
     WriteJobInfo(plotfilename);
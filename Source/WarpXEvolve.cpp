@@ -5,6 +5,8 @@
 #include <WarpX.H>
 #include <WarpXConst.H>
 #include <WarpX_f.H>
+#include <WarpXFieldKernels.H>
+#include <ParticleScratch.H>
 #ifdef WARPX_USE_PY
 #include <WarpX_py.H>
 #endif
@@ -15,6 +17,37 @@
 
 using namespace amrex;
 
+namespace
+{
+    // The indices of a field component of type t inside of the domain (unbounded
+    // in the periodic directions), where the guard cells are filled by FillBoundary
+    Box FieldDomain (const Geometry& geom, const IntVect& t, const Box& fabbox)
+    {
+        Box d = amrex::convert(geom.Domain(), t);
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            if (geom.isPeriodic(idim)) {
+                d.setSmall(idim, fabbox.smallEnd(idim));
+                d.setBig(idim, fabbox.bigEnd(idim));
+            }
+        }
+        return d;
+    }
+
+    // The tile box of type t, grown by ng on the sides where it touches the valid
+    // box and restricted to the domain: the cells pushed with warpx.deep_halo_steps
+    Box HaloTileBox (const MFIter& mfi, const IntVect& t, const IntVect& ng, const Geometry& geom)
+    {
+        Box tbx = mfi.tilebox(t);
+        if (ng == IntVect::TheZeroVector()) return tbx;
+        const Box& vbx = amrex::convert(mfi.validbox(), t);
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            if (tbx.smallEnd(idim) == vbx.smallEnd(idim)) tbx.growLo(idim, ng[idim]);
+            if (tbx.bigEnd(idim) == vbx.bigEnd(idim)) tbx.growHi(idim, ng[idim]);
+        }
+        return tbx & FieldDomain(geom, t, tbx);
+    }
+}
+
 void
 WarpX::Evolve (int numsteps) {
     BL_PROFILE_REGION("WarpX::Evolve()");
@@ -54,6 +87,10 @@ WarpX::EvolveEM (int numsteps)
     {
         Real walltime_beg_step = amrex::second();
 
+        // The aux fields are only reused within a step (the fields may be
+        // changed between steps, e.g. from Python)
+        aux_is_current = false;
+
 	// Start loop on time steps
         amrex::Print() << "\nSTEP " << step+1 << " starts ...\n";
 #ifdef WARPX_USE_PY
@@ -89,45 +126,74 @@ WarpX::EvolveEM (int numsteps)
             FillBoundaryE();
             FillBoundaryB();
             UpdateAuxilaryData();
+            FilterAuxFieldsNCI();
             // on first step, push p by -0.5*dt
             for (int lev = 0; lev <= finest_level; ++lev) {
+                const auto& E = GatherFields(Efield_aux[lev], Efield_aux_nci[lev]);
+                const auto& B = GatherFields(Bfield_aux[lev], Bfield_aux_nci[lev]);
                 mypc->PushP(lev, -0.5*dt[lev],
-                            *Efield_aux[lev][0],*Efield_aux[lev][1],*Efield_aux[lev][2],
-                            *Bfield_aux[lev][0],*Bfield_aux[lev][1],*Bfield_aux[lev][2]);
+                            *E[0],*E[1],*E[2],
+                            *B[0],*B[1],*B[2]);
             }
             is_synchronized = false;
+        } else if (overlap_comm) {
+           // Beyond one step, we have E^{n} and B^{n}.
+           // Particles have p^{n-1/2} and x^{n}.
+           // The exchange is completed in PushParticlesandDepose. With a single
+           // level and no NCI filter, there is no auxiliary data to update.
+            FillBoundaryEB_nowait();
+        } else if (deep_halo_steps > 0) {
+           // The guard cells of E and B may still be valid from the last exchange
+            FillBoundaryDeepHalo();
         } else {
            // Beyond one step, we have E^{n} and B^{n}.
            // Particles have p^{n-1/2} and x^{n}.
             FillBoundaryE();
             FillBoundaryB();
             UpdateAuxilaryData();
+            FilterAuxFieldsNCI();
         }
 
         if (do_subcycling == 0 || finest_level == 0) {
             OneStep_nosub(cur_time);
-        } else if (do_subcycling == 1 && finest_level == 1) {
-            OneStep_sub1(cur_time);
+        } else if (do_subcycling == 1) {
+            OneStep_sub(0, cur_time);
         } else {
             amrex::Print() << "Error: do_subcycling = " << do_subcycling << std::endl;
             amrex::Abort("Unsupported do_subcycling type");
         }
 
 #ifdef WARPX_USE_PY
-        if (warpx_py_beforeEsolve) warpx_py_beforeEsolve();
+        if (warpx_py_beforeEsolve) {
+            warpx_py_beforeEsolve();
+            aux_is_current = false;
+        }
 #endif
         if (cur_time + dt[0] >= stop_time - 1.e-3*dt[0] || step == numsteps_max-1) {
             // At the end of last step, push p by 0.5*dt to synchronize
+            if (overlap_comm) {
+                // OneStep_nosub left the guard cells to the next step
+                FillBoundaryE();
+                FillBoundaryB();
+            } else if (deep_halo_steps > 0) {
+                FillBoundaryDeepHalo();
+            }
             UpdateAuxilaryData();
+            FilterAuxFieldsNCI();
             for (int lev = 0; lev <= finest_level; ++lev) {
+                const auto& E = GatherFields(Efield_aux[lev], Efield_aux_nci[lev]);
+                const auto& B = GatherFields(Bfield_aux[lev], Bfield_aux_nci[lev]);
                 mypc->PushP(lev, 0.5*dt[lev],
-                    *Efield_aux[lev][0],*Efield_aux[lev][1],*Efield_aux[lev][2],
-                    *Bfield_aux[lev][0],*Bfield_aux[lev][1],*Bfield_aux[lev][2]);
+                    *E[0],*E[1],*E[2],
+                    *B[0],*B[1],*B[2]);
             }
             is_synchronized = true;
         }
 #ifdef WARPX_USE_PY
-        if (warpx_py_afterEsolve) warpx_py_afterEsolve();
+        if (warpx_py_afterEsolve) {
+            warpx_py_afterEsolve();
+            aux_is_current = false;
+        }
 #endif
 
         for (int lev = 0; lev <= max_level; ++lev) {
@@ -155,6 +221,14 @@ WarpX::EvolveEM (int numsteps)
             mypc->Redistribute();
         }
 
+        mypc->ResampleParticles(step+1);
+
+        const auto ntiles = mypc->NumActiveTiles();
+        if (ntiles.second > 0) {
+            amrex::Print() << "Particle tiles: " << ntiles.first << " of " << ntiles.second
+                           << " active (" << 100.0*ntiles.first/ntiles.second << "%)\n";
+        }
+
         amrex::Print()<< "STEP " << step+1 << " ends." << " TIME = " << cur_time
                       << " DT = " << dt[0] << "\n";
         Real walltime_end_step = amrex::second();
@@ -163,6 +237,8 @@ WarpX::EvolveEM (int numsteps)
                       << " s; This step = " << walltime_end_step-walltime_beg_step
                       << " s; Avg. per step = " << walltime/(step+1) << " s\n";
 
+        mypc->TuneTileSize(walltime_end_step-walltime_beg_step);
+
 	// sync up time
 	for (int i = 0; i <= max_level; ++i) {
 	    t_new[i] = cur_time;
@@ -178,15 +254,7 @@ WarpX::EvolveEM (int numsteps)
 
 	if (to_make_plot || do_insitu)
         {
-            FillBoundaryE();
-            FillBoundaryB();
-            UpdateAuxilaryData();
-
-            for (int lev = 0; lev <= finest_level; ++lev) {
-                mypc->FieldGather(lev,
-                                  *Efield_aux[lev][0],*Efield_aux[lev][1],*Efield_aux[lev][2],
-                                  *Bfield_aux[lev][0],*Bfield_aux[lev][1],*Bfield_aux[lev][2]);
-            }
+            GatherFieldsForDiagnostics();
 
 	    last_plot_file_step = step+1;
 	    last_insitu_step = step+1;
@@ -210,7 +278,10 @@ WarpX::EvolveEM (int numsteps)
 	}
 
 #ifdef WARPX_USE_PY
-        if (warpx_py_afterstep) warpx_py_afterstep();
+        if (warpx_py_afterstep) {
+            warpx_py_afterstep();
+            aux_is_current = false;
+        }
 #endif
 	// End loop on time steps
     }
@@ -222,15 +293,7 @@ WarpX::EvolveEM (int numsteps)
 
     if (write_plot_file || do_insitu)
     {
-        FillBoundaryE();
-        FillBoundaryB();
-        UpdateAuxilaryData();
-
-        for (int lev = 0; lev <= finest_level; ++lev) {
-            mypc->FieldGather(lev,
-                              *Efield_aux[lev][0],*Efield_aux[lev][1],*Efield_aux[lev][2],
-                              *Bfield_aux[lev][0],*Bfield_aux[lev][1],*Bfield_aux[lev][2]);
-        }
+        GatherFieldsForDiagnostics();
 
         if (write_plot_file)
             WritePlotFile();
@@ -247,11 +310,29 @@ WarpX::EvolveEM (int numsteps)
         myBFD->Flush(geom[0]);
     }
 
+    ReportNCIFilterCost();
+    ReportDeepHaloCost();
+    ParticleScratch::PrintStatistics();
+
 #ifdef BL_USE_SENSEI_INSITU
     insitu_bridge->finalize();
 #endif
 }
 
+void
+WarpX::GatherFieldsForDiagnostics ()
+{
+    FillBoundaryE();
+    FillBoundaryB();
+    UpdateAuxilaryData();
+
+    for (int lev = 0; lev <= finest_level; ++lev) {
+        mypc->FieldGather(lev,
+                          *Efield_aux[lev][0],*Efield_aux[lev][1],*Efield_aux[lev][2],
+                          *Bfield_aux[lev][0],*Bfield_aux[lev][1],*Bfield_aux[lev][2]);
+    }
+}
+
 /* /brief Perform one PIC iteration, without subcycling
 *  i.e. all levels/patches use the same timestep (that of the finest level)
 *  for the field advance and particle pusher.
@@ -273,7 +354,19 @@ WarpX::OneStep_nosub (Real cur_time)
     if (warpx_py_afterdeposition) warpx_py_afterdeposition();
 #endif
 
-    SyncCurrent();
+    // With warpx.overlap_comm, the current is exchanged during the first
+    // half push of B, which does not need it. The guard cells of E and B
+    // are filled at the beginning of the next step, in EvolveEM.
+#ifdef WARPX_USE_PSATD
+    const bool overlap_current = false;
+#else
+    const bool overlap_current = overlap_comm && !WarpX::use_filter;
+#endif
+    if (overlap_current) {
+        SyncCurrent_nowait();
+    } else {
+        SyncCurrent();
+    }
 
     SyncRho(rho_fp, rho_cp);
 
@@ -281,188 +374,212 @@ WarpX::OneStep_nosub (Real cur_time)
     // (And update guard cells immediately afterwards)
 #ifdef WARPX_USE_PSATD
     PushPSATD(dt[0]);
-    FillBoundaryE();
-    FillBoundaryB();
+    if (!overlap_comm) {
+        FillBoundaryE();
+        FillBoundaryB();
+    }
 #else
+    if (fdtd_temporal_blocking) {
+        EvolveFieldsBlocked(dt[0]); // We now have E^{n+1} and B^{n+1}
+        FillBoundaryE();
+        FillBoundaryB();
+        return;
+    }
+    if (deep_halo_steps > 0) {
+        EvolveFieldsDeepHalo(dt[0]); // We now have E^{n+1} and B^{n+1}
+        return;
+    }
     EvolveF(0.5*dt[0], DtType::FirstHalf);
     FillBoundaryF();
     EvolveB(0.5*dt[0]); // We now have B^{n+1/2}
     FillBoundaryB();
-    EvolveE(dt[0]); // We now have E^{n+1}
+    if (overlap_current) {
+        SyncCurrent_finish();
+    }
+    EvolveE(dt[0], pml_fused_damping); // We now have E^{n+1}
     FillBoundaryE();
     EvolveF(0.5*dt[0], DtType::SecondHalf);
-    EvolveB(0.5*dt[0]); // We now have B^{n+1}
-    if (do_pml) {
+    EvolveB(0.5*dt[0], pml_fused_damping); // We now have B^{n+1}
+    if (do_pml && !pml_fused_damping) {
         DampPML();
-        FillBoundaryE();
+        if (!overlap_comm) FillBoundaryE();
     }
-    FillBoundaryB();
+    if (!overlap_comm) FillBoundaryB();
 #endif
 }
 
-/* /brief Perform one PIC iteration, with subcycling
+/* /brief Perform one PIC iteration of level `lev` and of the finer levels, with subcycling
 *  i.e. The fine patch uses a smaller timestep (and steps more often)
 *  than the coarse patch, for the field advance and particle pusher.
 *
-* This version of subcycling only works for 2 levels and with a refinement
-* ratio of 2.
-* The particles and fields of the fine patch are pushed twice
-* (with dt[coarse]/2) in this routine.
-* The particles of the coarse patch and mother grid are pushed only once
-* (with dt[coarse]). The fields on the coarse patch and mother grid
-* are pushed in a way which is equivalent to pushing once only, with
-* a current which is the average of the coarse + fine current at the 2
-* steps of the fine grid.
+* With do_subcycling, dt[lev] = r*dt[lev+1], where r is the refinement ratio
+* between lev and lev+1 (2 or 4). This routine pushes the particles and fields
+* of `lev` by dt[lev], and those of lev+1 r times by dt[lev+1], by calling
+* itself; the finer levels therefore each advance at their own timestep.
+* The particles of `lev` are pushed only once (with dt[lev]). The fields of
+* `lev` and of the coarse patch of lev+1 are pushed in r parts, between the
+* steps of lev+1, in a way which is equivalent to pushing once only, with
+* a current which is the average of the coarse + fine current at the r
+* steps of the fine level. With 2 levels and a refinement ratio of 2, this is
+* the original subcycling scheme.
 *
 */
 void
-WarpX::OneStep_sub1 (Real curtime)
+WarpX::OneStep_sub (int lev, Real curtime)
 {
     // TODO: we could save some charge depositions
 
-    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(finest_level == 1, "Must have exactly two levels");
-    const int fine_lev = 1;
-    const int coarse_lev = 0;
+    if (lev == finest_level)
+    {
+        // Push particles and fields on the fine patch, by one step of lev
+        PushParticlesandDepose(lev, curtime);
+        if (lev > 0) {
+            RestrictCurrentFromFineToCoarsePatch(lev);
+            RestrictRhoFromFineToCoarsePatch(lev);
+        }
+        ApplyFilterandSumBoundaryJ(lev, PatchType::fine);
+        NodalSyncJ(lev, PatchType::fine);
+        ApplyFilterandSumBoundaryRho(lev, PatchType::fine, 0, 2);
+        NodalSyncRho(lev, PatchType::fine, 0, 2);
 
-    // i) Push particles and fields on the fine patch (first fine step)
-    PushParticlesandDepose(fine_lev, curtime);
-    RestrictCurrentFromFineToCoarsePatch(fine_lev);
-    RestrictRhoFromFineToCoarsePatch(fine_lev);
-    ApplyFilterandSumBoundaryJ(fine_lev, PatchType::fine);
-    NodalSyncJ(fine_lev, PatchType::fine);
-    ApplyFilterandSumBoundaryRho(fine_lev, PatchType::fine, 0, 2);
-    NodalSyncRho(fine_lev, PatchType::fine, 0, 2);
+        EvolveB(lev, PatchType::fine, 0.5*dt[lev]);
+        EvolveF(lev, PatchType::fine, 0.5*dt[lev], DtType::FirstHalf);
+        FillBoundaryB(lev, PatchType::fine);
+        FillBoundaryF(lev, PatchType::fine);
 
-    EvolveB(fine_lev, PatchType::fine, 0.5*dt[fine_lev]);
-    EvolveF(fine_lev, PatchType::fine, 0.5*dt[fine_lev], DtType::FirstHalf);
-    FillBoundaryB(fine_lev, PatchType::fine);
-    FillBoundaryF(fine_lev, PatchType::fine);
+        EvolveE(lev, PatchType::fine, dt[lev]);
+        FillBoundaryE(lev, PatchType::fine);
 
-    EvolveE(fine_lev, PatchType::fine, dt[fine_lev]);
-    FillBoundaryE(fine_lev, PatchType::fine);
+        EvolveB(lev, PatchType::fine, 0.5*dt[lev]);
+        EvolveF(lev, PatchType::fine, 0.5*dt[lev], DtType::SecondHalf);
 
-    EvolveB(fine_lev, PatchType::fine, 0.5*dt[fine_lev]);
-    EvolveF(fine_lev, PatchType::fine, 0.5*dt[fine_lev], DtType::SecondHalf);
+        if (do_pml) {
+            DampPML(lev, PatchType::fine);
+            FillBoundaryE(lev, PatchType::fine);
+        }
 
-    if (do_pml) {
-        DampPML(fine_lev, PatchType::fine);
-        FillBoundaryE(fine_lev, PatchType::fine);
+        FillBoundaryB(lev, PatchType::fine);
+        FillBoundaryF(lev, PatchType::fine);
+        return;
     }
 
-    FillBoundaryB(fine_lev, PatchType::fine);
-
-    // ii) Push particles on the coarse patch and mother grid.
-    // Push the fields on the coarse patch and mother grid
-    // by only half a coarse step (first half)
-    PushParticlesandDepose(coarse_lev, curtime);
-    StoreCurrent(coarse_lev);
-    AddCurrentFromFineLevelandSumBoundary(coarse_lev);
-    AddRhoFromFineLevelandSumBoundary(coarse_lev, 0, 1);
-
-    EvolveB(fine_lev, PatchType::coarse, dt[fine_lev]);
-    EvolveF(fine_lev, PatchType::coarse, dt[fine_lev], DtType::FirstHalf);
-    FillBoundaryB(fine_lev, PatchType::coarse);
-    FillBoundaryF(fine_lev, PatchType::coarse);
-
-    EvolveE(fine_lev, PatchType::coarse, dt[fine_lev]);
-    FillBoundaryE(fine_lev, PatchType::coarse);
+    const int fine_lev = lev+1;
+    const int coarse_lev = lev;
+    const int nsub = refRatio(coarse_lev)[0];
 
-    EvolveB(coarse_lev, PatchType::fine, 0.5*dt[coarse_lev]);
-    EvolveF(coarse_lev, PatchType::fine, 0.5*dt[coarse_lev], DtType::FirstHalf);
-    FillBoundaryB(coarse_lev, PatchType::fine);
-    FillBoundaryF(coarse_lev, PatchType::fine);
-
-    EvolveE(coarse_lev, PatchType::fine, 0.5*dt[coarse_lev]);
-    FillBoundaryE(coarse_lev, PatchType::fine);
-
-    // iii) Get auxiliary fields on the fine grid, at dt[fine_lev]
-    UpdateAuxilaryData();
-
-    // iv) Push particles and fields on the fine patch (second fine step)
-    PushParticlesandDepose(fine_lev, curtime+dt[fine_lev]);
-    RestrictCurrentFromFineToCoarsePatch(fine_lev);
-    RestrictRhoFromFineToCoarsePatch(fine_lev);
-    ApplyFilterandSumBoundaryJ(fine_lev, PatchType::fine);
-    NodalSyncJ(fine_lev, PatchType::fine);
-    ApplyFilterandSumBoundaryRho(fine_lev, PatchType::fine, 0, 2);
-    NodalSyncRho(fine_lev, PatchType::fine, 0, 2);
-
-    EvolveB(fine_lev, PatchType::fine, 0.5*dt[fine_lev]);
-    EvolveF(fine_lev, PatchType::fine, 0.5*dt[fine_lev], DtType::FirstHalf);
-    FillBoundaryB(fine_lev, PatchType::fine);
-    FillBoundaryF(fine_lev, PatchType::fine);
-
-    EvolveE(fine_lev, PatchType::fine, dt[fine_lev]);
-    FillBoundaryE(fine_lev, PatchType::fine);
+    for (int isub = 0; isub < nsub; ++isub)
+    {
+        const bool first = (isub == 0);
+        const bool last = (isub == nsub-1);
 
-    EvolveB(fine_lev, PatchType::fine, 0.5*dt[fine_lev]);
-    EvolveF(fine_lev, PatchType::fine, 0.5*dt[fine_lev], DtType::SecondHalf);
+        if (!first) {
+            // Get auxiliary fields on the fine grid, at isub*dt[fine_lev]
+            UpdateAuxilaryData();
+            FilterAuxFieldsNCI();
+        }
 
-    if (do_pml) {
-        DampPML(fine_lev, PatchType::fine);
-        FillBoundaryE(fine_lev, PatchType::fine);
-    }
+        // i) Push particles and fields on the fine patch (step isub of fine_lev,
+        // and the steps of the finer levels)
+        OneStep_sub(fine_lev, curtime + isub*dt[fine_lev]);
+
+        // ii) Push particles on the coarse patch and mother grid during the first
+        // fine step. The current of coarse_lev is then the current deposited by
+        // its particles, plus that of the fine level during fine step isub.
+        if (first) {
+            PushParticlesandDepose(coarse_lev, curtime);
+            if (coarse_lev > 0) {
+                RestrictCurrentFromFineToCoarsePatch(coarse_lev);
+                RestrictRhoFromFineToCoarsePatch(coarse_lev);
+            }
+            StoreCurrent(coarse_lev);
+        } else {
+            RestoreCurrent(coarse_lev);
+            // Keep a copy for the next fine steps
+            if (!last) StoreCurrent(coarse_lev);
+        }
+        AddCurrentFromFineLevelandSumBoundary(coarse_lev);
+        if (first) AddRhoFromFineLevelandSumBoundary(coarse_lev, 0, 1);
+        if (last) AddRhoFromFineLevelandSumBoundary(coarse_lev, 1, 1);
+
+        // iii) Push the fields on the coarse patch and mother grid
+        // by 1/nsub of a coarse step: B by half a coarse step in the first
+        // and last fine steps, E by dt[fine_lev] in every fine step
+        if (first) {
+            EvolveB(fine_lev, PatchType::coarse, 0.5*dt[coarse_lev]);
+            EvolveF(fine_lev, PatchType::coarse, 0.5*dt[coarse_lev], DtType::FirstHalf);
+            FillBoundaryB(fine_lev, PatchType::coarse);
+            FillBoundaryF(fine_lev, PatchType::coarse);
+        }
 
-    FillBoundaryB(fine_lev, PatchType::fine);
-    FillBoundaryF(fine_lev, PatchType::fine);
+        EvolveE(fine_lev, PatchType::coarse, dt[fine_lev]);
+        FillBoundaryE(fine_lev, PatchType::coarse);
 
-    // v) Push the fields on the coarse patch and mother grid
-    // by only half a coarse step (second half)
-    RestoreCurrent(coarse_lev);
-    AddCurrentFromFineLevelandSumBoundary(coarse_lev);
-    AddRhoFromFineLevelandSumBoundary(coarse_lev, 1, 1);
+        if (last) {
+            EvolveB(fine_lev, PatchType::coarse, 0.5*dt[coarse_lev]);
+            EvolveF(fine_lev, PatchType::coarse, 0.5*dt[coarse_lev], DtType::SecondHalf);
 
-    EvolveE(fine_lev, PatchType::coarse, dt[fine_lev]);
-    FillBoundaryE(fine_lev, PatchType::coarse);
+            if (do_pml) {
+                // The PML factors of the coarse patch are computed with dt[fine_lev]
+                for (int i = 0; i < nsub; ++i) {
+                    DampPML(fine_lev, PatchType::coarse);
+                }
+                FillBoundaryE(fine_lev, PatchType::coarse);
+            }
 
-    EvolveB(fine_lev, PatchType::coarse, dt[fine_lev]);
-    EvolveF(fine_lev, PatchType::coarse, dt[fine_lev], DtType::SecondHalf);
+            FillBoundaryB(fine_lev, PatchType::coarse);
+            FillBoundaryF(fine_lev, PatchType::coarse);
+        }
 
-    if (do_pml) {
-        DampPML(fine_lev, PatchType::coarse); // do it twice
-        DampPML(fine_lev, PatchType::coarse);
-        FillBoundaryE(fine_lev, PatchType::coarse);
-    }
+        if (first) {
+            EvolveB(coarse_lev, PatchType::fine, 0.5*dt[coarse_lev]);
+            EvolveF(coarse_lev, PatchType::fine, 0.5*dt[coarse_lev], DtType::FirstHalf);
+            FillBoundaryB(coarse_lev, PatchType::fine);
+            FillBoundaryF(coarse_lev, PatchType::fine);
+        }
 
-    FillBoundaryB(fine_lev, PatchType::coarse);
-    FillBoundaryF(fine_lev, PatchType::coarse);
+        EvolveE(coarse_lev, PatchType::fine, dt[fine_lev]);
+        FillBoundaryE(coarse_lev, PatchType::fine);
 
-    EvolveE(coarse_lev, PatchType::fine, 0.5*dt[coarse_lev]);
-    FillBoundaryE(coarse_lev, PatchType::fine);
+        if (last) {
+            EvolveB(coarse_lev, PatchType::fine, 0.5*dt[coarse_lev]);
+            EvolveF(coarse_lev, PatchType::fine, 0.5*dt[coarse_lev], DtType::SecondHalf);
 
-    EvolveB(coarse_lev, PatchType::fine, 0.5*dt[coarse_lev]);
-    EvolveF(coarse_lev, PatchType::fine, 0.5*dt[coarse_lev], DtType::SecondHalf);
+            if (do_pml) {
+                DampPML(coarse_lev, PatchType::fine);
+                FillBoundaryE(coarse_lev, PatchType::fine);
+            }
 
-    if (do_pml) {
-        DampPML(coarse_lev, PatchType::fine);
-        FillBoundaryE(coarse_lev, PatchType::fine);
+            FillBoundaryB(coarse_lev, PatchType::fine);
+            FillBoundaryF(coarse_lev, PatchType::fine);
+        }
     }
-
-    FillBoundaryB(coarse_lev, PatchType::fine);
 }
 
 void
-WarpX::EvolveB (Real dt)
+WarpX::EvolveB (Real dt, bool damp_pml)
 {
     for (int lev = 0; lev <= finest_level; ++lev) {
-        EvolveB(lev, dt);
+        EvolveB(lev, dt, damp_pml);
     }
 }
 
 void
-WarpX::EvolveB (int lev, Real dt)
+WarpX::EvolveB (int lev, Real dt, bool damp_pml)
 {
     BL_PROFILE("WarpX::EvolveB()");
-    EvolveB(lev, PatchType::fine, dt);
+    EvolveB(lev, PatchType::fine, dt, IntVect::TheZeroVector(), damp_pml);
     if (lev > 0)
     {
-        EvolveB(lev, PatchType::coarse, dt);
+        EvolveB(lev, PatchType::coarse, dt, IntVect::TheZeroVector(), damp_pml);
     }
 }
 
 void
-WarpX::EvolveB (int lev, PatchType patch_type, amrex::Real dt)
+WarpX::EvolveB (int lev, PatchType patch_type, amrex::Real dt, const IntVect& ng_halo,
+                bool damp_pml)
 {
+    aux_is_current = false;
+
     const int patch_level = (patch_type == PatchType::fine) ? lev : lev-1;
     const std::array<Real,3>& dx = WarpX::CellSize(patch_level);
     const std::array<Real,3> dtsdx {dt/dx[0], dt/dx[1], dt/dx[2]};
@@ -498,12 +615,12 @@ WarpX::EvolveB (int lev, PatchType patch_type, amrex::Real dt)
     {
         Real wt = amrex::second();
 
-        const Box& tbx  = mfi.tilebox(Bx_nodal_flag);
-        const Box& tby  = mfi.tilebox(By_nodal_flag);
-        const Box& tbz  = mfi.tilebox(Bz_nodal_flag);
+        const Box& tbx  = HaloTileBox(mfi, Bx_nodal_flag, ng_halo, Geom(patch_level));
+        const Box& tby  = HaloTileBox(mfi, By_nodal_flag, ng_halo, Geom(patch_level));
+        const Box& tbz  = HaloTileBox(mfi, Bz_nodal_flag, ng_halo, Geom(patch_level));
 
-        // Call picsar routine for each tile
-        warpx_push_bvec(
+        // Call the field kernel for each tile
+        FieldKernels::push_bvec(
 		      tbx.loVect(), tbx.hiVect(),
 		      tby.loVect(), tby.hiVect(),
 		      tbz.loVect(), tbz.hiVect(),
@@ -528,17 +645,42 @@ WarpX::EvolveB (int lev, PatchType patch_type, amrex::Real dt)
     {
         const auto& pml_B = (patch_type == PatchType::fine) ? pml[lev]->GetB_fp() : pml[lev]->GetB_cp();
         const auto& pml_E = (patch_type == PatchType::fine) ? pml[lev]->GetE_fp() : pml[lev]->GetE_cp();
+        const auto& sigba = (patch_type == PatchType::fine) ? pml[lev]->GetMultiSigmaBox_fp()
+                                                              : pml[lev]->GetMultiSigmaBox_cp();
+
+        // Time spent on each PML box, added to the costs of the grids
+        Vector<Real> pml_cost((cost) ? pml_B[0]->size() : 0, 0.0);
 
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
         for ( MFIter mfi(*pml_B[0],true); mfi.isValid(); ++mfi )
         {
+            Real wt = amrex::second();
+
             const Box& tbx  = mfi.tilebox(Bx_nodal_flag);
             const Box& tby  = mfi.tilebox(By_nodal_flag);
             const Box& tbz  = mfi.tilebox(Bz_nodal_flag);
 
-            WRPX_PUSH_PML_BVEC(
+            if (damp_pml)
+            {
+                // The coefficients of sigba are for a push by dt/2
+                FieldKernels::PushPMLBDamped(
+			     tbx.loVect(), tbx.hiVect(),
+			     tby.loVect(), tby.hiVect(),
+			     tbz.loVect(), tbz.hiVect(),
+			     BL_TO_FORTRAN_3D((*pml_E[0])[mfi]),
+			     BL_TO_FORTRAN_3D((*pml_E[1])[mfi]),
+			     BL_TO_FORTRAN_3D((*pml_E[2])[mfi]),
+			     BL_TO_FORTRAN_3D((*pml_B[0])[mfi]),
+			     BL_TO_FORTRAN_3D((*pml_B[1])[mfi]),
+			     BL_TO_FORTRAN_3D((*pml_B[2])[mfi]),
+			     sigba[mfi], dx.data(),
+			     WarpX::maxwell_fdtd_solver_id);
+            }
+            else
+            {
+                WRPX_PUSH_PML_BVEC(
 			     tbx.loVect(), tbx.hiVect(),
 			     tby.loVect(), tby.hiVect(),
 			     tbz.loVect(), tbz.hiVect(),
@@ -550,33 +692,47 @@ WarpX::EvolveB (int lev, PatchType patch_type, amrex::Real dt)
 			     BL_TO_FORTRAN_3D((*pml_B[2])[mfi]),
 			     &dtsdx[0], &dtsdx[1], &dtsdx[2],
 			     &WarpX::maxwell_fdtd_solver_id);
+            }
+
+            if (cost) {
+                wt = amrex::second() - wt;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+                pml_cost[mfi.index()] += wt;
+            }
         }
+
+        if (cost) AddPMLCost(lev, patch_type, pml_cost);
     }
 }
 
 void
-WarpX::EvolveE (Real dt)
+WarpX::EvolveE (Real dt, bool damp_pml)
 {
     for (int lev = 0; lev <= finest_level; ++lev)
     {
-        EvolveE(lev, dt);
+        EvolveE(lev, dt, damp_pml);
     }
 }
 
 void
-WarpX::EvolveE (int lev, Real dt)
+WarpX::EvolveE (int lev, Real dt, bool damp_pml)
 {
     BL_PROFILE("WarpX::EvolveE()");
-    EvolveE(lev, PatchType::fine, dt);
+    EvolveE(lev, PatchType::fine, dt, IntVect::TheZeroVector(), damp_pml);
     if (lev > 0)
     {
-        EvolveE(lev, PatchType::coarse, dt);
+        EvolveE(lev, PatchType::coarse, dt, IntVect::TheZeroVector(), damp_pml);
     }
 }
 
 void
-WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real dt)
+WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real dt, const IntVect& ng_halo,
+                bool damp_pml)
 {
+    aux_is_current = false;
+
     const Real mu_c2_dt = (PhysConst::mu0*PhysConst::c*PhysConst::c) * dt;
     const Real c2dt = (PhysConst::c*PhysConst::c) * dt;
 
@@ -597,6 +753,12 @@ WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real dt)
         jy = current_fp[lev][1].get();
         jz = current_fp[lev][2].get();
         F  = F_fp[lev].get();
+        if (deep_halo_steps > 0)
+        {
+            jx = current_halo[0].get();
+            jy = current_halo[1].get();
+            jz = current_halo[2].get();
+        }
     }
     else if (patch_type == PatchType::coarse)
     {
@@ -623,12 +785,12 @@ WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real dt)
     {
         Real wt = amrex::second();
 
-        const Box& tex  = mfi.tilebox(Ex_nodal_flag);
-        const Box& tey  = mfi.tilebox(Ey_nodal_flag);
-        const Box& tez  = mfi.tilebox(Ez_nodal_flag);
+        const Box& tex  = HaloTileBox(mfi, Ex_nodal_flag, ng_halo, Geom(patch_level));
+        const Box& tey  = HaloTileBox(mfi, Ey_nodal_flag, ng_halo, Geom(patch_level));
+        const Box& tez  = HaloTileBox(mfi, Ez_nodal_flag, ng_halo, Geom(patch_level));
 
-        // Call picsar routine for each tile
-        warpx_push_evec(
+        // Call the field kernel for each tile
+        FieldKernels::push_evec(
 		      tex.loVect(), tex.hiVect(),
 		      tey.loVect(), tey.hiVect(),
 		      tez.loVect(), tez.hiVect(),
@@ -673,16 +835,41 @@ WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real dt)
         const auto& pml_B = (patch_type == PatchType::fine) ? pml[lev]->GetB_fp() : pml[lev]->GetB_cp();
         const auto& pml_E = (patch_type == PatchType::fine) ? pml[lev]->GetE_fp() : pml[lev]->GetE_cp();
         const auto& pml_F = (patch_type == PatchType::fine) ? pml[lev]->GetF_fp() : pml[lev]->GetF_cp();
+        const auto& sigba = (patch_type == PatchType::fine) ? pml[lev]->GetMultiSigmaBox_fp()
+                                                              : pml[lev]->GetMultiSigmaBox_cp();
+
+        // Time spent on each PML box, added to the costs of the grids
+        Vector<Real> pml_cost((cost) ? pml_E[0]->size() : 0, 0.0);
+
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
         for ( MFIter mfi(*pml_E[0],true); mfi.isValid(); ++mfi )
         {
+            Real wt = amrex::second();
+
             const Box& tex  = mfi.tilebox(Ex_nodal_flag);
             const Box& tey  = mfi.tilebox(Ey_nodal_flag);
             const Box& tez  = mfi.tilebox(Ez_nodal_flag);
 
-            WRPX_PUSH_PML_EVEC(
+            if (damp_pml)
+            {
+                // Without div(E) cleaning, so there is no pml_F to push
+                FieldKernels::PushPMLEDamped(
+			     tex.loVect(), tex.hiVect(),
+			     tey.loVect(), tey.hiVect(),
+			     tez.loVect(), tez.hiVect(),
+			     BL_TO_FORTRAN_3D((*pml_E[0])[mfi]),
+			     BL_TO_FORTRAN_3D((*pml_E[1])[mfi]),
+			     BL_TO_FORTRAN_3D((*pml_E[2])[mfi]),
+			     BL_TO_FORTRAN_3D((*pml_B[0])[mfi]),
+			     BL_TO_FORTRAN_3D((*pml_B[1])[mfi]),
+			     BL_TO_FORTRAN_3D((*pml_B[2])[mfi]),
+			     sigba[mfi]);
+            }
+            else
+            {
+                WRPX_PUSH_PML_EVEC(
 			     tex.loVect(), tex.hiVect(),
 			     tey.loVect(), tey.hiVect(),
 			     tez.loVect(), tez.hiVect(),
@@ -693,6 +880,7 @@ WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real dt)
 			     BL_TO_FORTRAN_3D((*pml_B[1])[mfi]),
 			     BL_TO_FORTRAN_3D((*pml_B[2])[mfi]),
 			     &dtsdx_c2[0], &dtsdx_c2[1], &dtsdx_c2[2]);
+            }
 
             if (pml_F)
             {
@@ -707,8 +895,208 @@ WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real dt)
 				   &dtsdx_c2[0], &dtsdx_c2[1], &dtsdx_c2[2],
 				   &WarpX::maxwell_fdtd_solver_id);
             }
+
+            if (cost) {
+                wt = amrex::second() - wt;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+                pml_cost[mfi.index()] += wt;
+            }
+        }
+
+        if (cost) AddPMLCost(lev, patch_type, pml_cost);
+    }
+}
+
+void
+WarpX::EvolveFieldsBlocked (Real dt)
+{
+    BL_PROFILE("WarpX::EvolveFieldsBlocked()");
+
+    aux_is_current = false;
+
+    // Each grid is swept once, plane by plane along the last direction (wavefront
+    // temporal blocking): at plane k, B is pushed to n+1/2, then E to n+1 at plane k-1,
+    // then B to n+1 at plane k-2. The FDTD stencils only reach the neighboring planes,
+    // so each push reads data that is at the right time level, and the fields are
+    // updated in place while the planes are still in cache. To avoid the intermediate
+    // FillBoundary, B^{n+1/2} and E^{n+1} are also computed in the guard cells (two
+    // and one cells deep, inside the domain), from the guard cells of E^n, B^n and j
+    // (filled here), which gives the values that FillBoundary would copy there.
+
+    const int lev = 0;
+    const Geometry& gm = Geom(lev);
+    const std::array<Real,3>& dx = WarpX::CellSize(lev);
+    const Real hdt = 0.5*dt;
+    const std::array<Real,3> dtsdx {hdt/dx[0], hdt/dx[1], hdt/dx[2]};
+    const Real mu_c2_dt = (PhysConst::mu0*PhysConst::c*PhysConst::c) * dt;
+    const Real c2dt = (PhysConst::c*PhysConst::c) * dt;
+    const std::array<Real,3> dtsdx_c2 {c2dt/dx[0], c2dt/dx[1], c2dt/dx[2]};
+
+    MultiFab& Ex = *Efield_fp[lev][0];
+    MultiFab& Ey = *Efield_fp[lev][1];
+    MultiFab& Ez = *Efield_fp[lev][2];
+    MultiFab& Bx = *Bfield_fp[lev][0];
+    MultiFab& By = *Bfield_fp[lev][1];
+    MultiFab& Bz = *Bfield_fp[lev][2];
+    MultiFab& jx = *current_fp[lev][0];
+    MultiFab& jy = *current_fp[lev][1];
+    MultiFab& jz = *current_fp[lev][2];
+
+    AMREX_ALWAYS_ASSERT(Ex.nGrow() >= 3 && Bx.nGrow() >= 3 && jx.nGrow() >= 1);
+
+    jx.FillBoundary(gm.periodicity());
+    jy.FillBoundary(gm.periodicity());
+    jz.FillBoundary(gm.periodicity());
+
+    const std::array<IntVect,3> Eflag {Ex_nodal_flag, Ey_nodal_flag, Ez_nodal_flag};
+    const std::array<IntVect,3> Bflag {Bx_nodal_flag, By_nodal_flag, Bz_nodal_flag};
+
+    MultiFab* cost = costs[lev].get();
+
+    // One grid at a time; the threads share the planes
+    for (MFIter mfi(Ex); mfi.isValid(); ++mfi)
+    {
+        Real wt = amrex::second();
+
+        const Box& cbx = boxArray(lev)[mfi.index()];
+        std::array<Box,3> rB1, rE, rB2;
+        for (int i = 0; i < 3; ++i) {
+            const Box& bfab = (i == 0) ? Bx[mfi].box() : ((i == 1) ? By[mfi].box() : Bz[mfi].box());
+            const Box& efab = (i == 0) ? Ex[mfi].box() : ((i == 1) ? Ey[mfi].box() : Ez[mfi].box());
+            rB1[i] = amrex::grow(amrex::convert(cbx, Bflag[i]), 2) & FieldDomain(gm, Bflag[i], bfab);
+            rE[i]  = amrex::grow(amrex::convert(cbx, Eflag[i]), 1) & FieldDomain(gm, Eflag[i], efab);
+            rB2[i] = amrex::convert(cbx, Bflag[i]);
+        }
+        FieldKernels::PushBlocked(rB1, rE, rB2,
+                                  Ex[mfi], Ey[mfi], Ez[mfi], Bx[mfi], By[mfi], Bz[mfi],
+                                  jx[mfi], jy[mfi], jz[mfi],
+                                  dtsdx.data(), mu_c2_dt, dtsdx_c2.data(),
+                                  WarpX::maxwell_fdtd_solver_id);
+
+        if (cost) {
+            wt = (amrex::second() - wt) / cbx.d_numPts();
+            (*cost)[mfi].plus(wt, cbx);
+        }
+    }
+}
+
+void
+WarpX::EvolveFieldsDeepHalo (Real dt)
+{
+    BL_PROFILE("WarpX::EvolveFieldsDeepHalo()");
+
+    // B^{n+1/2}, E^{n+1} and B^{n+1} are also computed in the guard cells (inside the
+    // domain) where the fields they are computed from are valid, minus the one cell
+    // that the stencils reach. The neighboring grids push the same values from the
+    // same data, so these guard cells hold what FillBoundary would copy there. The
+    // guard cells outside of the domain are exchanged with the PML after each push,
+    // as in OneStep_nosub.
+
+    const int lev = 0;
+    const Geometry& gm = Geom(lev);
+
+    Real wt = amrex::second();
+    FillCurrentHalo();
+    deep_halo_current_time += amrex::second() - wt;
+
+    auto exchange_pml_e = [&] ()
+    {
+        if (do_pml && pml[lev]->ok())
+        {
+            pml[lev]->ExchangeE(PatchType::fine, { Efield_fp[lev][0].get(),
+                                                   Efield_fp[lev][1].get(),
+                                                   Efield_fp[lev][2].get() });
+            pml[lev]->FillBoundaryE(PatchType::fine);
+        }
+    };
+    auto exchange_pml_b = [&] ()
+    {
+        if (do_pml && pml[lev]->ok())
+        {
+            pml[lev]->ExchangeB(PatchType::fine, { Bfield_fp[lev][0].get(),
+                                                   Bfield_fp[lev][1].get(),
+                                                   Bfield_fp[lev][2].get() });
+            pml[lev]->FillBoundaryB(PatchType::fine);
+        }
+    };
+
+    // Count the cells updated in the valid boxes, and redundantly in the guard cells
+    const std::array<IntVect,3> Eflag {Ex_nodal_flag, Ey_nodal_flag, Ez_nodal_flag};
+    const std::array<IntVect,3> Bflag {Bx_nodal_flag, By_nodal_flag, Bz_nodal_flag};
+    auto count_cells = [&] (const std::array<IntVect,3>& flags, const IntVect& ng)
+    {
+        for (MFIter mfi(*Efield_fp[lev][0]); mfi.isValid(); ++mfi)
+        {
+            for (const auto& t : flags)
+            {
+                const Box& vbx = amrex::convert(mfi.validbox(), t);
+                const Box& gbx = amrex::grow(vbx, ng);
+                deep_halo_cells_valid += vbx.numPts();
+                deep_halo_cells_redundant += (gbx & FieldDomain(gm, t, gbx)).numPts() - vbx.numPts();
+            }
         }
+    };
+
+    const IntVect ngB1 = amrex::min(deep_halo_depth_B, deep_halo_depth_E - 1);
+    const IntVect ngE  = ngB1 - 1;
+    const IntVect ngB2 = ngB1 - 2;
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ngB2.min() >= 0,
+        "EvolveFieldsDeepHalo: not enough valid guard cells, FillBoundaryDeepHalo must be called first");
+
+    count_cells(Bflag, ngB1);
+    count_cells(Eflag, ngE);
+    count_cells(Bflag, ngB2);
+
+    wt = amrex::second();
+    EvolveB(lev, PatchType::fine, 0.5*dt, ngB1); // We now have B^{n+1/2}
+    deep_halo_push_time += amrex::second() - wt;
+    deep_halo_depth_B = ngB1;
+    exchange_pml_b();
+
+    wt = amrex::second();
+    EvolveE(lev, PatchType::fine, dt, ngE, pml_fused_damping); // We now have E^{n+1}
+    deep_halo_push_time += amrex::second() - wt;
+    deep_halo_depth_E = ngE;
+    exchange_pml_e();
+
+    wt = amrex::second();
+    EvolveB(lev, PatchType::fine, 0.5*dt, ngB2, pml_fused_damping); // We now have B^{n+1}
+    deep_halo_push_time += amrex::second() - wt;
+    deep_halo_depth_B = ngB2;
+
+    if (do_pml && !pml_fused_damping) {
+        DampPML();
+        exchange_pml_e();
     }
+    exchange_pml_b();
+}
+
+void
+WarpX::FillCurrentHalo ()
+{
+    BL_PROFILE("WarpX::FillCurrentHalo()");
+
+    const int lev = 0;
+    const IntVect& ng = Efield_fp[lev][0]->nGrowVect();
+
+    Vector<MultiFab*> mfs;
+    for (int idim = 0; idim < 3; ++idim)
+    {
+        const MultiFab& j = *current_fp[lev][idim];
+        // Allocated on first use, and again after a regrid or a load balance
+        if (current_halo[idim] == nullptr ||
+            current_halo[idim]->boxArray() != j.boxArray() ||
+            current_halo[idim]->DistributionMap() != j.DistributionMap())
+        {
+            current_halo[idim].reset(new MultiFab(j.boxArray(), j.DistributionMap(), 1, ng));
+            current_halo[idim]->setVal(0.0);
+        }
+        MultiFab::Copy(*current_halo[idim], j, 0, 0, 1, 0);
+        mfs.push_back(current_halo[idim].get());
+    }
+    fill_boundary_current_halo.FillBoundary(mfs, Geom(lev).periodicity());
 }
 
 void
@@ -812,6 +1200,9 @@ WarpX::DampPML (int lev, PatchType patch_type)
 
     BL_PROFILE("WarpX::DampPML()");
 
+    // The damped PML fields are copied into E and B by the next FillBoundary
+    aux_is_current = false;
+
     if (pml[lev]->ok())
     {
         const auto& pml_E = (patch_type == PatchType::fine) ? pml[lev]->GetE_fp() : pml[lev]->GetE_cp();
@@ -820,11 +1211,16 @@ WarpX::DampPML (int lev, PatchType patch_type)
         const auto& sigba = (patch_type == PatchType::fine) ? pml[lev]->GetMultiSigmaBox_fp()
                                                               : pml[lev]->GetMultiSigmaBox_cp();
 
+        MultiFab* cost = costs[lev].get();
+        Vector<Real> pml_cost((cost) ? pml_E[0]->size() : 0, 0.0);
+
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
         for ( MFIter mfi(*pml_E[0],true); mfi.isValid(); ++mfi )
         {
+            Real wt = amrex::second();
+
             const Box& tex  = mfi.tilebox(Ex_nodal_flag);
             const Box& tey  = mfi.tilebox(Ey_nodal_flag);
             const Box& tez  = mfi.tilebox(Ez_nodal_flag);
@@ -852,7 +1248,17 @@ WarpX::DampPML (int lev, PatchType patch_type)
 			        BL_TO_FORTRAN_3D((*pml_F)[mfi]),
 			        WRPX_PML_TO_FORTRAN(sigba[mfi]));
             }
+
+            if (cost) {
+                wt = amrex::second() - wt;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+                pml_cost[mfi.index()] += wt;
+            }
         }
+
+        if (cost) AddPMLCost(lev, patch_type, pml_cost);
     }
 }
 
@@ -861,23 +1267,37 @@ WarpX::PushParticlesandDepose (Real cur_time)
 {
     // Evolve particles to p^{n+1/2} and x^{n+1}
     // Depose current, j^{n+1/2}
-    for (int lev = 0; lev <= finest_level; ++lev) {
-        PushParticlesandDepose(lev, cur_time);
+    if (eb_exchange_in_progress)
+    {
+        // The particles that need the guard cells of E and B wait for the exchange
+        PushParticlesandDepose(0, cur_time, EvolvePhase::Interior);
+        FillBoundaryEB_finish();
+        PushParticlesandDepose(0, cur_time, EvolvePhase::Boundary);
+    }
+    else
+    {
+        for (int lev = 0; lev <= finest_level; ++lev) {
+            PushParticlesandDepose(lev, cur_time);
+        }
     }
 }
 
 void
-WarpX::PushParticlesandDepose (int lev, Real cur_time)
+WarpX::PushParticlesandDepose (int lev, Real cur_time, EvolvePhase phase)
 {
+    const auto& E  = GatherFields(Efield_aux[lev], Efield_aux_nci[lev]);
+    const auto& B  = GatherFields(Bfield_aux[lev], Bfield_aux_nci[lev]);
+    const auto& cE = GatherFields(Efield_cax[lev], Efield_cax_nci[lev]);
+    const auto& cB = GatherFields(Bfield_cax[lev], Bfield_cax_nci[lev]);
     mypc->Evolve(lev,
-                 *Efield_aux[lev][0],*Efield_aux[lev][1],*Efield_aux[lev][2],
-                 *Bfield_aux[lev][0],*Bfield_aux[lev][1],*Bfield_aux[lev][2],
+                 *E[0],*E[1],*E[2],
+                 *B[0],*B[1],*B[2],
                  *current_fp[lev][0],*current_fp[lev][1],*current_fp[lev][2],
                  current_buf[lev][0].get(), current_buf[lev][1].get(), current_buf[lev][2].get(),
                  rho_fp[lev].get(), charge_buf[lev].get(),
-                 Efield_cax[lev][0].get(), Efield_cax[lev][1].get(), Efield_cax[lev][2].get(),
-                 Bfield_cax[lev][0].get(), Bfield_cax[lev][1].get(), Bfield_cax[lev][2].get(),
-                 cur_time, dt[lev]);
+                 cE[0], cE[1], cE[2],
+                 cB[0], cB[1], cB[2],
+                 cur_time, dt[lev], phase);
 }
 
 void
@@ -0,0 +1,753 @@
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <AMReX.H>
+
+#include <WarpXFieldKernels.H>
+
+using namespace amrex;
+
+namespace FieldKernels
+{
+    PushBFn push_bvec = warpx_push_bvec;
+    PushEFn push_evec = warpx_push_evec;
+}
+
+namespace
+{
+    // Chunk ichunk (of nchunks) of the plane k of bx, normal to the last direction.
+    // The plane is split along the direction before it. Empty if k is outside of bx.
+    Box PlaneChunk (const Box& bx, int k, int ichunk, int nchunks)
+    {
+        const int zdir = AMREX_SPACEDIM-1;
+        const int cdir = AMREX_SPACEDIM-2;
+        Box b = bx;
+        b.setSmall(zdir, k);
+        b.setBig(zdir, k);
+        const int lo = bx.smallEnd(cdir);
+        const int len = bx.length(cdir);
+        b.setSmall(cdir, lo + (len*ichunk)/nchunks);
+        b.setBig(cdir, lo + (len*(ichunk+1))/nchunks - 1);
+        return b & bx;
+    }
+
+    // Values of maxwell_fdtd_solver_id
+    constexpr int yee = 0;
+    constexpr int ckc = 1;
+
+    //
+    // Strides of a Fortran-ordered array with bounds lo:hi, in 3D form: in 2D, the
+    // second index of lo and hi is z, and the (missing) y direction has a zero stride.
+    //
+    struct FabLayout
+    {
+        FabLayout (const int* lo, const int* hi)
+        {
+#if (AMREX_SPACEDIM == 3)
+            lo3[0] = lo[0]; lo3[1] = lo[1]; lo3[2] = lo[2];
+            stride[0] = 1;
+            stride[1] = hi[0]-lo[0]+1;
+            stride[2] = stride[1]*(hi[1]-lo[1]+1);
+            npts = stride[2]*(hi[2]-lo[2]+1);
+#else
+            lo3[0] = lo[0]; lo3[1] = 0; lo3[2] = lo[1];
+            stride[0] = 1;
+            stride[1] = 0;
+            stride[2] = hi[0]-lo[0]+1;
+            npts = stride[2]*(hi[1]-lo[1]+1);
+#endif
+        }
+
+        long offset (int i, int j, int k) const {
+            return (i-lo3[0]) + (j-lo3[1])*stride[1] + (k-lo3[2])*stride[2];
+        }
+
+        int lo3[3];
+        long stride[3];
+        long npts;  // stride between the components
+    };
+
+    //
+    // Calls f(i, j, k, n) for each row of the box lo:hi along x, which starts at (i,j,k)
+    // and has n points. In 2D, j is 0.
+    //
+    template <class F>
+    void ForEachRow (const int* lo, const int* hi, F&& f)
+    {
+        const int n = hi[0]-lo[0]+1;
+#if (AMREX_SPACEDIM == 3)
+        for (int k = lo[2]; k <= hi[2]; ++k) {
+            for (int j = lo[1]; j <= hi[1]; ++j) {
+                f(lo[0], j, k, n);
+            }
+        }
+#else
+        for (int k = lo[1]; k <= hi[1]; ++k) {
+            f(lo[0], 0, k, n);
+        }
+#endif
+    }
+
+    //
+    // Weights of the forward difference along a direction d: alpha for the line through
+    // the point, beta[t] for each of the two lines shifted by one cell along t, and gamma
+    // for each of the four lines shifted along both transverse directions. They include
+    // the factor dt/dx_d. The Yee solver only uses alpha.
+    //
+    struct DiffCoefs
+    {
+        Real alpha = 0.0;
+        Real beta[3] = {0.0, 0.0, 0.0};
+        Real gamma = 0.0;
+    };
+
+    //
+    // Weights of the CKC stencil, as in PICSAR (Cowan et al., PRSTAB 16, 041303, 2013),
+    // from dtsd[d] = dt/dx_d (dtsd[1] is not used in 2D).
+    //
+    template <int solver>
+    void SetDiffCoefs (DiffCoefs* c, const Real* dtsd)
+    {
+        for (int d = 0; d < 3; ++d) {
+            c[d] = DiffCoefs();
+            c[d].alpha = dtsd[d];
+        }
+        if (solver == yee) return;
+
+#if (AMREX_SPACEDIM == 3)
+        const Real delta = std::max({dtsd[0], dtsd[1], dtsd[2]});
+        Real r[3];
+        for (int d = 0; d < 3; ++d) {
+            r[d] = (dtsd[d]/delta)*(dtsd[d]/delta);
+        }
+        const Real rsum = r[1]*r[2] + r[2]*r[0] + r[0]*r[1];
+        const Real beta = 0.125*(1.0 - r[0]*r[1]*r[2]/rsum);
+        for (int d = 0; d < 3; ++d)
+        {
+            const int t1 = (d+1)%3;
+            const int t2 = (d+2)%3;
+            const Real gamma = r[t1]*r[t2]*(1.0/16.0 - 0.125*r[t1]*r[t2]/rsum);
+            c[d].alpha    = (1.0 - 2.0*(r[t1] + r[t2])*beta - 4.0*gamma)*dtsd[d];
+            c[d].beta[t1] = r[t1]*beta*dtsd[d];
+            c[d].beta[t2] = r[t2]*beta*dtsd[d];
+            c[d].gamma    = gamma*dtsd[d];
+        }
+#else
+        const Real delta = std::max(dtsd[0], dtsd[2]);
+        Real r[3];
+        r[0] = (dtsd[0]/delta)*(dtsd[0]/delta);
+        r[2] = (dtsd[2]/delta)*(dtsd[2]/delta);
+        for (int d = 0; d <= 2; d += 2)
+        {
+            const int t = 2-d;
+            c[d].alpha   = (1.0 - 0.25*r[t])*dtsd[d];
+            c[d].beta[t] = 0.125*r[t]*dtsd[d];
+        }
+#endif
+    }
+
+    //
+    // Forward difference along d of the values v(o) at the offsets o from the point,
+    // for the strides s, with the weights c. The points used by the CKC stencil are
+    // fixed at compile time.
+    //
+    template <int solver, int d, class V>
+    inline Real ForwardDiffOf (const V& v, const long* s, const DiffCoefs& c)
+    {
+        const long sd = s[d];
+        Real r = c.alpha*(v(sd) - v(0));
+        if (solver == ckc)
+        {
+#if (AMREX_SPACEDIM == 3)
+            constexpr int t1 = (d+1)%3;
+            constexpr int t2 = (d+2)%3;
+            const long s1 = s[t1];
+            const long s2 = s[t2];
+            r += c.beta[t1]*(v(sd+s1) - v(s1) + v(sd-s1) - v(-s1))
+               + c.beta[t2]*(v(sd+s2) - v(s2) + v(sd-s2) - v(-s2))
+               + c.gamma*(v(sd+s1+s2) - v(s1+s2) + v(sd-s1+s2) - v(-s1+s2)
+                        + v(sd+s1-s2) - v(s1-s2) + v(sd-s1-s2) - v(-s1-s2));
+#else
+            constexpr int t = 2-d;  // the other direction of the x-z plane
+            const long st = s[t];
+            r += c.beta[t]*(v(sd+st) - v(st) + v(sd-st) - v(-st));
+#endif
+        }
+        return r;
+    }
+
+    // Forward difference along d of the array at p
+    template <int solver, int d>
+    inline Real ForwardDiff (const Real* p, const long* s, const DiffCoefs& c)
+    {
+        return ForwardDiffOf<solver,d>([p] (long o) { return p[o]; }, s, c);
+    }
+
+    // Backward difference along d of the array at p, whose strides are s, times c
+    template <int d>
+    inline Real BackwardDiff (const Real* p, const long* s, Real c)
+    {
+        return c*(p[0] - p[-s[d]]);
+    }
+
+    // Backward difference along d of the values v(o) at the offsets o from the point
+    template <int d, class V>
+    inline Real BackwardDiffOf (const V& v, const long* s)
+    {
+        return v(0) - v(-s[d]);
+    }
+
+    // Sum of the ncomp split components of a PML field at p, whose components are n apart
+    template <int ncomp>
+    struct SplitSum
+    {
+        Real operator() (long o) const {
+            Real r = p[o];
+            for (int icomp = 1; icomp < ncomp; ++icomp) r += p[o+icomp*n];
+            return r;
+        }
+        const Real* p;
+        long n;
+    };
+
+    // The values of the PML factors s from index i on
+    inline const Real* At (const Sigma& s, int i)
+    {
+        return s.data() + (i - s.lo());
+    }
+
+    //
+    // Weights of SetDiffCoefs for the stencil alone, without the factor dt/dx_d (which
+    // the PML coefficients include). For the Yee solver, alpha is 1.
+    //
+    template <int solver>
+    void SetUnitDiffCoefs (DiffCoefs* c, const Real* dx)
+    {
+        const Real invdx[3] = {1.0/dx[0], 1.0/dx[1], 1.0/dx[2]};
+        SetDiffCoefs<solver>(c, invdx);
+        for (int d = 0; d < 3; ++d)
+        {
+            c[d].alpha /= invdx[d];
+            for (int t = 0; t < 3; ++t) c[d].beta[t] /= invdx[d];
+            c[d].gamma /= invdx[d];
+        }
+    }
+
+    //
+    // Push of B by dt (with the dtsd factors of the caller):
+    // B -= dt curl E, with the forward differences of the Yee or CKC stencil.
+    //
+    template <int solver>
+    void NativePushB (const int* xlo, const int* xhi,
+                      const int* ylo, const int* yhi,
+                      const int* zlo, const int* zhi,
+                      const Real* ex, const int* exlo, const int* exhi,
+                      const Real* ey, const int* eylo, const int* eyhi,
+                      const Real* ez, const int* ezlo, const int* ezhi,
+                      Real* bx, const int* bxlo, const int* bxhi,
+                      Real* by, const int* bylo, const int* byhi,
+                      Real* bz, const int* bzlo, const int* bzhi,
+                      const Real* dtsdx, const Real* dtsdy, const Real* dtsdz,
+                      const int* /*maxwell_fdtd_solver_id*/)
+    {
+#if (AMREX_SPACEDIM == 3)
+        const Real dtsd[3] = {*dtsdx, *dtsdy, *dtsdz};
+#else
+        (void)dtsdy;
+        const Real dtsd[3] = {*dtsdx, 0.0, *dtsdz};
+#endif
+        DiffCoefs c[3];
+        SetDiffCoefs<solver>(c, dtsd);
+
+        const FabLayout exl(exlo, exhi), eyl(eylo, eyhi), ezl(ezlo, ezhi);
+        const FabLayout bxl(bxlo, bxhi), byl(bylo, byhi), bzl(bzlo, bzhi);
+
+        // Bx += - d(Ez)/dy + d(Ey)/dz
+        ForEachRow(xlo, xhi, [&] (int i, int j, int k, int n)
+        {
+            Real* b = bx + bxl.offset(i,j,k);
+            const Real* fy = ey + eyl.offset(i,j,k);
+#if (AMREX_SPACEDIM == 3)
+            const Real* fz = ez + ezl.offset(i,j,k);
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                b[m] += - ForwardDiff<solver,1>(fz+m, ezl.stride, c[1])
+                        + ForwardDiff<solver,2>(fy+m, eyl.stride, c[2]);
+            }
+#else
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                b[m] += ForwardDiff<solver,2>(fy+m, eyl.stride, c[2]);
+            }
+#endif
+        });
+
+        // By += d(Ez)/dx - d(Ex)/dz
+        ForEachRow(ylo, yhi, [&] (int i, int j, int k, int n)
+        {
+            Real* b = by + byl.offset(i,j,k);
+            const Real* fx = ex + exl.offset(i,j,k);
+            const Real* fz = ez + ezl.offset(i,j,k);
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                b[m] += ForwardDiff<solver,0>(fz+m, ezl.stride, c[0])
+                      - ForwardDiff<solver,2>(fx+m, exl.stride, c[2]);
+            }
+        });
+
+        // Bz += - d(Ey)/dx + d(Ex)/dy
+        ForEachRow(zlo, zhi, [&] (int i, int j, int k, int n)
+        {
+            Real* b = bz + bzl.offset(i,j,k);
+            const Real* fy = ey + eyl.offset(i,j,k);
+#if (AMREX_SPACEDIM == 3)
+            const Real* fx = ex + exl.offset(i,j,k);
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                b[m] += - ForwardDiff<solver,0>(fy+m, eyl.stride, c[0])
+                        + ForwardDiff<solver,1>(fx+m, exl.stride, c[1]);
+            }
+#else
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                b[m] += - ForwardDiff<solver,0>(fy+m, eyl.stride, c[0]);
+            }
+#endif
+        });
+    }
+
+    //
+    // Push of E by dt (with the dtsd factors of the caller, which include c^2):
+    // E += c^2 dt curl B - mudt J, with the backward differences of the Yee stencil.
+    //
+    void NativePushE (const int* xlo, const int* xhi,
+                      const int* ylo, const int* yhi,
+                      const int* zlo, const int* zhi,
+                      Real* ex, const int* exlo, const int* exhi,
+                      Real* ey, const int* eylo, const int* eyhi,
+                      Real* ez, const int* ezlo, const int* ezhi,
+                      const Real* bx, const int* bxlo, const int* bxhi,
+                      const Real* by, const int* bylo, const int* byhi,
+                      const Real* bz, const int* bzlo, const int* bzhi,
+                      const Real* jx, const int* jxlo, const int* jxhi,
+                      const Real* jy, const int* jylo, const int* jyhi,
+                      const Real* jz, const int* jzlo, const int* jzhi,
+                      const Real* mudt,
+                      const Real* dtsdx, const Real* dtsdy, const Real* dtsdz)
+    {
+        const Real mu = *mudt;
+        const Real cx = *dtsdx;
+        const Real cz = *dtsdz;
+#if (AMREX_SPACEDIM == 3)
+        const Real cy = *dtsdy;
+#else
+        (void)dtsdy;
+#endif
+
+        const FabLayout exl(exlo, exhi), eyl(eylo, eyhi), ezl(ezlo, ezhi);
+        const FabLayout bxl(bxlo, bxhi), byl(bylo, byhi), bzl(bzlo, bzhi);
+        const FabLayout jxl(jxlo, jxhi), jyl(jylo, jyhi), jzl(jzlo, jzhi);
+
+        // Ex += d(Bz)/dy - d(By)/dz - mudt*jx
+        ForEachRow(xlo, xhi, [&] (int i, int j, int k, int n)
+        {
+            Real* e = ex + exl.offset(i,j,k);
+            const Real* cur = jx + jxl.offset(i,j,k);
+            const Real* fy = by + byl.offset(i,j,k);
+#if (AMREX_SPACEDIM == 3)
+            const Real* fz = bz + bzl.offset(i,j,k);
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                e[m] += BackwardDiff<1>(fz+m, bzl.stride, cy)
+                      - BackwardDiff<2>(fy+m, byl.stride, cz)
+                      - mu*cur[m];
+            }
+#else
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                e[m] += - BackwardDiff<2>(fy+m, byl.stride, cz)
+                        - mu*cur[m];
+            }
+#endif
+        });
+
+        // Ey += - d(Bz)/dx + d(Bx)/dz - mudt*jy
+        ForEachRow(ylo, yhi, [&] (int i, int j, int k, int n)
+        {
+            Real* e = ey + eyl.offset(i,j,k);
+            const Real* cur = jy + jyl.offset(i,j,k);
+            const Real* fx = bx + bxl.offset(i,j,k);
+            const Real* fz = bz + bzl.offset(i,j,k);
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                e[m] += - BackwardDiff<0>(fz+m, bzl.stride, cx)
+                        + BackwardDiff<2>(fx+m, bxl.stride, cz)
+                        - mu*cur[m];
+            }
+        });
+
+        // Ez += d(By)/dx - d(Bx)/dy - mudt*jz
+        ForEachRow(zlo, zhi, [&] (int i, int j, int k, int n)
+        {
+            Real* e = ez + ezl.offset(i,j,k);
+            const Real* cur = jz + jzl.offset(i,j,k);
+            const Real* fy = by + byl.offset(i,j,k);
+#if (AMREX_SPACEDIM == 3)
+            const Real* fx = bx + bxl.offset(i,j,k);
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                e[m] += BackwardDiff<0>(fy+m, byl.stride, cx)
+                      - BackwardDiff<1>(fx+m, bxl.stride, cy)
+                      - mu*cur[m];
+            }
+#else
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                e[m] += BackwardDiff<0>(fy+m, byl.stride, cx)
+                      - mu*cur[m];
+            }
+#endif
+        });
+    }
+
+    //
+    // Push of the PML B by dt/2 followed by its damping, in one pass. Each split component
+    // is multiplied by the sigma_star_fac of the direction of its difference, which is
+    // multiplied by the sigma_star_coef of that direction (sigma_star_fac*0.5*dt/dx).
+    // The differences are those of the sum of the three split components of E.
+    //
+    template <int solver>
+    void PMLPushBDamped (const int* xlo, const int* xhi,
+                         const int* ylo, const int* yhi,
+                         const int* zlo, const int* zhi,
+                         const Real* ex, const int* exlo, const int* exhi,
+                         const Real* ey, const int* eylo, const int* eyhi,
+                         const Real* ez, const int* ezlo, const int* ezhi,
+                         Real* bx, const int* bxlo, const int* bxhi,
+                         Real* by, const int* bylo, const int* byhi,
+                         Real* bz, const int* bzlo, const int* bzhi,
+                         const SigmaBox& sigba, const Real* dx)
+    {
+        DiffCoefs c[3];
+        SetUnitDiffCoefs<solver>(c, dx);
+
+        const FabLayout exl(exlo, exhi), eyl(eylo, eyhi), ezl(ezlo, ezhi);
+        const FabLayout bxl(bxlo, bxhi), byl(bylo, byhi), bzl(bzlo, bzhi);
+
+        const auto& fac  = sigba.sigma_star_fac;
+        const auto& coef = sigba.sigma_star_coef;
+        constexpr int zdim = AMREX_SPACEDIM-1;  // index of z in the SigmaBox arrays
+
+        // Bx1 -= d(Ez)/dy, Bx2 += d(Ey)/dz
+        ForEachRow(xlo, xhi, [&] (int i, int j, int k, int n)
+        {
+            Real* b = bx + bxl.offset(i,j,k);
+            const Real* fy = ey + eyl.offset(i,j,k);
+            const Real fz2 = *At(fac[zdim], k);
+            const Real cz2 = *At(coef[zdim], k);
+#if (AMREX_SPACEDIM == 3)
+            const Real* fz = ez + ezl.offset(i,j,k);
+            const Real fy1 = *At(fac[1], j);
+            const Real cy1 = *At(coef[1], j);
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                b[m] = fy1*b[m]
+                    - cy1*ForwardDiffOf<solver,1>(SplitSum<3>{fz+m, ezl.npts}, ezl.stride, c[1]);
+                b[m+bxl.npts] = fz2*b[m+bxl.npts]
+                    + cz2*ForwardDiffOf<solver,2>(SplitSum<3>{fy+m, eyl.npts}, eyl.stride, c[2]);
+            }
+#else
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                b[m+bxl.npts] = fz2*b[m+bxl.npts]
+                    + cz2*ForwardDiffOf<solver,2>(SplitSum<3>{fy+m, eyl.npts}, eyl.stride, c[2]);
+            }
+#endif
+        });
+
+        // By1 -= d(Ex)/dz, By2 += d(Ez)/dx
+        ForEachRow(ylo, yhi, [&] (int i, int j, int k, int n)
+        {
+            Real* b = by + byl.offset(i,j,k);
+            const Real* fx = ex + exl.offset(i,j,k);
+            const Real* fz = ez + ezl.offset(i,j,k);
+            const Real fz1 = *At(fac[zdim], k);
+            const Real cz1 = *At(coef[zdim], k);
+            const Real* fx2 = At(fac[0], i);
+            const Real* cx2 = At(coef[0], i);
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                b[m] = fz1*b[m]
+                    - cz1*ForwardDiffOf<solver,2>(SplitSum<3>{fx+m, exl.npts}, exl.stride, c[2]);
+                b[m+byl.npts] = fx2[m]*b[m+byl.npts]
+                    + cx2[m]*ForwardDiffOf<solver,0>(SplitSum<3>{fz+m, ezl.npts}, ezl.stride, c[0]);
+            }
+        });
+
+        // Bz1 -= d(Ey)/dx, Bz2 += d(Ex)/dy
+        ForEachRow(zlo, zhi, [&] (int i, int j, int k, int n)
+        {
+            Real* b = bz + bzl.offset(i,j,k);
+            const Real* fy = ey + eyl.offset(i,j,k);
+            const Real* fx1 = At(fac[0], i);
+            const Real* cx1 = At(coef[0], i);
+#if (AMREX_SPACEDIM == 3)
+            const Real* fx = ex + exl.offset(i,j,k);
+            const Real fy2 = *At(fac[1], j);
+            const Real cy2 = *At(coef[1], j);
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                b[m] = fx1[m]*b[m]
+                    - cx1[m]*ForwardDiffOf<solver,0>(SplitSum<3>{fy+m, eyl.npts}, eyl.stride, c[0]);
+                b[m+bzl.npts] = fy2*b[m+bzl.npts]
+                    + cy2*ForwardDiffOf<solver,1>(SplitSum<3>{fx+m, exl.npts}, exl.stride, c[1]);
+            }
+#else
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                b[m] = fx1[m]*b[m]
+                    - cx1[m]*ForwardDiffOf<solver,0>(SplitSum<3>{fy+m, eyl.npts}, eyl.stride, c[0]);
+            }
+#endif
+        });
+    }
+
+    //
+    // Push of the PML E by dt followed by its damping, in one pass, with the factors
+    // sigma_fac and the coefficients sigma_coef (sigma_fac*c^2*dt/dx). The differences
+    // are those of the sum of the two split components of B. The third component of E,
+    // which is only used with div(E) cleaning, is not updated.
+    //
+    void PMLPushEDamped (const int* xlo, const int* xhi,
+                         const int* ylo, const int* yhi,
+                         const int* zlo, const int* zhi,
+                         Real* ex, const int* exlo, const int* exhi,
+                         Real* ey, const int* eylo, const int* eyhi,
+                         Real* ez, const int* ezlo, const int* ezhi,
+                         const Real* bx, const int* bxlo, const int* bxhi,
+                         const Real* by, const int* bylo, const int* byhi,
+                         const Real* bz, const int* bzlo, const int* bzhi,
+                         const SigmaBox& sigba)
+    {
+        const FabLayout exl(exlo, exhi), eyl(eylo, eyhi), ezl(ezlo, ezhi);
+        const FabLayout bxl(bxlo, bxhi), byl(bylo, byhi), bzl(bzlo, bzhi);
+
+        const auto& fac  = sigba.sigma_fac;
+        const auto& coef = sigba.sigma_coef;
+        constexpr int zdim = AMREX_SPACEDIM-1;
+
+        // Ex1 += d(Bz)/dy, Ex2 -= d(By)/dz
+        ForEachRow(xlo, xhi, [&] (int i, int j, int k, int n)
+        {
+            Real* e = ex + exl.offset(i,j,k);
+            const Real* fy = by + byl.offset(i,j,k);
+            const Real fz2 = *At(fac[zdim], k);
+            const Real cz2 = *At(coef[zdim], k);
+#if (AMREX_SPACEDIM == 3)
+            const Real* fz = bz + bzl.offset(i,j,k);
+            const Real fy1 = *At(fac[1], j);
+            const Real cy1 = *At(coef[1], j);
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                e[m] = fy1*e[m]
+                    + cy1*BackwardDiffOf<1>(SplitSum<2>{fz+m, bzl.npts}, bzl.stride);
+                e[m+exl.npts] = fz2*e[m+exl.npts]
+                    - cz2*BackwardDiffOf<2>(SplitSum<2>{fy+m, byl.npts}, byl.stride);
+            }
+#else
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                e[m+exl.npts] = fz2*e[m+exl.npts]
+                    - cz2*BackwardDiffOf<2>(SplitSum<2>{fy+m, byl.npts}, byl.stride);
+            }
+#endif
+        });
+
+        // Ey1 += d(Bx)/dz, Ey2 -= d(Bz)/dx
+        ForEachRow(ylo, yhi, [&] (int i, int j, int k, int n)
+        {
+            Real* e = ey + eyl.offset(i,j,k);
+            const Real* fx = bx + bxl.offset(i,j,k);
+            const Real* fz = bz + bzl.offset(i,j,k);
+            const Real fz1 = *At(fac[zdim], k);
+            const Real cz1 = *At(coef[zdim], k);
+            const Real* fx2 = At(fac[0], i);
+            const Real* cx2 = At(coef[0], i);
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                e[m] = fz1*e[m]
+                    + cz1*BackwardDiffOf<2>(SplitSum<2>{fx+m, bxl.npts}, bxl.stride);
+                e[m+eyl.npts] = fx2[m]*e[m+eyl.npts]
+                    - cx2[m]*BackwardDiffOf<0>(SplitSum<2>{fz+m, bzl.npts}, bzl.stride);
+            }
+        });
+
+        // Ez1 += d(By)/dx, Ez2 -= d(Bx)/dy
+        ForEachRow(zlo, zhi, [&] (int i, int j, int k, int n)
+        {
+            Real* e = ez + ezl.offset(i,j,k);
+            const Real* fy = by + byl.offset(i,j,k);
+            const Real* fx1 = At(fac[0], i);
+            const Real* cx1 = At(coef[0], i);
+#if (AMREX_SPACEDIM == 3)
+            const Real* fx = bx + bxl.offset(i,j,k);
+            const Real fy2 = *At(fac[1], j);
+            const Real cy2 = *At(coef[1], j);
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                e[m] = fx1[m]*e[m]
+                    + cx1[m]*BackwardDiffOf<0>(SplitSum<2>{fy+m, byl.npts}, byl.stride);
+                e[m+ezl.npts] = fy2*e[m+ezl.npts]
+                    - cy2*BackwardDiffOf<1>(SplitSum<2>{fx+m, bxl.npts}, bxl.stride);
+            }
+#else
+#pragma omp simd
+            for (int m = 0; m < n; ++m) {
+                e[m] = fx1[m]*e[m]
+                    + cx1[m]*BackwardDiffOf<0>(SplitSum<2>{fy+m, byl.npts}, byl.stride);
+            }
+#endif
+        });
+    }
+}
+
+void
+FieldKernels::Select (int use_native, int maxwell_fdtd_solver_id)
+{
+    if (!use_native)
+    {
+        push_bvec = warpx_push_bvec;
+        push_evec = warpx_push_evec;
+        return;
+    }
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(maxwell_fdtd_solver_id == yee || maxwell_fdtd_solver_id == ckc,
+        "algo.use_native_field_solver requires algo.maxwell_fdtd_solver = yee or ckc");
+
+    push_bvec = (maxwell_fdtd_solver_id == ckc) ? NativePushB<ckc> : NativePushB<yee>;
+    push_evec = NativePushE;
+}
+
+void
+FieldKernels::PushPMLBDamped (const int* xlo, const int* xhi,
+                              const int* ylo, const int* yhi,
+                              const int* zlo, const int* zhi,
+                              const Real* ex, const int* exlo, const int* exhi,
+                              const Real* ey, const int* eylo, const int* eyhi,
+                              const Real* ez, const int* ezlo, const int* ezhi,
+                              Real* bx, const int* bxlo, const int* bxhi,
+                              Real* by, const int* bylo, const int* byhi,
+                              Real* bz, const int* bzlo, const int* bzhi,
+                              const SigmaBox& sigba, const Real* dx,
+                              int maxwell_fdtd_solver_id)
+{
+    auto push = (maxwell_fdtd_solver_id == ckc) ? PMLPushBDamped<ckc> : PMLPushBDamped<yee>;
+    push(xlo, xhi, ylo, yhi, zlo, zhi,
+         ex, exlo, exhi, ey, eylo, eyhi, ez, ezlo, ezhi,
+         bx, bxlo, bxhi, by, bylo, byhi, bz, bzlo, bzhi,
+         sigba, dx);
+}
+
+void
+FieldKernels::PushPMLEDamped (const int* xlo, const int* xhi,
+                              const int* ylo, const int* yhi,
+                              const int* zlo, const int* zhi,
+                              Real* ex, const int* exlo, const int* exhi,
+                              Real* ey, const int* eylo, const int* eyhi,
+                              Real* ez, const int* ezlo, const int* ezhi,
+                              const Real* bx, const int* bxlo, const int* bxhi,
+                              const Real* by, const int* bylo, const int* byhi,
+                              const Real* bz, const int* bzlo, const int* bzhi,
+                              const SigmaBox& sigba)
+{
+    PMLPushEDamped(xlo, xhi, ylo, yhi, zlo, zhi,
+                   ex, exlo, exhi, ey, eylo, eyhi, ez, ezlo, ezhi,
+                   bx, bxlo, bxhi, by, bylo, byhi, bz, bzlo, bzhi,
+                   sigba);
+}
+
+void
+FieldKernels::PushBlocked (const std::array<Box,3>& rB1,
+                           const std::array<Box,3>& rE,
+                           const std::array<Box,3>& rB2,
+                           FArrayBox& exfab, FArrayBox& eyfab, FArrayBox& ezfab,
+                           FArrayBox& bxfab, FArrayBox& byfab, FArrayBox& bzfab,
+                           const FArrayBox& jxfab, const FArrayBox& jyfab, const FArrayBox& jzfab,
+                           const Real* dtsdx, Real mu_c2_dt, const Real* dtsdx_c2,
+                           int maxwell_fdtd_solver_id)
+{
+    const int zdir = AMREX_SPACEDIM-1;
+    int klo = rB1[0].smallEnd(zdir);
+    int khi = rB1[0].bigEnd(zdir);
+    for (int i = 1; i < 3; ++i) {
+        klo = std::min(klo, rB1[i].smallEnd(zdir));
+        khi = std::max(khi, rB1[i].bigEnd(zdir));
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+#ifdef _OPENMP
+        const int nchunks = omp_get_num_threads();
+        const int ichunk = omp_get_thread_num();
+#else
+        const int nchunks = 1;
+        const int ichunk = 0;
+#endif
+        auto push_b = [&] (const std::array<Box,3>& region, int k)
+        {
+            const Box& tbx = PlaneChunk(region[0], k, ichunk, nchunks);
+            const Box& tby = PlaneChunk(region[1], k, ichunk, nchunks);
+            const Box& tbz = PlaneChunk(region[2], k, ichunk, nchunks);
+            if (!tbx.ok() && !tby.ok() && !tbz.ok()) return;
+            push_bvec(tbx.loVect(), tbx.hiVect(),
+                      tby.loVect(), tby.hiVect(),
+                      tbz.loVect(), tbz.hiVect(),
+                      BL_TO_FORTRAN_3D(exfab),
+                      BL_TO_FORTRAN_3D(eyfab),
+                      BL_TO_FORTRAN_3D(ezfab),
+                      BL_TO_FORTRAN_3D(bxfab),
+                      BL_TO_FORTRAN_3D(byfab),
+                      BL_TO_FORTRAN_3D(bzfab),
+                      &dtsdx[0], &dtsdx[1], &dtsdx[2],
+                      &maxwell_fdtd_solver_id);
+        };
+
+        for (int k = klo; k <= khi+2; ++k)
+        {
+            push_b(rB1, k);  // B^{n+1/2}, from E^n at planes k-1 to k+1
+#ifdef _OPENMP
+#pragma omp barrier
+#endif
+            const Box& tex = PlaneChunk(rE[0], k-1, ichunk, nchunks);
+            const Box& tey = PlaneChunk(rE[1], k-1, ichunk, nchunks);
+            const Box& tez = PlaneChunk(rE[2], k-1, ichunk, nchunks);
+            if (tex.ok() || tey.ok() || tez.ok()) {
+                push_evec(tex.loVect(), tex.hiVect(),
+                          tey.loVect(), tey.hiVect(),
+                          tez.loVect(), tez.hiVect(),
+                          BL_TO_FORTRAN_3D(exfab),
+                          BL_TO_FORTRAN_3D(eyfab),
+                          BL_TO_FORTRAN_3D(ezfab),
+                          BL_TO_FORTRAN_3D(bxfab),
+                          BL_TO_FORTRAN_3D(byfab),
+                          BL_TO_FORTRAN_3D(bzfab),
+                          BL_TO_FORTRAN_3D(jxfab),
+                          BL_TO_FORTRAN_3D(jyfab),
+                          BL_TO_FORTRAN_3D(jzfab),
+                          &mu_c2_dt,
+                          &dtsdx_c2[0], &dtsdx_c2[1], &dtsdx_c2[2]);
+            }
+#ifdef _OPENMP
+#pragma omp barrier
+#endif
+            // B^{n+1}, from E^{n+1} at planes k-3 to k-1. This only writes B at
+            // plane k-2, which the next push of B^{n+1/2} (at plane k+1) does not read.
+            push_b(rB2, k-2);
+        }
+    }
+}
@@ -0,0 +1,253 @@
+#include <algorithm>
+
+#include <AMReX_BoxList.H>
+#include <AMReX_ParallelDescriptor.H>
+
+#include <WarpXFillBoundary.H>
+
+using namespace amrex;
+
+BatchedFillBoundary::~BatchedFillBoundary ()
+{
+#ifdef BL_USE_MPI
+    // Do not free buffers that MPI may still use
+    if (!requests.empty()) {
+        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    }
+#endif
+}
+
+bool
+BatchedFillBoundary::SameLayout (const Vector<MultiFab*>& mfs, const Periodicity& period) const
+{
+    if (!defined || mfs.size() != m_ba.size() || !(period == m_period)) return false;
+    for (int imf = 0; imf < mfs.size(); ++imf)
+    {
+        const MultiFab& mf = *mfs[imf];
+        if (mf.nComp() != m_ncomp[imf] || mf.nGrowVect() != m_ng[imf] ||
+            mf.boxArray() != m_ba[imf] || mf.DistributionMap() != m_dm[imf]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+BatchedFillBoundary::Define (const Vector<MultiFab*>& mfs, const Periodicity& period)
+{
+    BL_PROFILE("BatchedFillBoundary::Define()");
+
+    m_ba.clear();
+    m_dm.clear();
+    m_ng.clear();
+    m_ncomp.clear();
+    local_tags.clear();
+    local_group_start.clear();
+    send_tags.clear();
+    recv_tags.clear();
+    send_buffers.clear();
+    recv_buffers.clear();
+
+    const int myproc = ParallelDescriptor::MyProc();
+    const std::vector<IntVect>& shifts = period.shiftIntVect();
+    std::vector<std::pair<int,Box> > isects;
+
+    for (int imf = 0; imf < mfs.size(); ++imf)
+    {
+        const MultiFab& mf = *mfs[imf];
+        const BoxArray& ba = mf.boxArray();
+        const DistributionMapping& dm = mf.DistributionMap();
+        const IntVect& ng = mf.nGrowVect();
+
+        m_ba.push_back(ba);
+        m_dm.push_back(dm);
+        m_ng.push_back(ng);
+        m_ncomp.push_back(mf.nComp());
+
+        if (ng == IntVect::TheZeroVector()) continue;
+
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+        {
+            const int k = mfi.index();
+
+            // The guard cells of box k filled from the valid cells of the other boxes
+            const Box& gbx = amrex::grow(ba[k], ng);
+            for (const auto& iv : shifts)
+            {
+                ba.intersections(gbx - iv, isects);
+                for (const auto& is : isects)
+                {
+                    const int j = is.first;
+                    const BoxList& bl = amrex::boxDiff(is.second + iv, ba[k]);
+                    for (const Box& dbox : bl)
+                    {
+                        const Tag tag {imf, j, k, dbox, iv};
+                        if (dm[j] == myproc) {
+                            local_tags.push_back(tag);
+                        } else {
+                            recv_tags[dm[j]].push_back(tag);
+                        }
+                    }
+                }
+            }
+
+            // The guard cells of the boxes of other processes filled from box k
+            for (const auto& iv : shifts)
+            {
+                const Box& sbx = ba[k] + iv;
+                ba.intersections(amrex::grow(sbx, ng), isects);
+                for (const auto& is : isects)
+                {
+                    const int i = is.first;
+                    if (dm[i] == myproc) continue;
+                    const BoxList& bl = amrex::boxDiff(amrex::grow(ba[i], ng) & sbx, ba[i]);
+                    for (const Box& dbox : bl)
+                    {
+                        send_tags[dm[i]].push_back(Tag {imf, k, i, dbox, iv});
+                    }
+                }
+            }
+        }
+    }
+
+    // Both sides of a message must list the regions in the same order
+    auto tag_less = [] (const Tag& a, const Tag& b) {
+        if (a.imf != b.imf) return a.imf < b.imf;
+        if (a.src != b.src) return a.src < b.src;
+        if (a.dst != b.dst) return a.dst < b.dst;
+        if (a.shift != b.shift) return a.shift.lexLT(b.shift);
+        return a.dbox.smallEnd().lexLT(b.dbox.smallEnd());
+    };
+    for (auto& kv : send_tags) {
+        std::sort(kv.second.begin(), kv.second.end(), tag_less);
+    }
+    for (auto& kv : recv_tags) {
+        std::sort(kv.second.begin(), kv.second.end(), tag_less);
+    }
+
+    // The copies to the same box are done by the same thread
+    std::stable_sort(local_tags.begin(), local_tags.end(), [] (const Tag& a, const Tag& b) {
+        return (a.imf != b.imf) ? (a.imf < b.imf) : (a.dst < b.dst);
+    });
+    for (int it = 0; it < local_tags.size(); ++it) {
+        if (it == 0 || local_tags[it].imf != local_tags[it-1].imf
+                    || local_tags[it].dst != local_tags[it-1].dst) {
+            local_group_start.push_back(it);
+        }
+    }
+    local_group_start.push_back(local_tags.size());
+
+    m_period = period;
+    defined = true;
+}
+
+void
+BatchedFillBoundary::Start (const Vector<MultiFab*>& mfs, const Periodicity& period)
+{
+    BL_PROFILE("BatchedFillBoundary::Start()");
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!in_progress,
+        "BatchedFillBoundary::Start: the previous exchange is not finished");
+
+    if (!SameLayout(mfs, period)) {
+        Define(mfs, period);
+    }
+    m_mfs = mfs;
+
+#ifdef BL_USE_MPI
+    const int mpi_tag = ParallelDescriptor::SeqNum();
+    MPI_Comm comm = ParallelDescriptor::Communicator();
+    MPI_Datatype mpi_type = ParallelDescriptor::Mpi_typemap<Real>::type();
+
+    for (const auto& kv : recv_tags)
+    {
+        Vector<Real>& buffer = recv_buffers[kv.first];
+        buffer.resize(NumValues(kv.second));
+        requests.push_back(MPI_REQUEST_NULL);
+        MPI_Irecv(buffer.data(), buffer.size(), mpi_type, kv.first, mpi_tag, comm, &requests.back());
+    }
+
+    for (const auto& kv : send_tags)
+    {
+        Vector<Real>& buffer = send_buffers[kv.first];
+        Pack(kv.second, buffer);
+        requests.push_back(MPI_REQUEST_NULL);
+        MPI_Isend(buffer.data(), buffer.size(), mpi_type, kv.first, mpi_tag, comm, &requests.back());
+    }
+#endif
+
+    const int ngroups = local_group_start.size() - 1;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int ig = 0; ig < ngroups; ++ig)
+    {
+        for (int it = local_group_start[ig]; it < local_group_start[ig+1]; ++it)
+        {
+            const Tag& tag = local_tags[it];
+            MultiFab& mf = *m_mfs[tag.imf];
+            Box sbox = tag.dbox;
+            sbox -= tag.shift;
+            mf[tag.dst].copy(mf[tag.src], sbox, 0, tag.dbox, 0, mf.nComp());
+        }
+    }
+
+    in_progress = true;
+}
+
+void
+BatchedFillBoundary::Finish ()
+{
+    BL_PROFILE("BatchedFillBoundary::Finish()");
+
+    if (!in_progress) return;
+
+#ifdef BL_USE_MPI
+    if (!requests.empty()) {
+        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+        requests.clear();
+    }
+#endif
+
+    for (const auto& kv : recv_tags) {
+        Unpack(kv.second, recv_buffers[kv.first]);
+    }
+
+    m_mfs.clear();
+    in_progress = false;
+}
+
+long
+BatchedFillBoundary::NumValues (const Vector<Tag>& tags) const
+{
+    long n = 0;
+    for (const auto& tag : tags) {
+        n += tag.dbox.numPts() * m_mfs[tag.imf]->nComp();
+    }
+    return n;
+}
+
+void
+BatchedFillBoundary::Pack (const Vector<Tag>& tags, Vector<Real>& buffer) const
+{
+    buffer.resize(NumValues(tags));
+    char* p = reinterpret_cast<char*>(buffer.data());
+    for (const auto& tag : tags)
+    {
+        const MultiFab& mf = *m_mfs[tag.imf];
+        Box sbox = tag.dbox;
+        sbox -= tag.shift;
+        p += mf[tag.src].copyToMem(sbox, 0, mf.nComp(), p);
+    }
+}
+
+void
+BatchedFillBoundary::Unpack (const Vector<Tag>& tags, const Vector<Real>& buffer)
+{
+    const char* p = reinterpret_cast<const char*>(buffer.data());
+    for (const auto& tag : tags)
+    {
+        MultiFab& mf = *m_mfs[tag.imf];
+        p += mf[tag.dst].copyFromMem(tag.dbox, 0, mf.nComp(), p);
+    }
+}
@@ -1195,6 +1195,7 @@ WarpX::WritePlotFile () const
     particle_varnames.push_back("momentum_y");
     particle_varnames.push_back("momentum_z");
 
+#ifndef WARPX_TRANSIENT_PARTICLE_FIELDS
     particle_varnames.push_back("Ex");
     particle_varnames.push_back("Ey");
     particle_varnames.push_back("Ez");
@@ -1202,6 +1203,7 @@ WarpX::WritePlotFile () const
     particle_varnames.push_back("Bx");
     particle_varnames.push_back("By");
     particle_varnames.push_back("Bz");
+#endif
 
 #ifdef WARPX_STORE_OLD_PARTICLE_ATTRIBS
     particle_varnames.push_back("xold");
@@ -1212,8 +1214,23 @@ WarpX::WritePlotFile () const
     particle_varnames.push_back("uyold");
     particle_varnames.push_back("uzold");    
 #endif
-    
-    mypc->Checkpoint(plotfilename, true, particle_varnames);
+
+    particle_varnames.push_back("x");
+    particle_varnames.push_back("y");
+    particle_varnames.push_back("z");
+
+#ifdef WARPX_TRANSIENT_PARTICLE_FIELDS
+    // The gathered fields are written after the attributes
+    particle_varnames.push_back("Ex");
+    particle_varnames.push_back("Ey");
+    particle_varnames.push_back("Ez");
+
+    particle_varnames.push_back("Bx");
+    particle_varnames.push_back("By");
+    particle_varnames.push_back("Bz");
+#endif
+
+    mypc->WritePlotFile(plotfilename, particle_varnames);
 
     WriteJobInfo(plotfilename);
 
@@ -1354,7 +1371,7 @@ std::array<std::unique_ptr<MultiFab>, 3> WarpX::getInterpolatedE(int lev) const
     
     const int r_ratio = refRatio(lev-1)[0];
     const int use_limiter = 0;
-#ifdef _OPEMP
+#ifdef _OPENMP
 #pragma omp parallel
 #endif
     {
@@ -1418,7 +1435,7 @@ std::array<std::unique_ptr<MultiFab>, 3> WarpX::getInterpolatedB(int lev) const
     const Real* dx = Geom(lev-1).CellSize();
     const int r_ratio = refRatio(lev-1)[0];
     const int use_limiter = 0;
-#ifdef _OPEMP
+#ifdef _OPENMP
 #pragma omp parallel
 #endif
     {
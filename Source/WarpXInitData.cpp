@@ -126,14 +126,18 @@ WarpX::InitPML ()
 {
     if (do_pml)
     {
+        // With load balancing, the PML boxes follow the grids they border, whose
+        // costs include theirs
+        const int balance_with_grids = (load_balance_int > 0);
         pml[0].reset(new PML(boxArray(0), DistributionMap(0), &Geom(0), nullptr,
-                             pml_ncell, pml_delta, 0, do_dive_cleaning, do_moving_window));
+                             pml_ncell, pml_delta, 0, do_dive_cleaning, do_moving_window,
+                             balance_with_grids));
         for (int lev = 1; lev <= finest_level; ++lev)
         {
             pml[lev].reset(new PML(boxArray(lev), DistributionMap(lev),
                                    &Geom(lev), &Geom(lev-1),
                                    pml_ncell, pml_delta, refRatio(lev-1)[0], do_dive_cleaning,
-                                   do_moving_window));
+                                   do_moving_window, balance_with_grids));
         }
     }
 }
@@ -45,6 +45,8 @@ WarpX::MoveWindow (bool move_j)
 
     if (num_shift_base == 0) return 0;
 
+    aux_is_current = false;
+
     // update the problem domain. Note the we only do this on the base level because
     // amrex::Geometry objects share the same, static RealBox.
     for (int i=0; i<AMREX_SPACEDIM; i++) {
@@ -59,6 +61,23 @@ WarpX::MoveWindow (bool move_j)
     int num_shift      = num_shift_base;
     int num_shift_crse = num_shift;
 
+    // With warpx.deep_halo_steps, E and B are shifted without filling their guard
+    // cells if they are valid deep enough; they are then valid num_shift cells less deep.
+    const IntVect ishift = IntVect::TheDimensionVector(dir)*std::abs(num_shift);
+    const bool fill_eb = (deep_halo_steps == 0) ||
+        !(deep_halo_depth_E - ishift).allGE(IntVect::TheZeroVector()) ||
+        !(deep_halo_depth_B - ishift).allGE(IntVect::TheZeroVector());
+    if (deep_halo_steps > 0)
+    {
+        if (fill_eb) {
+            deep_halo_depth_E = Efield_fp[0][0]->nGrowVect() - ishift;
+            deep_halo_depth_B = Bfield_fp[0][0]->nGrowVect() - ishift;
+        } else {
+            deep_halo_depth_E -= ishift;
+            deep_halo_depth_B -= ishift;
+        }
+    }
+
     // Shift the mesh fields
     for (int lev = 0; lev <= finest_level; ++lev) {
 
@@ -71,8 +90,8 @@ WarpX::MoveWindow (bool move_j)
         for (int dim = 0; dim < 3; ++dim) {
 
             // Fine grid
-            shiftMF(*Bfield_fp[lev][dim], geom[lev], num_shift, dir);
-            shiftMF(*Efield_fp[lev][dim], geom[lev], num_shift, dir);
+            shiftMF(*Bfield_fp[lev][dim], geom[lev], num_shift, dir, fill_eb);
+            shiftMF(*Efield_fp[lev][dim], geom[lev], num_shift, dir, fill_eb);
             if (move_j) {
                 shiftMF(*current_fp[lev][dim], geom[lev], num_shift, dir);
             }
@@ -179,7 +198,8 @@ WarpX::MoveWindow (bool move_j)
 }
 
 void
-WarpX::shiftMF (MultiFab& mf, const Geometry& geom, int num_shift, int dir)
+WarpX::shiftMF (MultiFab& mf, const Geometry& geom, int num_shift, int dir,
+                bool fill_guard_cells)
 {
     const BoxArray& ba = mf.boxArray();
     const DistributionMapping& dm = mf.DistributionMap();
@@ -190,7 +210,9 @@ WarpX::shiftMF (MultiFab& mf, const Geometry& geom, int num_shift, int dir)
 
     MultiFab tmpmf(ba, dm, nc, ng);
     MultiFab::Copy(tmpmf, mf, 0, 0, nc, ng);
-    tmpmf.FillBoundary(geom.periodicity());
+    if (fill_guard_cells) {
+        tmpmf.FillBoundary(geom.periodicity());
+    }
 
     // Make a box that covers the region that the window moved into
     const IndexType& typ = ba.ixType();
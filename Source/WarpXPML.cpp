@@ -81,6 +81,8 @@ SigmaBox::SigmaBox (const Box& box, const BoxArray& grids, const Real* dx, int n
         sigma_star    [idim].resize(sz[idim]  );
         sigma_fac     [idim].resize(sz[idim]+1);
         sigma_star_fac[idim].resize(sz[idim]  );
+        sigma_coef     [idim].resize(sz[idim]+1);
+        sigma_star_coef[idim].resize(sz[idim]  );
 
         sigma         [idim].m_lo = lo[idim];
         sigma         [idim].m_hi = hi[idim]+1;
@@ -90,6 +92,10 @@ SigmaBox::SigmaBox (const Box& box, const BoxArray& grids, const Real* dx, int n
         sigma_fac     [idim].m_hi = hi[idim]+1;
         sigma_star_fac[idim].m_lo = lo[idim];
         sigma_star_fac[idim].m_hi = hi[idim];
+        sigma_coef     [idim].m_lo = lo[idim];
+        sigma_coef     [idim].m_hi = hi[idim]+1;
+        sigma_star_coef[idim].m_lo = lo[idim];
+        sigma_star_coef[idim].m_hi = hi[idim];
     }
 
     Array<Real,AMREX_SPACEDIM> fac;
@@ -266,6 +272,7 @@ SigmaBox::ComputePMLFactorsB (const Real* dx, Real dt)
             {
                 sigma_star_fac[idim][i] = std::exp(-sigma_star[idim][i]*dt);
             }
+            sigma_star_coef[idim][i] = sigma_star_fac[idim][i]*0.5*dt/dx[idim];
         }
     }
 }
@@ -285,6 +292,7 @@ SigmaBox::ComputePMLFactorsE (const Real* dx, Real dt)
             {
                 sigma_fac[idim][i] = std::exp(-sigma[idim][i]*dt);
             }
+            sigma_coef[idim][i] = sigma_fac[idim][i]*PhysConst::c*PhysConst::c*dt/dx[idim];
         }
     }
 }
@@ -329,9 +337,13 @@ MultiSigmaBox::ComputePMLFactorsE (const Real* dx, Real dt)
 
 PML::PML (const BoxArray& grid_ba, const DistributionMapping& grid_dm,
           const Geometry* geom, const Geometry* cgeom,
-          int ncell, int delta, int ref_ratio, int do_dive_cleaning, int do_moving_window)
+          int ncell, int delta, int ref_ratio, int do_dive_cleaning, int do_moving_window,
+          int balance_with_grids)
     : m_geom(geom),
-      m_cgeom(cgeom)
+      m_cgeom(cgeom),
+      m_grid_ba(grid_ba),
+      m_ncell(ncell),
+      m_delta(delta)
 {
     const BoxArray& ba = MakeBoxArray(*geom, grid_ba, ncell);
     if (ba.size() == 0) {
@@ -341,7 +353,9 @@ PML::PML (const BoxArray& grid_ba, const DistributionMapping& grid_dm,
         m_ok = true;
     }
 
-    DistributionMapping dm{ba};
+    m_grid_index_fp = MakeGridIndex(ba, grid_ba, ncell);
+    const DistributionMapping& dm = (balance_with_grids)
+        ? MakeDistributionMap(m_grid_index_fp, grid_dm) : DistributionMapping{ba};
 
     int nge = 2;
     int ngb = 2;
@@ -376,11 +390,15 @@ PML::PML (const BoxArray& grid_ba, const DistributionMapping& grid_dm,
         nge = 1;
         ngb = 1;
 
-        BoxArray grid_cba = grid_ba;
-        grid_cba.coarsen(ref_ratio);
+        m_grid_cba = grid_ba;
+        m_grid_cba.coarsen(ref_ratio);
+        const BoxArray& grid_cba = m_grid_cba;
         const BoxArray& cba = MakeBoxArray(*cgeom, grid_cba, ncell);
 
-        DistributionMapping cdm{cba};
+        // The coarsened grids have the same indices as the grids
+        m_grid_index_cp = MakeGridIndex(cba, grid_cba, ncell);
+        const DistributionMapping& cdm = (balance_with_grids)
+            ? MakeDistributionMap(m_grid_index_cp, grid_dm) : DistributionMapping{cba};
 
         pml_E_cp[0].reset(new MultiFab(amrex::convert(cba,WarpX::Ex_nodal_flag), cdm, 3, nge));
         pml_E_cp[1].reset(new MultiFab(amrex::convert(cba,WarpX::Ey_nodal_flag), cdm, 3, nge));
@@ -467,9 +485,92 @@ PML::MakeBoxArray (const amrex::Geometry& geom, const amrex::BoxArray& grid_ba,
     return ba;
 }
 
+Vector<int>
+PML::MakeGridIndex (const BoxArray& ba, const BoxArray& grid_ba, int ncell)
+{
+    // Each PML box is within ncell cells of the grid it was made from (see
+    // MakeBoxArray); take the grid with the largest overlap within that distance.
+    Vector<int> grid_index(ba.size(), -1);
+    std::vector<std::pair<int,Box> > isects;
+    for (int i = 0, N = ba.size(); i < N; ++i)
+    {
+        grid_ba.intersections(amrex::grow(ba[i], ncell), isects);
+        long npts = 0;
+        for (const auto& is : isects)
+        {
+            const long n = is.second.numPts();
+            if (n > npts || (n == npts && is.first < grid_index[i])) {
+                npts = n;
+                grid_index[i] = is.first;
+            }
+        }
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(grid_index[i] >= 0,
+            "PML::MakeGridIndex: PML box away from the grids");
+    }
+    return grid_index;
+}
+
+DistributionMapping
+PML::MakeDistributionMap (const Vector<int>& grid_index, const DistributionMapping& grid_dm)
+{
+    Vector<int> pmap(grid_index.size());
+    for (int i = 0, N = grid_index.size(); i < N; ++i) {
+        pmap[i] = grid_dm[grid_index[i]];
+    }
+    return DistributionMapping(pmap);
+}
+
+const Vector<int>&
+PML::GridIndex (PatchType patch_type) const
+{
+    return (patch_type == PatchType::fine) ? m_grid_index_fp : m_grid_index_cp;
+}
+
+void
+PML::RemakeDistributionMap (const DistributionMapping& grid_dm)
+{
+    if (!m_ok) return;
+
+    BL_PROFILE("PML::RemakeDistributionMap()");
+
+    auto remake = [] (std::unique_ptr<MultiFab>& mf, const DistributionMapping& dm)
+    {
+        if (mf == nullptr) return;
+        const int nc = mf->nComp();
+        const IntVect& ng = mf->nGrowVect();
+        auto pmf = std::unique_ptr<MultiFab>(new MultiFab(mf->boxArray(), dm, nc, ng));
+        pmf->Redistribute(*mf, 0, 0, nc, ng);
+        mf = std::move(pmf);
+    };
+
+    const DistributionMapping& dm = MakeDistributionMap(m_grid_index_fp, grid_dm);
+    for (int idim = 0; idim < 3; ++idim) {
+        remake(pml_E_fp[idim], dm);
+        remake(pml_B_fp[idim], dm);
+    }
+    remake(pml_F_fp, dm);
+    sigba_fp.reset(new MultiSigmaBox(sigba_fp->boxArray(), dm, m_grid_ba,
+                                     m_geom->CellSize(), m_ncell, m_delta));
+
+    if (sigba_cp)
+    {
+        const DistributionMapping& cdm = MakeDistributionMap(m_grid_index_cp, grid_dm);
+        for (int idim = 0; idim < 3; ++idim) {
+            remake(pml_E_cp[idim], cdm);
+            remake(pml_B_cp[idim], cdm);
+        }
+        remake(pml_F_cp, cdm);
+        sigba_cp.reset(new MultiSigmaBox(sigba_cp->boxArray(), cdm, m_grid_cba,
+                                         m_cgeom->CellSize(), m_ncell, m_delta));
+    }
+
+    if (m_dt > 0.0) ComputePMLFactors(m_dt);
+}
+
 void
 PML::ComputePMLFactors (amrex::Real dt)
 {
+    m_dt = dt;
     if (sigba_fp) {
         sigba_fp->ComputePMLFactorsB(m_geom->CellSize(), dt);
         sigba_fp->ComputePMLFactorsE(m_geom->CellSize(), dt);
@@ -546,8 +647,8 @@ void
 PML::ExchangeE (const std::array<amrex::MultiFab*,3>& E_fp,
                 const std::array<amrex::MultiFab*,3>& E_cp)
 {
-    ExchangeB(PatchType::fine, E_fp);
-    ExchangeB(PatchType::coarse, E_cp);
+    ExchangeE(PatchType::fine, E_fp);
+    ExchangeE(PatchType::coarse, E_cp);
 }
 
 void
@@ -1,43 +1,114 @@
 
+#include <algorithm>
 #include <limits>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <ParticleContainer.H>
 #include <WarpXParticleContainer.H>
 #include <AMReX_AmrParGDB.H>
 #include <WarpX_f.H>
+#include <WarpXParticleKernels.H>
 #include <WarpX.H>
 
 using namespace amrex;
 
 int WarpXParticleContainer::do_not_push = 0;
+int WarpXParticleContainer::use_fused_kernel = 0;
+long WarpXParticleContainer::fused_chunk_size = 256;
+int WarpXParticleContainer::use_tile_coloring = 0;
 
 WarpXParIter::WarpXParIter (ContainerType& pc, int level)
     : ParIter(pc, level, MFItInfo().SetDynamic(WarpX::do_dynamic_scheduling))
 {
 }
 
-#if (AMREX_SPACEDIM == 2)
 void
-WarpXParIter::GetPosition (Vector<Real>& x, Vector<Real>& y, Vector<Real>& z) const
+WarpXParIter::SyncPositionsToAoS ()
 {
-    amrex::ParIter<0,0,PIdx::nattribs>::GetPosition(x, z);
-    y.resize(x.size(), std::numeric_limits<Real>::quiet_NaN());
+    auto& aos = GetArrayOfStructs();
+    const auto& attribs = GetAttribs();
+    const auto& xp = attribs[PIdx::x];
+    const auto& yp = attribs[PIdx::y];
+    const auto& zp = attribs[PIdx::z];
+    const long np = numParticles();
+    for (long i = 0; i < np; ++i) {
+        auto& p = aos[i];
+#if (AMREX_SPACEDIM == 3)
+        p.pos(0) = xp[i];
+        p.pos(1) = yp[i];
+        p.pos(2) = zp[i];
+#elif (AMREX_SPACEDIM == 2)
+        p.pos(0) = xp[i];
+        p.pos(1) = zp[i];
+#endif
+    }
 }
 
 void
-WarpXParIter::SetPosition (const Vector<Real>& x, const Vector<Real>& y, const Vector<Real>& z)
+WarpXParIter::SyncPositionsFromAoS ()
 {
-    amrex::ParIter<0,0,PIdx::nattribs>::SetPosition(x, z);
-}
+    const auto& aos = GetArrayOfStructs();
+    auto& attribs = GetAttribs();
+    auto& xp = attribs[PIdx::x];
+#if (AMREX_SPACEDIM == 3)
+    auto& yp = attribs[PIdx::y];
 #endif
+    auto& zp = attribs[PIdx::z];
+    const long np = numParticles();
+    for (long i = 0; i < np; ++i) {
+        const auto& p = aos[i];
+#if (AMREX_SPACEDIM == 3)
+        xp[i] = p.pos(0);
+        yp[i] = p.pos(1);
+        zp[i] = p.pos(2);
+#elif (AMREX_SPACEDIM == 2)
+        xp[i] = p.pos(0);
+        zp[i] = p.pos(1);
+#endif
+    }
+}
+
+int
+WarpXParIter::TileColor () const
+{
+    // MFIter splits a box into tiles whose sizes differ by at most one cell,
+    // with the larger tiles first. Dividing the offset of a tile by its size
+    // thus gives the index of the tile in each direction.
+    const Box& tbx = tilebox();
+    const Box& vbx = validbox();
+    int color = 0;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const int itile = (tbx.smallEnd(idim) - vbx.smallEnd(idim)) / tbx.length(idim);
+        color |= (itile % 2) << idim;
+    }
+    return color;
+}
 
 WarpXParticleContainer::WarpXParticleContainer (AmrCore* amr_core, int ispecies)
     : ParticleContainer<0,0,PIdx::nattribs>(amr_core->GetParGDB())
     , species_id(ispecies)
 {
+#ifdef WARPX_TRANSIENT_PARTICLE_FIELDS
+#ifdef _OPENMP
+    particle_fields_scratch.resize(omp_get_max_threads());
+#else
+    particle_fields_scratch.resize(1);
+#endif
+#else
     for (unsigned int i = PIdx::Ex; i <= PIdx::Bz; ++i) {
         communicate_real_comp[i] = false; // Don't need to communicate E and B.
     }
+#endif
+    // The positions are sent with the particle structs, and are copied back
+    // to the attributes by SyncPositionsFromAoS in Redistribute.
+    communicate_real_comp[PIdx::x] = false;
+#if (AMREX_SPACEDIM == 3)
+    communicate_real_comp[PIdx::y] = false;
+#endif
+    communicate_real_comp[PIdx::z] = false;
     SetParticleSize();
     ReadParameters();
 }
@@ -53,11 +124,302 @@ WarpXParticleContainer::ReadParameters ()
         do_tiling = true;  // because the default in amrex is false
 	pp.query("do_tiling",  do_tiling);
         pp.query("do_not_push", do_not_push);
+        pp.query("use_fused_kernel", use_fused_kernel);
+        pp.query("fused_chunk_size", fused_chunk_size);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(fused_chunk_size > 0,
+                                         "particles.fused_chunk_size must be positive");
+        pp.query("use_tile_coloring", use_tile_coloring);
         
 	initialized = true;
     }
 }
 
+WarpXParticleContainer::ParticleFieldArrays
+WarpXParticleContainer::GetParticleFields (WarpXParIter& pti)
+{
+    ParticleFieldArrays fields;
+#ifdef WARPX_TRANSIENT_PARTICLE_FIELDS
+#ifdef _OPENMP
+    const int tid = omp_get_thread_num();
+#else
+    const int tid = 0;
+#endif
+    const long np = pti.numParticles();
+    for (int i = 0; i < 6; ++i) {
+        auto& scratch = particle_fields_scratch[tid][i];
+        scratch.resize(np);
+        fields[i] = &scratch;
+    }
+#else
+    auto& attribs = pti.GetAttribs();
+    for (int i = 0; i < 6; ++i) {
+        fields[i] = &attribs[PIdx::Ex+i];
+    }
+#endif
+    return fields;
+}
+
+#ifdef WARPX_TRANSIENT_PARTICLE_FIELDS
+std::array<Vector<Real>, 6>*
+WarpXParticleContainer::GatheredFields (int lev, int grid, int tile)
+{
+    if (lev >= gathered_fields.size()) return nullptr;
+    auto it = gathered_fields[lev].find(std::make_pair(grid, tile));
+    return (it == gathered_fields[lev].end()) ? nullptr : &(it->second);
+}
+#endif
+
+void
+WarpXParticleContainer::WritePlotFile (const std::string& dir, const std::string& name,
+                                       const Vector<std::string>& varnames)
+{
+#ifndef WARPX_TRANSIENT_PARTICLE_FIELDS
+    Checkpoint(dir, name, true, varnames);
+#else
+    // A copy of the particles, with the gathered fields as extra attributes
+    amrex::ParticleContainer<0,0,PIdx::nattribs+6> pc(WarpX::GetInstance().GetParGDB());
+    pc.reserveData();
+    pc.resizeData();
+    for (int lev = 0; lev <= finestLevel(); ++lev)
+    {
+        auto& ptiles = pc.GetParticles(lev);
+        for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+        {
+            const long np = pti.numParticles();
+            auto& ptile = ptiles[std::make_pair(pti.index(), pti.LocalTileIndex())];
+            ptile.GetArrayOfStructs()() = pti.GetArrayOfStructs()();
+            auto& soa = ptile.GetStructOfArrays();
+            const auto& attribs = pti.GetAttribs();
+            for (int comp = 0; comp < PIdx::nattribs; ++comp) {
+                soa.GetRealData(comp) = attribs[comp];
+            }
+            const auto* fields = GatheredFields(lev, pti.index(), pti.LocalTileIndex());
+            for (int i = 0; i < 6; ++i) {
+                if (fields) {
+                    soa.GetRealData(PIdx::nattribs+i) = (*fields)[i];
+                } else {
+                    soa.GetRealData(PIdx::nattribs+i).assign(np, 0.0);
+                }
+            }
+        }
+    }
+    pc.Checkpoint(dir, name, true, varnames);
+#endif
+}
+
+void
+WarpXParticleContainer::SyncPositionsToAoS ()
+{
+    BL_PROFILE("WPC::SyncPositionsToAoS()");
+
+    for (int lev = 0; lev <= finestLevel(); ++lev)
+    {
+        if (NumActiveTiles(lev) == 0) continue;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+        {
+            pti.SyncPositionsToAoS();
+        }
+    }
+}
+
+void
+WarpXParticleContainer::SyncPositionsFromAoS ()
+{
+    BL_PROFILE("WPC::SyncPositionsFromAoS()");
+
+    for (int lev = 0; lev <= finestLevel(); ++lev)
+    {
+        if (NumActiveTiles(lev) == 0) continue;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+        {
+            pti.SyncPositionsFromAoS();
+        }
+    }
+}
+
+void
+WarpXParticleContainer::Redistribute (int lev_min, int lev_max, int nGrow, int local)
+{
+    // The particles may have been added since the last Redistribute
+    MarkActiveTilesDirty();
+    SyncPositionsToAoS();
+    ParticleContainer<0,0,PIdx::nattribs>::Redistribute(lev_min, lev_max, nGrow, local);
+    MarkActiveTilesDirty();
+    SyncPositionsFromAoS();
+#ifdef WARPX_TRANSIENT_PARTICLE_FIELDS
+    ClearGatheredFields();
+#endif
+}
+
+void
+WarpXParticleContainer::SortParticlesByCell (int lev)
+{
+    BL_PROFILE("WPC::SortParticlesByCell()");
+
+    if (NumActiveTiles(lev) == 0) return;
+
+    const Geometry& geom = Geom(lev);
+    const Real* plo = geom.ProbLo();
+    const Real* dxi = geom.InvCellSize();
+    const IntVect& domlo = geom.Domain().smallEnd();
+
+    MultiFab* cost = WarpX::getCosts(lev);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        Vector<long> cell, cell_offset, pid;
+        Vector<Real> tmp;
+        Vector<ParticleType> particle_tmp;
+
+        for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+        {
+            Real wt = amrex::second();
+
+            const long np = pti.numParticles();
+            if (np < 2) continue;
+
+            const Box& tbx = pti.tilebox();
+            const IntVect lo = tbx.smallEnd() - domlo;
+            const IntVect len = tbx.size();
+
+            auto& attribs = pti.GetAttribs();
+            const auto& xp = attribs[PIdx::x];
+            const auto& zp = attribs[PIdx::z];
+#if (AMREX_SPACEDIM == 3)
+            const auto& yp = attribs[PIdx::y];
+#endif
+
+            // Index of the cell of each particle, relative to the tile.
+            // Particles slightly outside of the tile are put in the closest cell.
+            cell.resize(np);
+            for (long ip = 0; ip < np; ++ip)
+            {
+                int i = static_cast<int>(std::floor((xp[ip]-plo[0])*dxi[0])) - lo[0];
+                i = std::min(std::max(i, 0), len[0]-1);
+#if (AMREX_SPACEDIM == 3)
+                int j = static_cast<int>(std::floor((yp[ip]-plo[1])*dxi[1])) - lo[1];
+                j = std::min(std::max(j, 0), len[1]-1);
+                int k = static_cast<int>(std::floor((zp[ip]-plo[2])*dxi[2])) - lo[2];
+                k = std::min(std::max(k, 0), len[2]-1);
+                cell[ip] = i + len[0]*(j + static_cast<long>(len[1])*k);
+#else
+                int k = static_cast<int>(std::floor((zp[ip]-plo[1])*dxi[1])) - lo[1];
+                k = std::min(std::max(k, 0), len[1]-1);
+                cell[ip] = i + static_cast<long>(len[0])*k;
+#endif
+            }
+
+            // Counting sort: pid[ip] is the old index of the particle that goes to ip.
+            const long ncells = tbx.numPts();
+            cell_offset.assign(ncells+1, 0);
+            for (long ip = 0; ip < np; ++ip) {
+                ++cell_offset[cell[ip]+1];
+            }
+            for (long ic = 0; ic < ncells; ++ic) {
+                cell_offset[ic+1] += cell_offset[ic];
+            }
+            pid.resize(np);
+            for (long ip = 0; ip < np; ++ip) {
+                pid[cell_offset[cell[ip]]++] = ip;
+            }
+
+            // Permute the particle structs and all the attributes together
+            auto& aos = pti.GetArrayOfStructs();
+            particle_tmp.resize(np);
+            for (long ip = 0; ip < np; ++ip) {
+                particle_tmp[ip] = aos[pid[ip]];
+            }
+            std::swap(aos(), particle_tmp);
+
+            tmp.resize(np);
+            for (int comp = 0; comp < PIdx::nattribs; ++comp)
+            {
+                auto& attrib = attribs[comp];
+                for (long ip = 0; ip < np; ++ip) {
+                    tmp[ip] = attrib[pid[ip]];
+                }
+                std::swap(attrib, tmp);
+            }
+
+            if (cost) {
+                wt = (amrex::second() - wt) / tbx.d_numPts();
+                (*cost)[pti].plus(wt, tbx);
+            }
+        }
+    }
+}
+
+int
+WarpXParticleContainer::NumTileColors (int ngrow) const
+{
+    if (!use_tile_coloring) return 1;
+    // Two tiles of the same color are separated by at least one tile, whose size is
+    // at least tile_size. Their nodal boxes grown by ngrow do not overlap if the
+    // separating tile is larger than 2*ngrow.
+    if (do_tiling) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            if (tile_size[idim] <= 2*ngrow) return 1;
+        }
+    }
+    return 1 << AMREX_SPACEDIM;
+}
+
+const Vector<std::pair<int,int> >&
+WarpXParticleContainer::ActiveTiles (int lev)
+{
+    if (active_tiles_dirty || lev >= active_tile_index.size()) UpdateActiveTiles();
+    return active_tile_index[lev].tiles;
+}
+
+int
+WarpXParticleContainer::NumActiveTiles (int lev, int color)
+{
+    ActiveTiles(lev);
+    return active_tile_index[lev].num_of_color[color];
+}
+
+int
+WarpXParticleContainer::NumTiles (int lev)
+{
+    ActiveTiles(lev);
+    return active_tile_index[lev].num_tiles;
+}
+
+void
+WarpXParticleContainer::UpdateActiveTiles ()
+{
+    BL_PROFILE("WPC::UpdateActiveTiles()");
+
+    const int nlevs = std::max(0, finestLevel()+1);
+    active_tile_index.resize(nlevs);
+    for (int lev = 0; lev < nlevs; ++lev)
+    {
+        ActiveTileIndex& index = active_tile_index[lev];
+        index.tiles.clear();
+        index.num_of_color.fill(0);
+        index.num_tiles = 0;
+
+        // WarpXParIter only visits the tiles with particles
+        for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+        {
+            index.tiles.push_back(std::make_pair(pti.index(), pti.LocalTileIndex()));
+            ++index.num_of_color[pti.TileColor()];
+        }
+        for (MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi) {
+            ++index.num_tiles;
+        }
+    }
+    active_tiles_dirty = false;
+}
+
 void
 WarpXParticleContainer::AllocData ()
 {
@@ -93,8 +455,13 @@ WarpXParticleContainer::AddOneParticle (ParticleTileType& particle_tile,
     p.pos(1) = z;
 #endif
     
+    std::array<Real,PIdx::nattribs> pattribs = attribs;
+    pattribs[PIdx::x] = x;
+    pattribs[PIdx::y] = y;
+    pattribs[PIdx::z] = z;
+
     particle_tile.push_back(p);
-    particle_tile.push_back_real(attribs);
+    particle_tile.push_back_real(pattribs);
 }
 
 void
@@ -153,8 +520,11 @@ WarpXParticleContainer::AddNParticles (int lev,
         particle_tile.push_back_real(PIdx::ux,     vx + ibegin,     vx + iend);
         particle_tile.push_back_real(PIdx::uy,     vy + ibegin,     vy + iend);
         particle_tile.push_back_real(PIdx::uz,     vz + ibegin,     vz + iend);
+        particle_tile.push_back_real(PIdx::x ,      x + ibegin,      x + iend);
+        particle_tile.push_back_real(PIdx::y ,      y + ibegin,      y + iend);
+        particle_tile.push_back_real(PIdx::z ,      z + ibegin,      z + iend);
         
-        for (int comp = PIdx::uz+1; comp < PIdx::nattribs; ++comp)
+        for (int comp = PIdx::uz+1; comp < PIdx::x; ++comp)
         {
             particle_tile.push_back_real(comp, np, 0.0);
         }
@@ -250,18 +620,19 @@ WarpXParticleContainer::GetChargeDensity (int lev, bool local)
 #pragma omp parallel
 #endif
     {
-        Vector<Real> xp, yp, zp;
-        FArrayBox local_rho;
+        ParticleScratch& scratch = ParticleScratch::ThreadLocal();
+        FArrayBox& local_rho = scratch.local_rho;
 
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
         {
             const Box& box = pti.validbox();
             
             auto& wp = pti.GetAttribs(PIdx::w);
+            const auto& xp = pti.GetAttribs(PIdx::x);
+            const auto& yp = pti.GetAttribs(PIdx::y);
+            const auto& zp = pti.GetAttribs(PIdx::z);
             
             const long np  = pti.numParticles();
-
-            pti.GetPosition(xp, yp, zp);
             
             const std::array<Real,3>& xyzmin_tile = WarpX::LowerCorner(pti.tilebox(), lev);
             const std::array<Real,3>& xyzmin_grid = WarpX::LowerCorner(box, lev);
@@ -274,7 +645,7 @@ WarpXParticleContainer::GetChargeDensity (int lev, bool local)
             Box tile_box = convert(pti.tilebox(), IntVect::TheUnitVector());
             const std::array<Real, 3>& xyzmin = xyzmin_tile;
             tile_box.grow(ng);
-            local_rho.resize(tile_box);
+            scratch.resize(local_rho, tile_box);
             local_rho = 0.0;
             data_ptr = local_rho.dataPtr();
             rholen = local_rho.length();
@@ -299,12 +670,12 @@ WarpXParticleContainer::GetChargeDensity (int lev, bool local)
             long nzg = ng;
             long lvect = 8;
             
-            warpx_charge_deposition(data_ptr,
-                                    &np, xp.data(), yp.data(), zp.data(), wp.data(),
-                                    &this->charge, &xyzmin[0], &xyzmin[1], &xyzmin[2], 
-                                    &dx[0], &dx[1], &dx[2], &nx, &ny, &nz,
-                                    &nxg, &nyg, &nzg, &WarpX::nox,&WarpX::noy,&WarpX::noz,
-                                    &lvect, &WarpX::charge_deposition_algo);
+            ParticleKernels::charge_deposition(data_ptr,
+                                              &np, xp.data(), yp.data(), zp.data(), wp.data(),
+                                              &this->charge, &xyzmin[0], &xyzmin[1], &xyzmin[2], 
+                                              &dx[0], &dx[1], &dx[2], &nx, &ny, &nz,
+                                              &nxg, &nyg, &nzg, &WarpX::nox,&WarpX::noy,&WarpX::noz,
+                                              &lvect, &WarpX::charge_deposition_algo);
             
 #ifdef _OPENMP
             const Box& fabbox = rhofab.box();
@@ -447,6 +818,8 @@ WarpXParticleContainer::PushXES (Real dt)
 #endif
                                          &dt,
                                          prob_domain.lo(), prob_domain.hi());
+
+            pti.SyncPositionsFromAoS();
         }
     }
 }
@@ -463,10 +836,10 @@ void
 WarpXParticleContainer::PushX (int lev, Real dt)
 {
     BL_PROFILE("WPC::PushX()");
-    BL_PROFILE_VAR_NS("WPC::PushX::Copy", blp_copy);
     BL_PROFILE_VAR_NS("WPC:PushX::Push", blp_pxr_pp);
 
     if (do_not_push) return;
+    if (NumActiveTiles(lev) == 0) return;
 
     MultiFab* cost = WarpX::getCosts(lev);
 
@@ -474,7 +847,8 @@ WarpXParticleContainer::PushX (int lev, Real dt)
 #pragma omp parallel
 #endif
     {
-        Vector<Real> xp, yp, zp, giv;
+        ParticleScratch& scratch = ParticleScratch::ThreadLocal();
+        Vector<Real>& giv = scratch.giv;
 
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
         {
@@ -482,35 +856,24 @@ WarpXParticleContainer::PushX (int lev, Real dt)
 
             auto& attribs = pti.GetAttribs();
 
+            auto& xp = attribs[PIdx::x];
+            auto& yp = attribs[PIdx::y];
+            auto& zp = attribs[PIdx::z];
             auto& uxp = attribs[PIdx::ux];
             auto& uyp = attribs[PIdx::uy];
             auto& uzp = attribs[PIdx::uz];
             
             const long np = pti.numParticles();
             
-            giv.resize(np);
-            
-            //
-            // copy data from particle container to temp arrays
-            //
-            BL_PROFILE_VAR_START(blp_copy);
-            pti.GetPosition(xp, yp, zp);
-            BL_PROFILE_VAR_STOP(blp_copy);
+            scratch.resize(giv, np);
             
             //
             // Particle Push
             //
             BL_PROFILE_VAR_START(blp_pxr_pp);
-            warpx_particle_pusher_positions(&np, xp.data(), yp.data(), zp.data(),
-                                            uxp.data(), uyp.data(), uzp.data(), giv.data(), &dt);
+            ParticleKernels::particle_pusher_positions(&np, xp.data(), yp.data(), zp.data(),
+                                                       uxp.data(), uyp.data(), uzp.data(), giv.data(), &dt);
             BL_PROFILE_VAR_STOP(blp_pxr_pp);
-            
-            //
-            // copy particle data back
-            //
-            BL_PROFILE_VAR_START(blp_copy);
-            pti.SetPosition(xp, yp, zp);
-            BL_PROFILE_VAR_STOP(blp_copy);
 
             if (cost) {
                 const Box& tbx = pti.tilebox();
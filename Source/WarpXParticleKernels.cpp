@@ -0,0 +1,679 @@
+#include <cmath>
+
+#include <AMReX.H>
+
+#include <WarpXParticleKernels.H>
+
+using namespace amrex;
+
+namespace ParticleKernels
+{
+    GatherFn            geteb_energy_conserving = warpx_geteb_energy_conserving;
+    CurrentDepositionFn current_deposition      = warpx_current_deposition;
+    ChargeDepositionFn  charge_deposition       = warpx_charge_deposition;
+}
+
+namespace
+{
+    constexpr Real one_third = 1.0/3.0;
+    constexpr Real one_sixth = 1.0/6.0;
+
+    //
+    // Shape factors of a particle at position x, in grid units relative to the nodes.
+    // compute fills sx[0..order] and returns the index of the node of sx[0].
+    //
+    template <int order> struct Shape;
+
+    template <> struct Shape<0>
+    {
+        static int compute (Real* sx, Real x)
+        {
+            const int j = static_cast<int>(std::floor(x + 0.5));
+            sx[0] = 1.0;
+            return j;
+        }
+    };
+
+    template <> struct Shape<1>
+    {
+        static int compute (Real* sx, Real x)
+        {
+            const int j = static_cast<int>(std::floor(x));
+            const Real xint = x - j;
+            sx[0] = 1.0 - xint;
+            sx[1] = xint;
+            return j;
+        }
+    };
+
+    template <> struct Shape<2>
+    {
+        static int compute (Real* sx, Real x)
+        {
+            const int j = static_cast<int>(std::floor(x + 0.5));
+            const Real xint = x - j;
+            sx[0] = 0.5*(0.5 - xint)*(0.5 - xint);
+            sx[1] = 0.75 - xint*xint;
+            sx[2] = 0.5*(0.5 + xint)*(0.5 + xint);
+            return j - 1;
+        }
+    };
+
+    template <> struct Shape<3>
+    {
+        static int compute (Real* sx, Real x)
+        {
+            const int j = static_cast<int>(std::floor(x));
+            const Real xint = x - j;
+            const Real oxint = 1.0 - xint;
+            sx[0] = one_sixth*oxint*oxint*oxint;
+            sx[1] = 2.0/3.0 - xint*xint*(1.0 - 0.5*xint);
+            sx[2] = 2.0/3.0 - oxint*oxint*(1.0 - 0.5*oxint);
+            sx[3] = one_sixth*xint*xint*xint;
+            return j - 1;
+        }
+    };
+
+    //
+    // Shape factors at the new and old positions of a particle, on a common stencil
+    // of order+3 nodes starting at node i_new-1 (s_new and s_old must be zeroed).
+    // The particle must have moved by less than one cell.
+    //
+    template <int order>
+    void EsirkepovShapes (Real x_new, Real x_old, Real* s_new, Real* s_old,
+                          int& i_new, int& i_old)
+    {
+        Real s[order+1];
+        i_new = Shape<order>::compute(s, x_new);
+        for (int m = 0; m <= order; ++m) s_new[m+1] = s[m];
+        i_old = Shape<order>::compute(s, x_old);
+        const int shift = i_old - i_new;
+        for (int m = 0; m <= order; ++m) s_old[m+1+shift] = s[m];
+    }
+
+    // Read-only view of a Fortran-ordered array with bounds lo:hi
+    struct ConstArrayView
+    {
+        ConstArrayView (const Real* a_p, const int* lo, const int* hi)
+            : p(a_p), lo0(lo[0]), lo1(lo[1])
+            , nx(hi[0]-lo[0]+1)
+#if (AMREX_SPACEDIM == 3)
+            , lo2(lo[2]), nxy(static_cast<long>(nx)*(hi[1]-lo[1]+1))
+#endif
+            {}
+
+#if (AMREX_SPACEDIM == 3)
+        const Real& operator() (int i, int j, int k) const {
+            return p[(i-lo0) + (j-lo1)*nx + (k-lo2)*nxy];
+        }
+#else
+        const Real& operator() (int i, int k) const {
+            return p[(i-lo0) + (k-lo1)*nx];
+        }
+#endif
+
+        const Real* p;
+        int lo0, lo1;
+        long nx;
+#if (AMREX_SPACEDIM == 3)
+        int lo2;
+        long nxy;
+#endif
+    };
+
+    // View of a deposition array with ng guard cells and ntot points in each direction,
+    // indexed relative to its first valid point.
+    struct DepositionView
+    {
+        DepositionView (Real* a_p, const long* ng, const long* ntot)
+            : p(a_p)
+#if (AMREX_SPACEDIM == 3)
+            , offset(ng[0] + ng[1]*ntot[0] + ng[2]*ntot[0]*ntot[1])
+            , nx(ntot[0]), nxy(ntot[0]*ntot[1])
+#else
+            , offset(ng[0] + ng[1]*ntot[0])
+            , nx(ntot[0])
+#endif
+            {}
+
+#if (AMREX_SPACEDIM == 3)
+        Real& operator() (int i, int j, int k) const {
+            return p[offset + i + j*nx + k*nxy];
+        }
+#else
+        Real& operator() (int i, int k) const {
+            return p[offset + i + k*nx];
+        }
+#endif
+
+        Real* p;
+        long offset;
+        long nx;
+#if (AMREX_SPACEDIM == 3)
+        long nxy;
+#endif
+    };
+
+    DepositionView MakeCurrentView (Real* j, const long* ng, const int* ntot)
+    {
+        const long ngs[AMREX_SPACEDIM] = {D_DECL(*ng, *ng, *ng)};
+        const long ntots[AMREX_SPACEDIM] = {D_DECL(ntot[0], ntot[1], ntot[2])};
+        return DepositionView(j, ngs, ntots);
+    }
+
+#if (AMREX_SPACEDIM == 3)
+
+    //
+    // Energy-conserving field gathering, with shape factors of order `order` along
+    // the nodal directions and `order_v` along the staggered directions of each component.
+    //
+    template <int order, int order_v>
+    void GatherEB (long np, const Real* xp, const Real* yp, const Real* zp,
+                   Real* ex, Real* ey, Real* ez, Real* bx, Real* by, Real* bz,
+                   const int* ixyzmin, Real xmin, Real ymin, Real zmin,
+                   Real dx, Real dy, Real dz,
+                   const ConstArrayView& exg, const ConstArrayView& eyg, const ConstArrayView& ezg,
+                   const ConstArrayView& bxg, const ConstArrayView& byg, const ConstArrayView& bzg)
+    {
+        const Real dxi = 1.0/dx, dyi = 1.0/dy, dzi = 1.0/dz;
+
+        for (long ip = 0; ip < np; ++ip)
+        {
+            const Real x = (xp[ip]-xmin)*dxi;
+            const Real y = (yp[ip]-ymin)*dyi;
+            const Real z = (zp[ip]-zmin)*dzi;
+
+            Real sx[order+1], sy[order+1], sz[order+1];
+            Real sx0[order_v+1], sy0[order_v+1], sz0[order_v+1];
+            const int j  = Shape<order  >::compute(sx , x    ) + ixyzmin[0];
+            const int k  = Shape<order  >::compute(sy , y    ) + ixyzmin[1];
+            const int l  = Shape<order  >::compute(sz , z    ) + ixyzmin[2];
+            const int j0 = Shape<order_v>::compute(sx0, x-0.5) + ixyzmin[0];
+            const int k0 = Shape<order_v>::compute(sy0, y-0.5) + ixyzmin[1];
+            const int l0 = Shape<order_v>::compute(sz0, z-0.5) + ixyzmin[2];
+
+            Real exi = 0.0, eyi = 0.0, ezi = 0.0;
+            Real bxi = 0.0, byi = 0.0, bzi = 0.0;
+
+            for (int iz = 0; iz <= order; ++iz) {
+                for (int iy = 0; iy <= order; ++iy) {
+                    for (int ix = 0; ix <= order_v; ++ix) {
+                        exi += sx0[ix]*sy[iy]*sz[iz]*exg(j0+ix, k+iy, l+iz);
+                    }
+                }
+            }
+            for (int iz = 0; iz <= order; ++iz) {
+                for (int iy = 0; iy <= order_v; ++iy) {
+                    for (int ix = 0; ix <= order; ++ix) {
+                        eyi += sx[ix]*sy0[iy]*sz[iz]*eyg(j+ix, k0+iy, l+iz);
+                    }
+                }
+            }
+            for (int iz = 0; iz <= order_v; ++iz) {
+                for (int iy = 0; iy <= order; ++iy) {
+                    for (int ix = 0; ix <= order; ++ix) {
+                        ezi += sx[ix]*sy[iy]*sz0[iz]*ezg(j+ix, k+iy, l0+iz);
+                    }
+                }
+            }
+            for (int iz = 0; iz <= order_v; ++iz) {
+                for (int iy = 0; iy <= order_v; ++iy) {
+                    for (int ix = 0; ix <= order; ++ix) {
+                        bxi += sx[ix]*sy0[iy]*sz0[iz]*bxg(j+ix, k0+iy, l0+iz);
+                    }
+                }
+            }
+            for (int iz = 0; iz <= order_v; ++iz) {
+                for (int iy = 0; iy <= order; ++iy) {
+                    for (int ix = 0; ix <= order_v; ++ix) {
+                        byi += sx0[ix]*sy[iy]*sz0[iz]*byg(j0+ix, k+iy, l0+iz);
+                    }
+                }
+            }
+            for (int iz = 0; iz <= order; ++iz) {
+                for (int iy = 0; iy <= order_v; ++iy) {
+                    for (int ix = 0; ix <= order_v; ++ix) {
+                        bzi += sx0[ix]*sy0[iy]*sz[iz]*bzg(j0+ix, k0+iy, l+iz);
+                    }
+                }
+            }
+
+            ex[ip] += exi;
+            ey[ip] += eyi;
+            ez[ip] += ezi;
+            bx[ip] += bxi;
+            by[ip] += byi;
+            bz[ip] += bzi;
+        }
+    }
+
+    //
+    // Direct current deposition: rho*v at time n+1/2
+    //
+    template <int order>
+    void DepositCurrentDirect (long np, const Real* xp, const Real* yp, const Real* zp,
+                               const Real* uxp, const Real* uyp, const Real* uzp,
+                               const Real* gip, const Real* w, Real q,
+                               Real xmin, Real ymin, Real zmin, Real dt,
+                               Real dx, Real dy, Real dz,
+                               const DepositionView& jx, const DepositionView& jy,
+                               const DepositionView& jz)
+    {
+        const Real dxi = 1.0/dx, dyi = 1.0/dy, dzi = 1.0/dz;
+        const Real invvol = dxi*dyi*dzi;
+        const Real dts2dx = 0.5*dt*dxi, dts2dy = 0.5*dt*dyi, dts2dz = 0.5*dt*dzi;
+
+        for (long ip = 0; ip < np; ++ip)
+        {
+            const Real vx = uxp[ip]*gip[ip];
+            const Real vy = uyp[ip]*gip[ip];
+            const Real vz = uzp[ip]*gip[ip];
+            const Real wq = q*w[ip]*invvol;
+            const Real wqx = wq*vx, wqy = wq*vy, wqz = wq*vz;
+
+            const Real xmid = (xp[ip]-xmin)*dxi - dts2dx*vx;
+            const Real ymid = (yp[ip]-ymin)*dyi - dts2dy*vy;
+            const Real zmid = (zp[ip]-zmin)*dzi - dts2dz*vz;
+
+            Real sx[order+1], sy[order+1], sz[order+1];
+            Real sx0[order+1], sy0[order+1], sz0[order+1];
+            const int j  = Shape<order>::compute(sx , xmid    );
+            const int k  = Shape<order>::compute(sy , ymid    );
+            const int l  = Shape<order>::compute(sz , zmid    );
+            const int j0 = Shape<order>::compute(sx0, xmid-0.5);
+            const int k0 = Shape<order>::compute(sy0, ymid-0.5);
+            const int l0 = Shape<order>::compute(sz0, zmid-0.5);
+
+            for (int iz = 0; iz <= order; ++iz) {
+                for (int iy = 0; iy <= order; ++iy) {
+                    for (int ix = 0; ix <= order; ++ix) {
+                        jx(j0+ix, k+iy, l+iz) += sx0[ix]*sy[iy]*sz[iz]*wqx;
+                        jy(j+ix, k0+iy, l+iz) += sx[ix]*sy0[iy]*sz[iz]*wqy;
+                        jz(j+ix, k+iy, l0+iz) += sx[ix]*sy[iy]*sz0[iz]*wqz;
+                    }
+                }
+            }
+        }
+    }
+
+    //
+    // Esirkepov (charge-conserving) current deposition, from the positions at
+    // time n (x - v*dt) to the positions at time n+1 (x)
+    //
+    template <int order>
+    void DepositCurrentEsirkepov (long np, const Real* xp, const Real* yp, const Real* zp,
+                                  const Real* uxp, const Real* uyp, const Real* uzp,
+                                  const Real* gip, const Real* w, Real q,
+                                  Real xmin, Real ymin, Real zmin, Real dt,
+                                  Real dx, Real dy, Real dz,
+                                  const DepositionView& jx, const DepositionView& jy,
+                                  const DepositionView& jz)
+    {
+        const Real dxi = 1.0/dx, dyi = 1.0/dy, dzi = 1.0/dz;
+        const Real invdtdx = 1.0/(dt*dy*dz);
+        const Real invdtdy = 1.0/(dt*dx*dz);
+        const Real invdtdz = 1.0/(dt*dx*dy);
+
+        for (long ip = 0; ip < np; ++ip)
+        {
+            const Real vx = uxp[ip]*gip[ip];
+            const Real vy = uyp[ip]*gip[ip];
+            const Real vz = uzp[ip]*gip[ip];
+            const Real wq = q*w[ip];
+            const Real wqx = wq*invdtdx, wqy = wq*invdtdy, wqz = wq*invdtdz;
+
+            const Real x_new = (xp[ip]-xmin)*dxi;
+            const Real y_new = (yp[ip]-ymin)*dyi;
+            const Real z_new = (zp[ip]-zmin)*dzi;
+            const Real x_old = x_new - dt*dxi*vx;
+            const Real y_old = y_new - dt*dyi*vy;
+            const Real z_old = z_new - dt*dzi*vz;
+
+            Real sx_new[order+3] = {}, sx_old[order+3] = {};
+            Real sy_new[order+3] = {}, sy_old[order+3] = {};
+            Real sz_new[order+3] = {}, sz_old[order+3] = {};
+            int i_new, i_old, j_new, j_old, k_new, k_old;
+            EsirkepovShapes<order>(x_new, x_old, sx_new, sx_old, i_new, i_old);
+            EsirkepovShapes<order>(y_new, y_old, sy_new, sy_old, j_new, j_old);
+            EsirkepovShapes<order>(z_new, z_old, sz_new, sz_old, k_new, k_old);
+
+            // Skip the end of the stencil that is zero for both positions
+            const int dil = (i_old < i_new) ? 0 : 1;
+            const int diu = (i_old > i_new) ? 0 : 1;
+            const int djl = (j_old < j_new) ? 0 : 1;
+            const int dju = (j_old > j_new) ? 0 : 1;
+            const int dkl = (k_old < k_new) ? 0 : 1;
+            const int dku = (k_old > k_new) ? 0 : 1;
+
+            for (int k = dkl; k <= order+2-dku; ++k) {
+                for (int j = djl; j <= order+2-dju; ++j) {
+                    Real sdxi = 0.0;
+                    for (int i = dil; i <= order+1-diu; ++i) {
+                        sdxi += wqx*(sx_old[i]-sx_new[i])*(
+                            one_third*(sy_new[j]*sz_new[k] + sy_old[j]*sz_old[k])
+                          + one_sixth*(sy_new[j]*sz_old[k] + sy_old[j]*sz_new[k]));
+                        jx(i_new-1+i, j_new-1+j, k_new-1+k) += sdxi;
+                    }
+                }
+            }
+            for (int k = dkl; k <= order+2-dku; ++k) {
+                for (int i = dil; i <= order+2-diu; ++i) {
+                    Real sdyj = 0.0;
+                    for (int j = djl; j <= order+1-dju; ++j) {
+                        sdyj += wqy*(sy_old[j]-sy_new[j])*(
+                            one_third*(sx_new[i]*sz_new[k] + sx_old[i]*sz_old[k])
+                          + one_sixth*(sx_new[i]*sz_old[k] + sx_old[i]*sz_new[k]));
+                        jy(i_new-1+i, j_new-1+j, k_new-1+k) += sdyj;
+                    }
+                }
+            }
+            for (int j = djl; j <= order+2-dju; ++j) {
+                for (int i = dil; i <= order+2-diu; ++i) {
+                    Real sdzk = 0.0;
+                    for (int k = dkl; k <= order+1-dku; ++k) {
+                        sdzk += wqz*(sz_old[k]-sz_new[k])*(
+                            one_third*(sx_new[i]*sy_new[j] + sx_old[i]*sy_old[j])
+                          + one_sixth*(sx_new[i]*sy_old[j] + sx_old[i]*sy_new[j]));
+                        jz(i_new-1+i, j_new-1+j, k_new-1+k) += sdzk;
+                    }
+                }
+            }
+        }
+    }
+
+    template <int order>
+    void DepositCharge (long np, const Real* xp, const Real* yp, const Real* zp,
+                        const Real* w, Real q, Real xmin, Real ymin, Real zmin,
+                        Real dx, Real dy, Real dz, const DepositionView& rho)
+    {
+        const Real dxi = 1.0/dx, dyi = 1.0/dy, dzi = 1.0/dz;
+        const Real invvol = dxi*dyi*dzi;
+
+        for (long ip = 0; ip < np; ++ip)
+        {
+            const Real wq = q*w[ip]*invvol;
+            Real sx[order+1], sy[order+1], sz[order+1];
+            const int j = Shape<order>::compute(sx, (xp[ip]-xmin)*dxi);
+            const int k = Shape<order>::compute(sy, (yp[ip]-ymin)*dyi);
+            const int l = Shape<order>::compute(sz, (zp[ip]-zmin)*dzi);
+            for (int iz = 0; iz <= order; ++iz) {
+                for (int iy = 0; iy <= order; ++iy) {
+                    for (int ix = 0; ix <= order; ++ix) {
+                        rho(j+ix, k+iy, l+iz) += sx[ix]*sy[iy]*sz[iz]*wq;
+                    }
+                }
+            }
+        }
+    }
+
+#elif (AMREX_SPACEDIM == 2)
+
+    template <int order, int order_v>
+    void GatherEB (long np, const Real* xp, const Real* /*yp*/, const Real* zp,
+                   Real* ex, Real* ey, Real* ez, Real* bx, Real* by, Real* bz,
+                   const int* ixyzmin, Real xmin, Real /*ymin*/, Real zmin,
+                   Real dx, Real /*dy*/, Real dz,
+                   const ConstArrayView& exg, const ConstArrayView& eyg, const ConstArrayView& ezg,
+                   const ConstArrayView& bxg, const ConstArrayView& byg, const ConstArrayView& bzg)
+    {
+        const Real dxi = 1.0/dx, dzi = 1.0/dz;
+
+        for (long ip = 0; ip < np; ++ip)
+        {
+            const Real x = (xp[ip]-xmin)*dxi;
+            const Real z = (zp[ip]-zmin)*dzi;
+
+            Real sx[order+1], sz[order+1];
+            Real sx0[order_v+1], sz0[order_v+1];
+            const int j  = Shape<order  >::compute(sx , x    ) + ixyzmin[0];
+            const int l  = Shape<order  >::compute(sz , z    ) + ixyzmin[1];
+            const int j0 = Shape<order_v>::compute(sx0, x-0.5) + ixyzmin[0];
+            const int l0 = Shape<order_v>::compute(sz0, z-0.5) + ixyzmin[1];
+
+            Real exi = 0.0, eyi = 0.0, ezi = 0.0;
+            Real bxi = 0.0, byi = 0.0, bzi = 0.0;
+
+            for (int iz = 0; iz <= order; ++iz) {
+                for (int ix = 0; ix <= order_v; ++ix) {
+                    exi += sx0[ix]*sz[iz]*exg(j0+ix, l+iz);
+                    bzi += sx0[ix]*sz[iz]*bzg(j0+ix, l+iz);
+                }
+                for (int ix = 0; ix <= order; ++ix) {
+                    eyi += sx[ix]*sz[iz]*eyg(j+ix, l+iz);
+                }
+            }
+            for (int iz = 0; iz <= order_v; ++iz) {
+                for (int ix = 0; ix <= order; ++ix) {
+                    ezi += sx[ix]*sz0[iz]*ezg(j+ix, l0+iz);
+                    bxi += sx[ix]*sz0[iz]*bxg(j+ix, l0+iz);
+                }
+                for (int ix = 0; ix <= order_v; ++ix) {
+                    byi += sx0[ix]*sz0[iz]*byg(j0+ix, l0+iz);
+                }
+            }
+
+            ex[ip] += exi;
+            ey[ip] += eyi;
+            ez[ip] += ezi;
+            bx[ip] += bxi;
+            by[ip] += byi;
+            bz[ip] += bzi;
+        }
+    }
+
+    template <int order>
+    void DepositCurrentEsirkepov (long np, const Real* xp, const Real* /*yp*/, const Real* zp,
+                                  const Real* uxp, const Real* uyp, const Real* uzp,
+                                  const Real* gip, const Real* w, Real q,
+                                  Real xmin, Real /*ymin*/, Real zmin, Real dt,
+                                  Real dx, Real /*dy*/, Real dz,
+                                  const DepositionView& jx, const DepositionView& jy,
+                                  const DepositionView& jz)
+    {
+        const Real dxi = 1.0/dx, dzi = 1.0/dz;
+        const Real invdtdx = 1.0/(dt*dz);
+        const Real invdtdz = 1.0/(dt*dx);
+        const Real invvol = dxi*dzi;
+
+        for (long ip = 0; ip < np; ++ip)
+        {
+            const Real vx = uxp[ip]*gip[ip];
+            const Real vy = uyp[ip]*gip[ip];
+            const Real vz = uzp[ip]*gip[ip];
+            const Real wq = q*w[ip];
+            const Real wqx = wq*invdtdx, wqy = wq*vy*invvol, wqz = wq*invdtdz;
+
+            const Real x_new = (xp[ip]-xmin)*dxi;
+            const Real z_new = (zp[ip]-zmin)*dzi;
+            const Real x_old = x_new - dt*dxi*vx;
+            const Real z_old = z_new - dt*dzi*vz;
+
+            Real sx_new[order+3] = {}, sx_old[order+3] = {};
+            Real sz_new[order+3] = {}, sz_old[order+3] = {};
+            int i_new, i_old, k_new, k_old;
+            EsirkepovShapes<order>(x_new, x_old, sx_new, sx_old, i_new, i_old);
+            EsirkepovShapes<order>(z_new, z_old, sz_new, sz_old, k_new, k_old);
+
+            // Skip the end of the stencil that is zero for both positions
+            const int dil = (i_old < i_new) ? 0 : 1;
+            const int diu = (i_old > i_new) ? 0 : 1;
+            const int dkl = (k_old < k_new) ? 0 : 1;
+            const int dku = (k_old > k_new) ? 0 : 1;
+
+            for (int k = dkl; k <= order+2-dku; ++k) {
+                Real sdxi = 0.0;
+                for (int i = dil; i <= order+1-diu; ++i) {
+                    sdxi += wqx*(sx_old[i]-sx_new[i])*0.5*(sz_new[k] + sz_old[k]);
+                    jx(i_new-1+i, k_new-1+k) += sdxi;
+                }
+            }
+            for (int k = dkl; k <= order+2-dku; ++k) {
+                for (int i = dil; i <= order+2-diu; ++i) {
+                    jy(i_new-1+i, k_new-1+k) += wqy*(
+                        one_third*(sx_new[i]*sz_new[k] + sx_old[i]*sz_old[k])
+                      + one_sixth*(sx_new[i]*sz_old[k] + sx_old[i]*sz_new[k]));
+                }
+            }
+            for (int i = dil; i <= order+2-diu; ++i) {
+                Real sdzk = 0.0;
+                for (int k = dkl; k <= order+1-dku; ++k) {
+                    sdzk += wqz*(sz_old[k]-sz_new[k])*0.5*(sx_new[i] + sx_old[i]);
+                    jz(i_new-1+i, k_new-1+k) += sdzk;
+                }
+            }
+        }
+    }
+
+    template <int order>
+    void DepositCharge (long np, const Real* xp, const Real* /*yp*/, const Real* zp,
+                        const Real* w, Real q, Real xmin, Real /*ymin*/, Real zmin,
+                        Real dx, Real /*dy*/, Real dz, const DepositionView& rho)
+    {
+        const Real dxi = 1.0/dx, dzi = 1.0/dz;
+        const Real invvol = dxi*dzi;
+
+        for (long ip = 0; ip < np; ++ip)
+        {
+            const Real wq = q*w[ip]*invvol;
+            Real sx[order+1], sz[order+1];
+            const int j = Shape<order>::compute(sx, (xp[ip]-xmin)*dxi);
+            const int l = Shape<order>::compute(sz, (zp[ip]-zmin)*dzi);
+            for (int iz = 0; iz <= order; ++iz) {
+                for (int ix = 0; ix <= order; ++ix) {
+                    rho(j+ix, l+iz) += sx[ix]*sz[iz]*wq;
+                }
+            }
+        }
+    }
+
+#endif
+
+    //
+    // Entry points with the same interface as the PICSAR wrappers in WarpX_f.H
+    //
+    template <int order>
+    void NativeGetEB (const long* np,
+                      const Real* xp, const Real* yp, const Real* zp,
+                      Real* ex, Real* ey, Real* ez, Real* bx, Real* by, Real* bz,
+                      const int* ixyzmin,
+                      const Real* xmin, const Real* ymin, const Real* zmin,
+                      const Real* dx, const Real* dy, const Real* dz,
+                      const long* /*nox*/, const long* /*noy*/, const long* /*noz*/,
+                      const Real* exg, const int* exg_lo, const int* exg_hi,
+                      const Real* eyg, const int* eyg_lo, const int* eyg_hi,
+                      const Real* ezg, const int* ezg_lo, const int* ezg_hi,
+                      const Real* bxg, const int* bxg_lo, const int* bxg_hi,
+                      const Real* byg, const int* byg_lo, const int* byg_hi,
+                      const Real* bzg, const int* bzg_lo, const int* bzg_hi,
+                      const int* /*ll4symtry*/, const int* l_lower_order_in_v,
+                      const long* /*lvect*/, const long* /*field_gathe_algo*/)
+    {
+        const ConstArrayView exv(exg, exg_lo, exg_hi);
+        const ConstArrayView eyv(eyg, eyg_lo, eyg_hi);
+        const ConstArrayView ezv(ezg, ezg_lo, ezg_hi);
+        const ConstArrayView bxv(bxg, bxg_lo, bxg_hi);
+        const ConstArrayView byv(byg, byg_lo, byg_hi);
+        const ConstArrayView bzv(bzg, bzg_lo, bzg_hi);
+
+        if (*l_lower_order_in_v) {
+            GatherEB<order,order-1>(*np, xp, yp, zp, ex, ey, ez, bx, by, bz,
+                                    ixyzmin, *xmin, *ymin, *zmin, *dx, *dy, *dz,
+                                    exv, eyv, ezv, bxv, byv, bzv);
+        } else {
+            GatherEB<order,order>(*np, xp, yp, zp, ex, ey, ez, bx, by, bz,
+                                  ixyzmin, *xmin, *ymin, *zmin, *dx, *dy, *dz,
+                                  exv, eyv, ezv, bxv, byv, bzv);
+        }
+    }
+
+    template <int order, bool esirkepov>
+    void NativeCurrentDeposition (Real* jx, const long* jx_ng, const int* jx_ntot,
+                                  Real* jy, const long* jy_ng, const int* jy_ntot,
+                                  Real* jz, const long* jz_ng, const int* jz_ntot,
+                                  const long* np,
+                                  const Real* xp, const Real* yp, const Real* zp,
+                                  const Real* uxp, const Real* uyp, const Real* uzp,
+                                  const Real* gip, const Real* w, const Real* q,
+                                  const Real* xmin, const Real* ymin, const Real* zmin,
+                                  const Real* dt,
+                                  const Real* dx, const Real* dy, const Real* dz,
+                                  const long* /*nox*/, const long* /*noy*/, const long* /*noz*/,
+                                  const long* /*lvect*/, const long* /*current_depo_algo*/)
+    {
+        const DepositionView jxv = MakeCurrentView(jx, jx_ng, jx_ntot);
+        const DepositionView jyv = MakeCurrentView(jy, jy_ng, jy_ntot);
+        const DepositionView jzv = MakeCurrentView(jz, jz_ng, jz_ntot);
+
+#if (AMREX_SPACEDIM == 3)
+        if (!esirkepov) {
+            DepositCurrentDirect<order>(*np, xp, yp, zp, uxp, uyp, uzp, gip, w, *q,
+                                        *xmin, *ymin, *zmin, *dt, *dx, *dy, *dz,
+                                        jxv, jyv, jzv);
+            return;
+        }
+#endif
+        DepositCurrentEsirkepov<order>(*np, xp, yp, zp, uxp, uyp, uzp, gip, w, *q,
+                                       *xmin, *ymin, *zmin, *dt, *dx, *dy, *dz,
+                                       jxv, jyv, jzv);
+    }
+
+    template <int order>
+    void NativeChargeDeposition (Real* rho, const long* np,
+                                 const Real* xp, const Real* yp, const Real* zp, const Real* w,
+                                 const Real* q, const Real* xmin, const Real* ymin, const Real* zmin,
+                                 const Real* dx, const Real* dy, const Real* dz,
+                                 const long* nx, const long* ny, const long* nz,
+                                 const long* nxguard, const long* nyguard, const long* nzguard,
+                                 const long* /*nox*/, const long* /*noy*/, const long* /*noz*/,
+                                 const long* /*lvect*/, const long* /*charge_depo_algo*/)
+    {
+#if (AMREX_SPACEDIM == 3)
+        const long ng[3] = {*nxguard, *nyguard, *nzguard};
+        const long ntot[3] = {*nx+1+2*(*nxguard), *ny+1+2*(*nyguard), *nz+1+2*(*nzguard)};
+#else
+        (void)ny; (void)nyguard;
+        const long ng[2] = {*nxguard, *nzguard};
+        const long ntot[2] = {*nx+1+2*(*nxguard), *nz+1+2*(*nzguard)};
+#endif
+        const DepositionView rhov(rho, ng, ntot);
+        DepositCharge<order>(*np, xp, yp, zp, w, *q, *xmin, *ymin, *zmin, *dx, *dy, *dz, rhov);
+    }
+}
+
+void
+ParticleKernels::Select (int use_native, long nox, long noy, long noz, long current_deposition_algo)
+{
+    if (!use_native)
+    {
+        geteb_energy_conserving = warpx_geteb_energy_conserving;
+        current_deposition      = warpx_current_deposition;
+        charge_deposition       = warpx_charge_deposition;
+        return;
+    }
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(nox == noy && nox == noz && nox >= 1 && nox <= 3,
+        "algo.use_native_kernels requires interpolation.nox = noy = noz = 1, 2 or 3");
+
+    static const GatherFn gather_kernels[3] = {
+        NativeGetEB<1>, NativeGetEB<2>, NativeGetEB<3> };
+    static const CurrentDepositionFn esirkepov_kernels[3] = {
+        NativeCurrentDeposition<1,true>, NativeCurrentDeposition<2,true>,
+        NativeCurrentDeposition<3,true> };
+    static const CurrentDepositionFn direct_kernels[3] = {
+        NativeCurrentDeposition<1,false>, NativeCurrentDeposition<2,false>,
+        NativeCurrentDeposition<3,false> };
+    static const ChargeDepositionFn charge_kernels[3] = {
+        NativeChargeDeposition<1>, NativeChargeDeposition<2>, NativeChargeDeposition<3> };
+
+#if (AMREX_SPACEDIM == 3)
+    const bool esirkepov = (current_deposition_algo == 0 || current_deposition_algo == 1);
+#else
+    // Like PICSAR, always use the Esirkepov deposition in 2D
+    (void)current_deposition_algo;
+    const bool esirkepov = true;
+#endif
+
+    geteb_energy_conserving = gather_kernels[nox-1];
+    current_deposition      = (esirkepov) ? esirkepov_kernels[nox-1] : direct_kernels[nox-1];
+    charge_deposition       = charge_kernels[nox-1];
+}
@@ -0,0 +1,310 @@
+#include <cmath>
+
+#include <AMReX.H>
+
+#include <WarpXConst.H>
+#include <WarpXParticleKernels.H>
+
+using namespace amrex;
+
+namespace ParticleKernels
+{
+    PusherFn          particle_pusher           = warpx_particle_pusher;
+    PusherMomentaFn   particle_pusher_momenta   = warpx_particle_pusher_momenta;
+    PusherPositionsFn particle_pusher_positions = warpx_particle_pusher_positions;
+}
+
+//
+// The pushers are written once, as loops over the particles that the compiler vectorizes
+// (#pragma omp simd), and inlined into one set of entry points per instruction set. Each
+// set is compiled for its instruction set with the target attribute of GCC and Clang, so
+// that the executable runs on any x86-64 CPU while using the widest vectors it supports.
+// GCC only vectorizes the square roots with -fno-math-errno (set in Make.WarpX).
+//
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define WARPX_PUSHER_MULTI_ISA
+#endif
+
+#if defined(__GNUC__)
+#define WARPX_PUSHER_INLINE inline __attribute__((always_inline))
+#else
+#define WARPX_PUSHER_INLINE inline
+#endif
+
+namespace
+{
+    constexpr Real inv_c  = 1.0/PhysConst::c;
+    constexpr Real inv_c2 = 1.0/(PhysConst::c*PhysConst::c);
+
+    WARPX_PUSHER_INLINE
+    Real InverseGamma (Real ux, Real uy, Real uz)
+    {
+        return 1.0/std::sqrt(1.0 + (ux*ux + uy*uy + uz*uz)*inv_c2);
+    }
+
+    //
+    // Boris push of the momentum of one particle, as in pxr_boris_push_u_3d.
+    // econst is q*dt/(2*m). gi is set to the new inverse Lorentz factor.
+    //
+    WARPX_PUSHER_INLINE
+    void BorisPushMomentum (Real& ux, Real& uy, Real& uz, Real& gi,
+                            Real ex, Real ey, Real ez, Real bx, Real by, Real bz,
+                            Real econst)
+    {
+        // Half push with the electric field
+        ux += ex*econst;
+        uy += ey*econst;
+        uz += ez*econst;
+        // Rotation by the magnetic field
+        const Real gitmp = InverseGamma(ux, uy, uz);
+        const Real tx = gitmp*bx*econst;
+        const Real ty = gitmp*by*econst;
+        const Real tz = gitmp*bz*econst;
+        const Real tsqi = 2.0/(1.0 + tx*tx + ty*ty + tz*tz);
+        const Real sx = tx*tsqi;
+        const Real sy = ty*tsqi;
+        const Real sz = tz*tsqi;
+        const Real uxppr = ux + uy*tz - uz*ty;
+        const Real uyppr = uy + uz*tx - ux*tz;
+        const Real uzppr = uz + ux*ty - uy*tx;
+        ux += uyppr*sz - uzppr*sy;
+        uy += uzppr*sx - uxppr*sz;
+        uz += uxppr*sy - uyppr*sx;
+        // Half push with the electric field
+        ux += ex*econst;
+        uy += ey*econst;
+        uz += ez*econst;
+        gi = InverseGamma(ux, uy, uz);
+    }
+
+    //
+    // Vay push of the momentum of one particle, as in pxr_ebcancelpush3d (full push).
+    // econst is q*dt/m. gi must be the inverse Lorentz factor of the particle before
+    // the push, and is set to the new one.
+    //
+    WARPX_PUSHER_INLINE
+    void VayPushMomentum (Real& ux, Real& uy, Real& uz, Real& gi,
+                          Real ex, Real ey, Real ez, Real bx, Real by, Real bz,
+                          Real econst)
+    {
+        const Real bconst = 0.5*econst;
+        const Real taux = bconst*bx;
+        const Real tauy = bconst*by;
+        const Real tauz = bconst*bz;
+        const Real tausq = taux*taux + tauy*tauy + tauz*tauz;
+        // u' and gamma'^2
+        const Real uxpr = ux + econst*ex + (uy*tauz - uz*tauy)*gi;
+        const Real uypr = uy + econst*ey + (uz*taux - ux*tauz)*gi;
+        const Real uzpr = uz + econst*ez + (ux*tauy - uy*taux)*gi;
+        const Real gprsq = 1.0 + (uxpr*uxpr + uypr*uypr + uzpr*uzpr)*inv_c2;
+        // New gamma
+        const Real ust = (uxpr*taux + uypr*tauy + uzpr*tauz)*inv_c;
+        const Real sigma = gprsq - tausq;
+        const Real gisq = 2.0/(sigma + std::sqrt(sigma*sigma + 4.0*(tausq + ust*ust)));
+        gi = std::sqrt(gisq);
+        // New u
+        const Real bg = bconst*gi;
+        const Real tx = bg*bx;
+        const Real ty = bg*by;
+        const Real tz = bg*bz;
+        const Real s = 1.0/(1.0 + tausq*gisq);
+        const Real tu = tx*uxpr + ty*uypr + tz*uzpr;
+        ux = s*(uxpr + tx*tu + uypr*tz - uzpr*ty);
+        uy = s*(uypr + ty*tu + uzpr*tx - uxpr*tz);
+        uz = s*(uzpr + tz*tu + uxpr*ty - uypr*tx);
+    }
+
+    //
+    // One pass over the particles. algo is the particle pusher algorithm (0: Boris,
+    // 1: Vay). Without push_momenta, the inverse Lorentz factors are recomputed from
+    // the momenta, and the fields are not used.
+    //
+    template <int algo, bool push_momenta, bool push_positions>
+    WARPX_PUSHER_INLINE
+    void PushLoop (long np, Real* xp, Real* yp, Real* zp,
+                   Real* uxp, Real* uyp, Real* uzp, Real* gip,
+                   const Real* exp, const Real* eyp, const Real* ezp,
+                   const Real* bxp, const Real* byp, const Real* bzp,
+                   Real q, Real m, Real dt)
+    {
+        const Real econst = (algo == 1) ? q*dt/m : 0.5*q*dt/m;
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+        for (long i = 0; i < np; ++i)
+        {
+            Real ux = uxp[i];
+            Real uy = uyp[i];
+            Real uz = uzp[i];
+            Real gi;
+            if (push_momenta) {
+                if (algo == 1) {
+                    gi = InverseGamma(ux, uy, uz);
+                    VayPushMomentum(ux, uy, uz, gi, exp[i], eyp[i], ezp[i],
+                                    bxp[i], byp[i], bzp[i], econst);
+                } else {
+                    BorisPushMomentum(ux, uy, uz, gi, exp[i], eyp[i], ezp[i],
+                                      bxp[i], byp[i], bzp[i], econst);
+                }
+                uxp[i] = ux;
+                uyp[i] = uy;
+                uzp[i] = uz;
+            } else {
+                gi = InverseGamma(ux, uy, uz);
+            }
+            gip[i] = gi;
+            if (push_positions) {
+                xp[i] += ux*gi*dt;
+#if (AMREX_SPACEDIM == 3)
+                yp[i] += uy*gi*dt;
+#endif
+                zp[i] += uz*gi*dt;
+            }
+        }
+#if (AMREX_SPACEDIM != 3)
+        (void)yp;
+#endif
+    }
+}
+
+//
+// Entry points with the interface of the PICSAR wrappers, for one instruction set
+//
+#define WARPX_DEFINE_PUSHERS(isa, target)                                                 \
+namespace                                                                                 \
+{                                                                                         \
+    target                                                                                \
+    void Pusher_##isa (const long* np, Real* xp, Real* yp, Real* zp,                      \
+                       Real* uxp, Real* uyp, Real* uzp, Real* gip,                        \
+                       const Real* exp, const Real* eyp, const Real* ezp,                 \
+                       const Real* bxp, const Real* byp, const Real* bzp,                 \
+                       const Real* q, const Real* m, const Real* dt, const long* algo)    \
+    {                                                                                     \
+        if (*algo == 1) {                                                                 \
+            PushLoop<1,true,true>(*np, xp, yp, zp, uxp, uyp, uzp, gip,                    \
+                                  exp, eyp, ezp, bxp, byp, bzp, *q, *m, *dt);             \
+        } else {                                                                          \
+            PushLoop<0,true,true>(*np, xp, yp, zp, uxp, uyp, uzp, gip,                    \
+                                  exp, eyp, ezp, bxp, byp, bzp, *q, *m, *dt);             \
+        }                                                                                 \
+    }                                                                                     \
+                                                                                          \
+    target                                                                                \
+    void PusherMomenta_##isa (const long* np, Real* xp, Real* yp, Real* zp,               \
+                              Real* uxp, Real* uyp, Real* uzp, Real* gip,                 \
+                              const Real* exp, const Real* eyp, const Real* ezp,          \
+                              const Real* bxp, const Real* byp, const Real* bzp,          \
+                              const Real* q, const Real* m, const Real* dt,               \
+                              const long* algo)                                           \
+    {                                                                                     \
+        if (*algo == 1) {                                                                 \
+            PushLoop<1,true,false>(*np, xp, yp, zp, uxp, uyp, uzp, gip,                   \
+                                   exp, eyp, ezp, bxp, byp, bzp, *q, *m, *dt);            \
+        } else {                                                                          \
+            PushLoop<0,true,false>(*np, xp, yp, zp, uxp, uyp, uzp, gip,                   \
+                                   exp, eyp, ezp, bxp, byp, bzp, *q, *m, *dt);            \
+        }                                                                                 \
+    }                                                                                     \
+                                                                                          \
+    target                                                                                \
+    void PusherPositions_##isa (const long* np, Real* xp, Real* yp, Real* zp,             \
+                                Real* uxp, Real* uyp, Real* uzp, Real* gip,               \
+                                const Real* dt)                                           \
+    {                                                                                     \
+        PushLoop<0,false,true>(*np, xp, yp, zp, uxp, uyp, uzp, gip,                       \
+                               nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,      \
+                               1.0, 1.0, *dt);                                            \
+    }                                                                                     \
+}
+
+WARPX_DEFINE_PUSHERS(generic, )
+
+#ifdef WARPX_PUSHER_MULTI_ISA
+WARPX_DEFINE_PUSHERS(sse,    __attribute__((target("sse4.2"))))
+WARPX_DEFINE_PUSHERS(avx2,   __attribute__((target("avx2,fma"))))
+WARPX_DEFINE_PUSHERS(avx512, __attribute__((target("avx512f"))))
+#endif
+
+namespace
+{
+    struct PusherSet
+    {
+        const char* isa;
+        const char* cpu_feature;  // for __builtin_cpu_supports, nullptr if always supported
+        ParticleKernels::PusherFn          pusher;
+        ParticleKernels::PusherMomentaFn   pusher_momenta;
+        ParticleKernels::PusherPositionsFn pusher_positions;
+    };
+
+    // From the least to the most recent instruction set
+    const PusherSet pusher_sets[] = {
+        {"generic", nullptr,   Pusher_generic, PusherMomenta_generic, PusherPositions_generic},
+#ifdef WARPX_PUSHER_MULTI_ISA
+        {"sse",     "sse4.2",  Pusher_sse,     PusherMomenta_sse,     PusherPositions_sse},
+        {"avx2",    "avx2",    Pusher_avx2,    PusherMomenta_avx2,    PusherPositions_avx2},
+        {"avx512",  "avx512f", Pusher_avx512,  PusherMomenta_avx512,  PusherPositions_avx512},
+#endif
+    };
+
+    bool CPUSupports (const PusherSet& ps)
+    {
+        if (ps.cpu_feature == nullptr) return true;
+#ifdef WARPX_PUSHER_MULTI_ISA
+        __builtin_cpu_init();
+        const std::string feature = ps.cpu_feature;
+        // __builtin_cpu_supports only takes string literals
+        if (feature == "sse4.2")  return __builtin_cpu_supports("sse4.2");
+        if (feature == "avx2")    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        if (feature == "avx512f") return __builtin_cpu_supports("avx512f");
+#endif
+        return false;
+    }
+
+    std::string pusher_name = "picsar";
+}
+
+void
+ParticleKernels::SelectPusher (int use_native, const std::string& isa)
+{
+    if (!use_native)
+    {
+        particle_pusher           = warpx_particle_pusher;
+        particle_pusher_momenta   = warpx_particle_pusher_momenta;
+        particle_pusher_positions = warpx_particle_pusher_positions;
+        pusher_name = "picsar";
+        return;
+    }
+
+    // With "auto", the last supported set, i.e. the most recent instruction set, wins
+    const PusherSet* selected = nullptr;
+    for (const auto& ps : pusher_sets) {
+        if ((isa == "auto" || isa == ps.isa) && CPUSupports(ps)) {
+            selected = &ps;
+        }
+    }
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(selected != nullptr,
+        "algo.pusher_isa must be auto, generic, sse, avx2 or avx512, and supported by the CPU and the compiler");
+
+    particle_pusher           = selected->pusher;
+    particle_pusher_momenta   = selected->pusher_momenta;
+    particle_pusher_positions = selected->pusher_positions;
+    pusher_name = selected->isa;
+}
+
+std::vector<std::string>
+ParticleKernels::SupportedPusherISAs ()
+{
+    std::vector<std::string> isas;
+    for (const auto& ps : pusher_sets) {
+        if (CPUSupports(ps)) {
+            isas.push_back(ps.isa);
+        }
+    }
+    return isas;
+}
+
+const std::string&
+ParticleKernels::PusherName ()
+{
+    return pusher_name;
+}
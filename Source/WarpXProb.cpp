@@ -6,6 +6,8 @@ using namespace amrex;
 void
 WarpX::InitLevelData (int lev, Real time)
 {
+    aux_is_current = false;
+
     for (int i = 0; i < 3; ++i) {
 	current_fp[lev][i]->setVal(0.0);
 	Efield_fp[lev][i]->setVal(0.0);
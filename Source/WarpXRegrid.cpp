@@ -26,9 +26,33 @@ WarpX::LoadBalance ()
     mypc->Redistribute();
 }
 
+void
+WarpX::AddPMLCost (int lev, PatchType patch_type, const Vector<Real>& pml_cost)
+{
+    MultiFab* cost = costs[lev].get();
+    if (cost == nullptr) return;
+
+    // The time spent on each PML box is spread over the grid it borders, which is on
+    // this process (see PML::MakeDistributionMap).
+    const Vector<int>& grid_index = pml[lev]->GridIndex(patch_type);
+    const DistributionMapping& dm = cost->DistributionMap();
+    const int myproc = ParallelDescriptor::MyProc();
+    for (int i = 0, N = pml_cost.size(); i < N; ++i)
+    {
+        const int igrid = grid_index[i];
+        if (pml_cost[i] > 0.0 && dm[igrid] == myproc)
+        {
+            const Box& cbx = cost->boxArray()[igrid];
+            (*cost)[igrid].plus(pml_cost[i] / cbx.d_numPts(), cbx);
+        }
+    }
+}
+
 void
 WarpX::RemakeLevel (int lev, Real time, const BoxArray& ba, const DistributionMapping& dm)
 {
+    aux_is_current = false;
+
     if (ba == boxArray(lev))
     {
         if (ParallelDescriptor::NProcs() == 1) return;
@@ -217,11 +241,33 @@ WarpX::RemakeLevel (int lev, Real time, const BoxArray& ba, const DistributionMa
             }
         }
 
+        // NCI-filtered fields, recomputed every step
+        for (auto* nci : {&Efield_aux_nci, &Bfield_aux_nci, &Efield_cax_nci, &Bfield_cax_nci})
+        {
+            for (int idim=0; idim < 3; ++idim)
+            {
+                auto& mf = (*nci)[lev][idim];
+                if (mf)
+                {
+                    const IntVect& ng = mf->nGrowVect();
+                    auto pmf = std::unique_ptr<MultiFab>(new MultiFab(mf->boxArray(),
+                                                                      dm, 1, ng));
+                    // no need to redistribute
+                    mf = std::move(pmf);
+                }
+            }
+        }
+
         if (costs[lev] != nullptr) {
             costs[lev].reset(new MultiFab(costs[lev]->boxArray(), dm, 1, 0));
             costs[lev]->setVal(0.0);
         }
 
+        // PML boxes, with the grids they border
+        if (do_pml && pml[lev]->ok()) {
+            pml[lev]->RemakeDistributionMap(dm);
+        }
+
         SetDistributionMap(lev, dm);
     }
     else
@@ -0,0 +1,226 @@
+#include <algorithm>
+
+#include <AMReX_ParallelDescriptor.H>
+
+#include <WarpXSumBoundary.H>
+
+using namespace amrex;
+
+NonblockingSumBoundary::~NonblockingSumBoundary ()
+{
+#ifdef BL_USE_MPI
+    // Do not free buffers that MPI may still use
+    if (!requests.empty()) {
+        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    }
+#endif
+}
+
+bool
+NonblockingSumBoundary::SameLayout (const Vector<MultiFab*>& mfs, const Periodicity& period) const
+{
+    if (!defined || mfs.size() != m_ba.size() || !(period == m_period)) return false;
+    for (int imf = 0; imf < mfs.size(); ++imf)
+    {
+        const MultiFab& mf = *mfs[imf];
+        if (mf.nGrowVect() != m_ng[imf] ||
+            mf.boxArray() != m_ba[imf] || mf.DistributionMap() != m_dm[imf]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+NonblockingSumBoundary::Define (const Vector<MultiFab*>& mfs, const Periodicity& period)
+{
+    BL_PROFILE("NonblockingSumBoundary::Define()");
+
+    m_ba.clear();
+    m_dm.clear();
+    m_ng.clear();
+    local_tags.clear();
+    send_tags.clear();
+    recv_tags.clear();
+    local_buffer.clear();
+    send_buffers.clear();
+    recv_buffers.clear();
+
+    const int myproc = ParallelDescriptor::MyProc();
+    const std::vector<IntVect>& shifts = period.shiftIntVect();
+    std::vector<std::pair<int,Box> > isects;
+
+    for (int imf = 0; imf < mfs.size(); ++imf)
+    {
+        const MultiFab& mf = *mfs[imf];
+        const BoxArray& ba = mf.boxArray();
+        const DistributionMapping& dm = mf.DistributionMap();
+        const IntVect& ng = mf.nGrowVect();
+
+        m_ba.push_back(ba);
+        m_dm.push_back(dm);
+        m_ng.push_back(ng);
+
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+        {
+            const int k = mfi.index();
+
+            // The values of box k added to the boxes that its guard cells overlap
+            for (const auto& iv : shifts)
+            {
+                Box gbx = amrex::grow(ba[k], ng);
+                gbx += iv;
+                ba.intersections(gbx, isects);
+                for (const auto& is : isects)
+                {
+                    const int i = is.first;
+                    if (i == k && iv == IntVect::TheZeroVector()) continue;
+                    const Tag tag {imf, k, i, is.second, iv};
+                    if (dm[i] == myproc) {
+                        local_tags.push_back(tag);
+                    } else {
+                        send_tags[dm[i]].push_back(tag);
+                    }
+                }
+            }
+
+            // The values of the boxes of other processes added to box k
+            for (const auto& iv : shifts)
+            {
+                Box bx = ba[k];
+                bx -= iv;
+                ba.intersections(amrex::grow(bx, ng), isects);
+                for (const auto& is : isects)
+                {
+                    const int j = is.first;
+                    if (dm[j] == myproc) continue;
+                    Box gbx = amrex::grow(ba[j], ng);
+                    gbx += iv;
+                    const Box& dbox = ba[k] & gbx;
+                    if (dbox.ok()) {
+                        recv_tags[dm[j]].push_back(Tag {imf, j, k, dbox, iv});
+                    }
+                }
+            }
+        }
+    }
+
+    // Both sides of a message must list the regions in the same order
+    auto tag_less = [] (const Tag& a, const Tag& b) {
+        if (a.imf != b.imf) return a.imf < b.imf;
+        if (a.src != b.src) return a.src < b.src;
+        if (a.dst != b.dst) return a.dst < b.dst;
+        return a.shift.lexLT(b.shift);
+    };
+    for (auto& kv : send_tags) {
+        std::sort(kv.second.begin(), kv.second.end(), tag_less);
+    }
+    for (auto& kv : recv_tags) {
+        std::sort(kv.second.begin(), kv.second.end(), tag_less);
+    }
+
+    m_period = period;
+    defined = true;
+}
+
+void
+NonblockingSumBoundary::Start (const Vector<MultiFab*>& mfs, int scomp, int ncomp,
+                               const Periodicity& period)
+{
+    BL_PROFILE("NonblockingSumBoundary::Start()");
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!in_progress,
+        "NonblockingSumBoundary::Start: the previous exchange is not finished");
+
+    if (!SameLayout(mfs, period)) {
+        Define(mfs, period);
+    }
+    m_mfs = mfs;
+    m_scomp = scomp;
+    m_ncomp = ncomp;
+
+#ifdef BL_USE_MPI
+    const int mpi_tag = ParallelDescriptor::SeqNum();
+    MPI_Comm comm = ParallelDescriptor::Communicator();
+    MPI_Datatype mpi_type = ParallelDescriptor::Mpi_typemap<Real>::type();
+
+    for (const auto& kv : recv_tags)
+    {
+        Vector<Real>& buffer = recv_buffers[kv.first];
+        buffer.resize(NumValues(kv.second));
+        requests.push_back(MPI_REQUEST_NULL);
+        MPI_Irecv(buffer.data(), buffer.size(), mpi_type, kv.first, mpi_tag, comm, &requests.back());
+    }
+
+    for (const auto& kv : send_tags)
+    {
+        Vector<Real>& buffer = send_buffers[kv.first];
+        Pack(kv.second, buffer);
+        requests.push_back(MPI_REQUEST_NULL);
+        MPI_Isend(buffer.data(), buffer.size(), mpi_type, kv.first, mpi_tag, comm, &requests.back());
+    }
+#endif
+
+    // The local values are copied now, as the caller may modify the MultiFabs
+    Pack(local_tags, local_buffer);
+
+    in_progress = true;
+}
+
+void
+NonblockingSumBoundary::Finish ()
+{
+    BL_PROFILE("NonblockingSumBoundary::Finish()");
+
+    if (!in_progress) return;
+
+#ifdef BL_USE_MPI
+    if (!requests.empty()) {
+        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+        requests.clear();
+    }
+#endif
+
+    Unpack(local_tags, local_buffer);
+    for (const auto& kv : recv_tags) {
+        Unpack(kv.second, recv_buffers[kv.first]);
+    }
+
+    m_mfs.clear();
+    in_progress = false;
+}
+
+long
+NonblockingSumBoundary::NumValues (const Vector<Tag>& tags) const
+{
+    long n = 0;
+    for (const auto& tag : tags) {
+        n += tag.dbox.numPts() * NComp(*m_mfs[tag.imf]);
+    }
+    return n;
+}
+
+void
+NonblockingSumBoundary::Pack (const Vector<Tag>& tags, Vector<Real>& buffer) const
+{
+    buffer.resize(NumValues(tags));
+    char* p = reinterpret_cast<char*>(buffer.data());
+    for (const auto& tag : tags)
+    {
+        const MultiFab& mf = *m_mfs[tag.imf];
+        Box sbox = tag.dbox;
+        sbox -= tag.shift;
+        p += mf[tag.src].copyToMem(sbox, m_scomp, NComp(mf), p);
+    }
+}
+
+void
+NonblockingSumBoundary::Unpack (const Vector<Tag>& tags, const Vector<Real>& buffer)
+{
+    const char* p = reinterpret_cast<const char*>(buffer.data());
+    for (const auto& tag : tags)
+    {
+        MultiFab& mf = *m_mfs[tag.imf];
+        p += mf[tag.dst].addFromMem(tag.dbox, m_scomp, NComp(mf), p);
+    }
+}
@@ -1,4 +1,7 @@
 
+#include <map>
+#include <string>
+
 #include <AMReX.H>
 #include <AMReX_BLProfiler.H>
 
@@ -71,6 +74,31 @@ extern "C"
         return PIdx::nattribs;        
     }
 
+    // Index of the particle attribute called name in PIdx, or -1 if it is not
+    // stored with this build. With TRANSIENT_PARTICLE_FIELDS, the gathered fields
+    // Ex..Bz are given the indices PIdx::nattribs to PIdx::nattribs+5
+    // (see warpx_getParticleArrays).
+    int warpx_getParticleCompIndex(const char* name)
+    {
+        static const std::map<std::string, int> comps {
+            {"w", PIdx::w}, {"ux", PIdx::ux}, {"uy", PIdx::uy}, {"uz", PIdx::uz},
+#ifndef WARPX_TRANSIENT_PARTICLE_FIELDS
+            {"Ex", PIdx::Ex}, {"Ey", PIdx::Ey}, {"Ez", PIdx::Ez},
+            {"Bx", PIdx::Bx}, {"By", PIdx::By}, {"Bz", PIdx::Bz},
+#else
+            {"Ex", PIdx::nattribs  }, {"Ey", PIdx::nattribs+1}, {"Ez", PIdx::nattribs+2},
+            {"Bx", PIdx::nattribs+3}, {"By", PIdx::nattribs+4}, {"Bz", PIdx::nattribs+5},
+#endif
+#ifdef WARPX_STORE_OLD_PARTICLE_ATTRIBS
+            {"xold", PIdx::xold}, {"yold", PIdx::yold}, {"zold", PIdx::zold},
+            {"uxold", PIdx::uxold}, {"uyold", PIdx::uyold}, {"uzold", PIdx::uzold},
+#endif
+            {"x", PIdx::x}, {"y", PIdx::y}, {"z", PIdx::z}
+        };
+        auto it = comps.find(name);
+        return (it == comps.end()) ? -1 : it->second;
+    }
+
     int warpx_SpaceDim() 
     {
         return AMREX_SPACEDIM;
@@ -329,8 +357,26 @@ extern "C"
         auto & mypc = WarpX::GetInstance().GetPartContainer();
         auto & myspc = mypc.GetParticleContainer(speciesnumber);
 
+#ifdef WARPX_TRANSIENT_PARTICLE_FIELDS
+        const int ncomps = PIdx::nattribs + 6;
+#else
+        const int ncomps = PIdx::nattribs;
+#endif
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(comp >= 0 && comp < ncomps,
+                                         "warpx_getParticleArrays: invalid particle component");
+
         const int level = 0;
 
+#ifdef WARPX_TRANSIENT_PARTICLE_FIELDS
+        // The particles do not store the gathered fields: gather them now
+        if (comp >= PIdx::nattribs) {
+            WarpX& warpx = WarpX::GetInstance();
+            // The fields may have been changed from Python
+            warpx.MarkAuxilaryDataOutdated();
+            warpx.GatherFieldsForDiagnostics();
+        }
+#endif
+
         int i = 0;
         for (WarpXParIter pti(myspc, level); pti.isValid(); ++pti, ++i) {}
 
@@ -341,6 +387,16 @@ extern "C"
         double** data = (double**) malloc(*num_tiles*sizeof(double*));
         i = 0;
         for (WarpXParIter pti(myspc, level); pti.isValid(); ++pti, ++i) {
+#ifdef WARPX_TRANSIENT_PARTICLE_FIELDS
+            if (comp >= PIdx::nattribs) {
+                auto fields = myspc.GatheredFields(level, pti.index(), pti.LocalTileIndex());
+                AMREX_ALWAYS_ASSERT_WITH_MESSAGE(fields != nullptr,
+                    "warpx_getParticleArrays: no fields are gathered for this species");
+                data[i] = (double*) (*fields)[comp-PIdx::nattribs].dataPtr();
+                (*particles_per_tile)[i] = pti.numParticles();
+                continue;
+            }
+#endif
             auto& soa = pti.GetStructOfArrays();
             data[i] = (double*) soa.GetRealData(comp).dataPtr();
             (*particles_per_tile)[i] = pti.numParticles();
@@ -379,7 +435,11 @@ extern "C"
     }
     void warpx_UpdateAuxilaryData () {
         WarpX& warpx = WarpX::GetInstance();
+        // The fields may have been changed from Python
+        warpx.MarkAuxilaryDataOutdated ();
         warpx.UpdateAuxilaryData ();
+        // With particles.nci_corr_once_per_step, the particles gather from the filtered copy
+        warpx.FilterAuxFieldsNCI ();
     }
     void warpx_PushParticlesandDepose (double cur_time) {
         WarpX& warpx = WarpX::GetInstance();
@@ -17,6 +17,8 @@ extern "C" {
 
     int warpx_nComps();
 
+    int warpx_getParticleCompIndex(const char* name);
+
     int warpx_SpaceDim();
 
     void amrex_init (int argc, char* argv[]);
@@ -1,4 +1,7 @@
 
+#include <cmath>
+#include <algorithm>
+#include <limits>
 #include <random>
 
 #include <AMReX.H>
@@ -7,9 +10,11 @@
 #include <AMReX_MultiFab.H>
 #include <AMReX_MultiFabUtil.H>
 #include <AMReX_PlotFileUtil.H>
+#include <AMReX_Print.H>
 
 #include <WarpX_f.H>
 #include <WarpXConst.H>
+#include <WarpXParticleKernels.H>
 
 using namespace amrex;
 
@@ -121,15 +126,123 @@ int main(int argc, char* argv[])
 				 &nox, &noy,&noz,
 				 &lvect, &current_deposition_algo);
 
+#if (BL_SPACEDIM == 3)
 	MultiFab plotmf(ba, dm, 3, 0);
         amrex::average_edge_to_cellcenter(plotmf, 0, {&jx, &jy, &jz});
+	Vector<std::string> varnames{"jx", "jy", "jz"};
+#elif (BL_SPACEDIM == 2)
+	MultiFab plotmf(ba, dm, 2, 0);
+        amrex::average_edge_to_cellcenter(plotmf, 0, {&jx, &jz});
+	Vector<std::string> varnames{"jx", "jz"};
+#endif
 
 	RealBox realbox{domain_box, dx, xyzmin};
 	int is_per[3] = {0,0,0};
 	Geometry geom{domain_box, &realbox, 0, is_per};
 	std::string plotname{"plotfiles/plt00000"};
-	Vector<std::string> varnames{"jx", "jy", "jz"};
 	amrex::WriteSingleLevelPlotfile(plotname, plotmf, varnames, geom, 0.0, 0);
+
+	//
+	// Comparison of the native current and charge deposition kernels (see
+	// algo.use_native_kernels) with PICSAR, for the interpolation orders 1 to 3 and,
+	// in 3D, for the Esirkepov (0, 1) and direct (2, 3) current deposition
+	// algorithms (2D always uses Esirkepov). They must agree to round-off.
+	//
+	{
+	    const int ng_max = 4;
+	    const Real tol = 1.e3*std::numeric_limits<Real>::epsilon();
+	    // The speeds are below 1, so the particles move by up to half a cell: this
+	    // tests the Esirkepov deposition across cells, without the round-off of the
+	    // very small displacements above.
+	    const Real dt_cmp = 0.5*dx[0];
+
+	    // Maximum relative difference between the data of two FArrayBoxes
+	    auto max_rel_diff = [] (const FArrayBox& fab, const FArrayBox& ref) -> Real
+	    {
+		Real maxref = 0.0, maxdiff = 0.0;
+		const Real* p = fab.dataPtr();
+		const Real* pref = ref.dataPtr();
+		for (long i = 0, n = ref.box().numPts(); i < n; ++i) {
+		    maxref  = std::max(maxref, std::abs(pref[i]));
+		    maxdiff = std::max(maxdiff, std::abs(p[i]-pref[i]));
+		}
+		return (maxref > 0.0) ? maxdiff/maxref : maxdiff;
+	    };
+
+#if (BL_SPACEDIM == 3)
+	    const Vector<long> algos{0, 1, 2, 3};
+#elif (BL_SPACEDIM == 2)
+	    const Vector<long> algos{1};
+#endif
+	    for (long order = 1; order <= 3; ++order) {
+		for (long algo : algos) {
+		    FArrayBox jfab[2][3];
+		    for (int pass = 0; pass < 2; ++pass) {
+			// pass 0: PICSAR, pass 1: native
+			ParticleKernels::Select(pass, order, order, order, algo);
+			jfab[pass][0].resize(amrex::grow(jxfab.box(), ng_max-ng));
+			jfab[pass][1].resize(amrex::grow(jyfab.box(), ng_max-ng));
+			jfab[pass][2].resize(amrex::grow(jzfab.box(), ng_max-ng));
+			for (auto& fab : jfab[pass]) {
+			    fab.setVal(0.0);
+			}
+			long ngj = ng_max;
+			ParticleKernels::current_deposition(
+			    jfab[pass][0].dataPtr(), &ngj, jfab[pass][0].length(),
+			    jfab[pass][1].dataPtr(), &ngj, jfab[pass][1].length(),
+			    jfab[pass][2].dataPtr(), &ngj, jfab[pass][2].length(),
+			    &np, xp.data(), yp.data(), zp.data(),
+			    uxp.data(), uyp.data(), uzp.data(),
+			    giv.data(), wp.data(), &charge,
+			    &xyzmin[0], &xyzmin[1], &xyzmin[2],
+			    &dt_cmp, &dx[0], &dx[1], &dx[2],
+			    &order, &order, &order,
+			    &lvect, &algo);
+		    }
+
+		    Real maxdiff = 0.0;
+		    for (int icomp = 0; icomp < 3; ++icomp) {
+			maxdiff = std::max(maxdiff, max_rel_diff(jfab[1][icomp], jfab[0][icomp]));
+		    }
+		    amrex::Print() << "Current deposition, order " << order << ", algo " << algo
+				   << ": max relative difference of the native kernel with picsar: "
+				   << maxdiff << "\n";
+		    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(maxdiff <= tol,
+			"The native current deposition differs from PICSAR by more than round-off");
+		}
+
+		FArrayBox rho[2];
+		for (int pass = 0; pass < 2; ++pass) {
+		    ParticleKernels::Select(pass, order, order, order, current_deposition_algo);
+		    rho[pass].resize(amrex::grow(amrex::surroundingNodes(domain_box), ng_max));
+		    rho[pass].setVal(0.0);
+		    const int* rholen = rho[pass].length();
+#if (BL_SPACEDIM == 3)
+		    const long nxr = rholen[0]-1-2*ng_max;
+		    const long nyr = rholen[1]-1-2*ng_max;
+		    const long nzr = rholen[2]-1-2*ng_max;
+#elif (BL_SPACEDIM == 2)
+		    const long nxr = rholen[0]-1-2*ng_max;
+		    const long nyr = 0;
+		    const long nzr = rholen[1]-1-2*ng_max;
+#endif
+		    long ngr = ng_max;
+		    long charge_deposition_algo = 0;
+		    ParticleKernels::charge_deposition(rho[pass].dataPtr(),
+			&np, xp.data(), yp.data(), zp.data(), wp.data(),
+			&charge, &xyzmin[0], &xyzmin[1], &xyzmin[2],
+			&dx[0], &dx[1], &dx[2], &nxr, &nyr, &nzr,
+			&ngr, &ngr, &ngr, &order, &order, &order,
+			&lvect, &charge_deposition_algo);
+		}
+		const Real maxdiff = max_rel_diff(rho[1], rho[0]);
+		amrex::Print() << "Charge deposition, order " << order
+			       << ": max relative difference of the native kernel with picsar: "
+			       << maxdiff << "\n";
+		AMREX_ALWAYS_ASSERT_WITH_MESSAGE(maxdiff <= tol,
+		    "The native charge deposition differs from PICSAR by more than round-off");
+	    }
+	}
     }
 
     amrex::Finalize();
@@ -1,4 +1,8 @@
 
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <memory>
 #include <random>
 
 #include <AMReX.H>
@@ -7,8 +11,10 @@
 #include <AMReX_MultiFab.H>
 #include <AMReX_BoxIterator.H>
 #include <AMReX_PlotFileUtil.H>
+#include <AMReX_Print.H>
 
 #include <WarpX_f.H>
+#include <WarpXParticleKernels.H>
 
 using namespace amrex;
 
@@ -172,7 +178,7 @@ int main(int argc, char* argv[])
 	for (int k = 0; k < nz; ++k) {
 	    for (int j = 0; j < ny; ++j) {
 		for (int i = 0; i < nx; ++i) {
-		    IntVect cell{i,j,k};
+		    IntVect cell{D_DECL(i,j,k)};
 		    int ip = i + j*nx + k*nx*ny;
 		    plotfab(cell,0) += Exp[ip];
 		    plotfab(cell,1) += Eyp[ip];
@@ -190,6 +196,74 @@ int main(int argc, char* argv[])
 	std::string plotname{"plotfiles/plt00000"};
 	Vector<std::string> varnames{"Ex", "Ey", "Ez", "Bx", "By", "Bz"};
 	amrex::WriteSingleLevelPlotfile(plotname, plotmf, varnames, geom, 0.0, 0);
+
+	//
+	// Comparison of the native field gathering kernels (see algo.use_native_kernels)
+	// with PICSAR, for the interpolation orders 1 to 3, with and without the lower
+	// order in the staggered directions. They must agree to round-off.
+	//
+	{
+	    const int ng_max = 3;
+	    const IntVect nodal_flags[6] = {Ex_nodal_flag, Ey_nodal_flag, Ez_nodal_flag,
+					    Bx_nodal_flag, By_nodal_flag, Bz_nodal_flag};
+	    Vector<std::unique_ptr<MultiFab> > fields;
+	    for (int icomp = 0; icomp < 6; ++icomp) {
+		fields.emplace_back(new MultiFab(amrex::convert(ba,nodal_flags[icomp]), dm, 1, ng_max));
+		FArrayBox& fab = (*fields[icomp])[0];
+		for (BoxIterator bxi(fab.box()); bxi.ok(); ++bxi)
+		{
+		    fab(bxi()) = rand_dis2(rand_eng);
+		}
+	    }
+
+	    const Real tol = 1.e3*std::numeric_limits<Real>::epsilon();
+
+	    for (long order = 1; order <= 3; ++order) {
+		for (int lower_order_in_v = 0; lower_order_in_v <= 1; ++lower_order_in_v) {
+
+		    Vector<Real> ref[6], native[6];
+		    for (int pass = 0; pass < 2; ++pass) {
+			// pass 0: PICSAR, pass 1: native (the current deposition is not used here)
+			ParticleKernels::Select(pass, order, order, order, 0);
+			Vector<Real>* ebp = (pass == 0) ? ref : native;
+			for (int icomp = 0; icomp < 6; ++icomp) {
+			    ebp[icomp].assign(np, 0.0);
+			}
+			ParticleKernels::geteb_energy_conserving(&np, xp.data(), yp.data(), zp.data(),
+			    ebp[0].data(), ebp[1].data(), ebp[2].data(),
+			    ebp[3].data(), ebp[4].data(), ebp[5].data(),
+			    ixyzmin,
+			    &xyzmin[0], &xyzmin[1], &xyzmin[2],
+			    &dx[0], &dx[1], &dx[2],
+			    &order, &order, &order,
+			    BL_TO_FORTRAN_ANYD((*fields[0])[0]),
+			    BL_TO_FORTRAN_ANYD((*fields[1])[0]),
+			    BL_TO_FORTRAN_ANYD((*fields[2])[0]),
+			    BL_TO_FORTRAN_ANYD((*fields[3])[0]),
+			    BL_TO_FORTRAN_ANYD((*fields[4])[0]),
+			    BL_TO_FORTRAN_ANYD((*fields[5])[0]),
+			    &ll4symtry, &lower_order_in_v,
+			    &lvect_fieldgathe,
+			    &field_gathering_algo);
+		    }
+
+		    Real maxref = 0.0, maxdiff = 0.0;
+		    for (int icomp = 0; icomp < 6; ++icomp) {
+			for (int ip = 0; ip < np; ++ip) {
+			    maxref  = std::max(maxref, std::abs(ref[icomp][ip]));
+			    maxdiff = std::max(maxdiff, std::abs(native[icomp][ip]-ref[icomp][ip]));
+			}
+		    }
+
+		    amrex::Print() << "Field gathering, order " << order
+				   << ", lower order in v " << lower_order_in_v
+				   << ": max relative difference of the native kernel with picsar: "
+				   << maxdiff/maxref << "\n";
+		    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(maxdiff <= tol*maxref,
+			"The native field gathering differs from PICSAR by more than round-off");
+		}
+	    }
+	}
     }
 
     amrex::Finalize();
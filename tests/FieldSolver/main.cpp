@@ -1,4 +1,7 @@
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <limits>
 #include <random>
 
@@ -8,9 +11,11 @@
 #include <AMReX_MultiFab.H>
 #include <AMReX_MultiFabUtil.H>
 #include <AMReX_PlotFileUtil.H>
+#include <AMReX_Print.H>
 
 #include <WarpXConst.H>
 #include <WarpX_f.H>
+#include <WarpXFieldKernels.H>
 
 using namespace amrex;
 
@@ -33,6 +38,12 @@ int main(int argc, char* argv[])
 	    }
 	}
 
+	int nsteps = 100;
+	{
+	    ParmParse pp("benchmark");
+	    pp.query("nsteps", nsteps);
+	}
+
 	std::mt19937 rand_eng(42);
 	std::uniform_real_distribution<Real> rand_dis(0.0,1.0);
 
@@ -223,6 +234,338 @@ int main(int argc, char* argv[])
 	std::string plotname{"plotfiles/plt00000"};
 	Vector<std::string> varnames{"Ex", "Ey", "Ez", "Bx", "By", "Bz"};
 	amrex::WriteSingleLevelPlotfile(plotname, plotmf, varnames, geom, 0.0, 0);
+
+	//
+	// Benchmark of the PICSAR and native FDTD kernels (see algo.use_native_field_solver),
+	// for the Yee and CKC solvers. B and E are pushed nsteps times from the same initial
+	// fields, with a stable time step, and the fields are compared with PICSAR. The
+	// bandwidth assumes that each step reads the 9 arrays of E, B and J once, and writes
+	// the 6 arrays of E and B once.
+	//
+	{
+	    const Real dt_bench = 0.5*dx[0]/PhysConst::c;
+	    Real dtsdx[3], dtsdx_c2[3];
+#if (BL_SPACEDIM == 3)
+	    dtsdx[0] = dt_bench / dx[0];
+	    dtsdx[1] = dt_bench / dx[1];
+	    dtsdx[2] = dt_bench / dx[2];
+#elif (BL_SPACEDIM == 2)
+	    dtsdx[0] = dt_bench / dx[0];
+	    dtsdx[1] = std::numeric_limits<Real>::quiet_NaN();
+	    dtsdx[2] = dt_bench / dx[1];
+#endif
+	    for (int i = 0; i < 3; ++i) {
+		dtsdx_c2[i] = (PhysConst::c*PhysConst::c) * dtsdx[i];
+	    }
+	    const Real mu_c2_dt = (PhysConst::mu0*PhysConst::c*PhysConst::c) * dt_bench;
+
+	    Vector<std::unique_ptr<MultiFab> > E0(3), B0(3), E_ref(3), B_ref(3);
+	    for (int i = 0; i < 3; ++i) {
+		E0[i].reset(new MultiFab(Efield[i]->boxArray(), dmap, 1, ng));
+		B0[i].reset(new MultiFab(Bfield[i]->boxArray(), dmap, 1, ng));
+		E_ref[i].reset(new MultiFab(Efield[i]->boxArray(), dmap, 1, ng));
+		B_ref[i].reset(new MultiFab(Bfield[i]->boxArray(), dmap, 1, ng));
+		MultiFab::Copy(*E0[i], *Efield[i], 0, 0, 1, ng);
+		MultiFab::Copy(*B0[i], *Bfield[i], 0, 0, 1, ng);
+	    }
+
+	    auto relative_difference = [] (const MultiFab& mf, const MultiFab& ref) {
+		MultiFab diff(ref.boxArray(), ref.DistributionMap(), 1, 0);
+		MultiFab::Copy(diff, mf, 0, 0, 1, 0);
+		MultiFab::Subtract(diff, ref, 0, 0, 1, 0);
+		return diff.norm0() / ref.norm0();
+	    };
+
+	    const long ncells = grids.numPts();
+	    const Real bytes_per_cell = 15*sizeof(Real);
+
+	    for (int solver_id = 0; solver_id <= 1; ++solver_id)
+	    {
+		amrex::Print() << "FDTD push of " << ncells << " cells, " << nsteps << " steps, "
+			       << ((solver_id == 1) ? "CKC" : "Yee") << " solver\n";
+
+		for (int native = 0; native <= 1; ++native)
+		{
+		    FieldKernels::Select(native, solver_id);
+
+		    for (int i = 0; i < 3; ++i) {
+			MultiFab::Copy(*Efield[i], *E0[i], 0, 0, 1, ng);
+			MultiFab::Copy(*Bfield[i], *B0[i], 0, 0, 1, ng);
+		    }
+
+		    Real t = amrex::second();
+		    for (int step = 0; step < nsteps; ++step)
+		    {
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+			for ( MFIter mfi(*Bfield[0],true); mfi.isValid(); ++mfi )
+			{
+			    const Box& tbx  = mfi.tilebox(Bx_nodal_flag);
+			    const Box& tby  = mfi.tilebox(By_nodal_flag);
+			    const Box& tbz  = mfi.tilebox(Bz_nodal_flag);
+			    FieldKernels::push_bvec(
+				tbx.loVect(), tbx.hiVect(),
+				tby.loVect(), tby.hiVect(),
+				tbz.loVect(), tbz.hiVect(),
+				BL_TO_FORTRAN_3D((*Efield[0])[mfi]),
+				BL_TO_FORTRAN_3D((*Efield[1])[mfi]),
+				BL_TO_FORTRAN_3D((*Efield[2])[mfi]),
+				BL_TO_FORTRAN_3D((*Bfield[0])[mfi]),
+				BL_TO_FORTRAN_3D((*Bfield[1])[mfi]),
+				BL_TO_FORTRAN_3D((*Bfield[2])[mfi]),
+				&dtsdx[0], &dtsdx[1], &dtsdx[2],
+				&solver_id);
+			}
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+			for ( MFIter mfi(*Efield[0],true); mfi.isValid(); ++mfi )
+			{
+			    const Box& tex  = mfi.tilebox(Ex_nodal_flag);
+			    const Box& tey  = mfi.tilebox(Ey_nodal_flag);
+			    const Box& tez  = mfi.tilebox(Ez_nodal_flag);
+			    FieldKernels::push_evec(
+				tex.loVect(), tex.hiVect(),
+				tey.loVect(), tey.hiVect(),
+				tez.loVect(), tez.hiVect(),
+				BL_TO_FORTRAN_3D((*Efield[0])[mfi]),
+				BL_TO_FORTRAN_3D((*Efield[1])[mfi]),
+				BL_TO_FORTRAN_3D((*Efield[2])[mfi]),
+				BL_TO_FORTRAN_3D((*Bfield[0])[mfi]),
+				BL_TO_FORTRAN_3D((*Bfield[1])[mfi]),
+				BL_TO_FORTRAN_3D((*Bfield[2])[mfi]),
+				BL_TO_FORTRAN_3D((*current[0])[mfi]),
+				BL_TO_FORTRAN_3D((*current[1])[mfi]),
+				BL_TO_FORTRAN_3D((*current[2])[mfi]),
+				&mu_c2_dt,
+				&dtsdx_c2[0], &dtsdx_c2[1], &dtsdx_c2[2]);
+			}
+		    }
+		    t = amrex::second() - t;
+		    ParallelDescriptor::ReduceRealMax(t);
+
+		    if (!native) {
+			for (int i = 0; i < 3; ++i) {
+			    MultiFab::Copy(*E_ref[i], *Efield[i], 0, 0, 1, ng);
+			    MultiFab::Copy(*B_ref[i], *Bfield[i], 0, 0, 1, ng);
+			}
+		    }
+		    Real maxdiff = 0.0;
+		    for (int i = 0; i < 3; ++i) {
+			maxdiff = std::max(maxdiff, relative_difference(*Efield[i], *E_ref[i]));
+			maxdiff = std::max(maxdiff, relative_difference(*Bfield[i], *B_ref[i]));
+		    }
+
+		    const Real updates = static_cast<Real>(ncells)*nsteps;
+		    amrex::Print() << "  " << ((native) ? "native" : "picsar") << ": "
+				   << updates/t << " cell updates/s, "
+				   << updates*bytes_per_cell/t/1.e9 << " GB/s"
+				   << ", max relative difference with picsar: " << maxdiff << "\n";
+		}
+	    }
+	}
+
+	//
+	// Test of the temporally blocked FDTD push (see warpx.fdtd_temporal_blocking). Two
+	// steps of B(dt/2), FillBoundary, E(dt), FillBoundary, B(dt/2) on the tiles are
+	// compared with FieldKernels::PushBlocked, on a periodic domain, for the Yee and
+	// CKC solvers. The two must agree to round-off. The random fields are a function
+	// of the periodic index, so that the nodes shared by two grids hold the same value.
+	//
+	{
+	    const int ngb = 3;
+	    int is_per_blocked[3] = {1,1,1};
+	    Geometry geom_blocked{cc_domain, &realbox, 0, is_per_blocked};
+	    const Periodicity& period = geom_blocked.periodicity();
+
+	    const Real dt_blocked = 0.5*dx[0]/PhysConst::c;
+	    Real dtsdx[3], dtsdx_c2[3];
+#if (BL_SPACEDIM == 3)
+	    dtsdx[0] = 0.5*dt_blocked / dx[0];
+	    dtsdx[1] = 0.5*dt_blocked / dx[1];
+	    dtsdx[2] = 0.5*dt_blocked / dx[2];
+#elif (BL_SPACEDIM == 2)
+	    dtsdx[0] = 0.5*dt_blocked / dx[0];
+	    dtsdx[1] = std::numeric_limits<Real>::quiet_NaN();
+	    dtsdx[2] = 0.5*dt_blocked / dx[1];
+#endif
+	    for (int i = 0; i < 3; ++i) {
+		dtsdx_c2[i] = 2.0*(PhysConst::c*PhysConst::c) * dtsdx[i];
+	    }
+	    const Real mu_c2_dt = (PhysConst::mu0*PhysConst::c*PhysConst::c) * dt_blocked;
+
+	    const std::array<IntVect,3> Eflag {Ex_nodal_flag, Ey_nodal_flag, Ez_nodal_flag};
+	    const std::array<IntVect,3> Bflag {Bx_nodal_flag, By_nodal_flag, Bz_nodal_flag};
+	    const std::array<IntVect,3> jflag {jx_nodal_flag, jy_nodal_flag, jz_nodal_flag};
+
+	    Vector<std::unique_ptr<MultiFab> > E_seq(3), B_seq(3), E_blk(3), B_blk(3), j(3);
+	    for (int i = 0; i < 3; ++i) {
+		E_seq[i].reset(new MultiFab(amrex::convert(grids,Eflag[i]),dmap,1,ngb));
+		B_seq[i].reset(new MultiFab(amrex::convert(grids,Bflag[i]),dmap,1,ngb));
+		E_blk[i].reset(new MultiFab(amrex::convert(grids,Eflag[i]),dmap,1,ngb));
+		B_blk[i].reset(new MultiFab(amrex::convert(grids,Bflag[i]),dmap,1,ngb));
+		j    [i].reset(new MultiFab(amrex::convert(grids,jflag[i]),dmap,1,ngb));
+	    }
+
+	    // Uniform in [0,1), from the index modulo the domain size and the field number
+	    auto periodic_random = [&] (const IntVect& iv, int ifield) {
+		unsigned long h = 88172645463325252ul + ifield;
+		for (int idim = 0; idim < BL_SPACEDIM; ++idim) {
+		    const int n = cc_domain.length(idim);
+		    h = (h ^ static_cast<unsigned long>(((iv[idim] % n) + n) % n)) * 0x9E3779B97F4A7C15ul;
+		    h ^= h >> 29;
+		}
+		return static_cast<Real>(h >> 11) * (1.0/9007199254740992.0);
+	    };
+
+	    for (int i = 0; i < 3; ++i) {
+		for (MFIter mfi(*j[i]); mfi.isValid(); ++mfi)
+		{
+		    FArrayBox& efab = (*E_seq[i])[mfi];
+		    FArrayBox& bfab = (*B_seq[i])[mfi];
+		    FArrayBox& jfab = (*j[i])[mfi];
+		    const Box& ebx = efab.box();
+		    for (IntVect cell=ebx.smallEnd(); cell <= ebx.bigEnd(); ebx.next(cell))
+		    {
+			efab(cell) = periodic_random(cell, i)*1.e5;
+			jfab(cell) = periodic_random(cell, 3+i)*1.e10;
+		    }
+		    const Box& bbx = bfab.box();
+		    for (IntVect cell=bbx.smallEnd(); cell <= bbx.bigEnd(); bbx.next(cell))
+		    {
+			bfab(cell) = periodic_random(cell, 6+i)*1.e-5;
+		    }
+		}
+	    }
+	    Vector<std::unique_ptr<MultiFab> > E_init(3), B_init(3);
+	    for (int i = 0; i < 3; ++i) {
+		E_init[i].reset(new MultiFab(E_seq[i]->boxArray(), dmap, 1, ngb));
+		B_init[i].reset(new MultiFab(B_seq[i]->boxArray(), dmap, 1, ngb));
+		MultiFab::Copy(*E_init[i], *E_seq[i], 0, 0, 1, ngb);
+		MultiFab::Copy(*B_init[i], *B_seq[i], 0, 0, 1, ngb);
+	    }
+
+	    auto relative_difference = [] (const MultiFab& mf, const MultiFab& ref) {
+		MultiFab diff(ref.boxArray(), ref.DistributionMap(), 1, 0);
+		MultiFab::Copy(diff, mf, 0, 0, 1, 0);
+		MultiFab::Subtract(diff, ref, 0, 0, 1, 0);
+		return diff.norm0() / ref.norm0();
+	    };
+
+	    const int nsteps_blocked = 2;
+
+	    for (int solver_id = 0; solver_id <= 1; ++solver_id)
+	    {
+		FieldKernels::Select(0, solver_id);
+
+		for (int i = 0; i < 3; ++i) {
+		    MultiFab::Copy(*E_seq[i], *E_init[i], 0, 0, 1, ngb);
+		    MultiFab::Copy(*B_seq[i], *B_init[i], 0, 0, 1, ngb);
+		    MultiFab::Copy(*E_blk[i], *E_init[i], 0, 0, 1, ngb);
+		    MultiFab::Copy(*B_blk[i], *B_init[i], 0, 0, 1, ngb);
+		}
+
+		auto push_b = [&] ()
+		{
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+		    for ( MFIter mfi(*B_seq[0],true); mfi.isValid(); ++mfi )
+		    {
+			const Box& tbx  = mfi.tilebox(Bx_nodal_flag);
+			const Box& tby  = mfi.tilebox(By_nodal_flag);
+			const Box& tbz  = mfi.tilebox(Bz_nodal_flag);
+			FieldKernels::push_bvec(
+			    tbx.loVect(), tbx.hiVect(),
+			    tby.loVect(), tby.hiVect(),
+			    tbz.loVect(), tbz.hiVect(),
+			    BL_TO_FORTRAN_3D((*E_seq[0])[mfi]),
+			    BL_TO_FORTRAN_3D((*E_seq[1])[mfi]),
+			    BL_TO_FORTRAN_3D((*E_seq[2])[mfi]),
+			    BL_TO_FORTRAN_3D((*B_seq[0])[mfi]),
+			    BL_TO_FORTRAN_3D((*B_seq[1])[mfi]),
+			    BL_TO_FORTRAN_3D((*B_seq[2])[mfi]),
+			    &dtsdx[0], &dtsdx[1], &dtsdx[2],
+			    &solver_id);
+		    }
+		    for (int i = 0; i < 3; ++i) {
+			B_seq[i]->FillBoundary(period);
+		    }
+		};
+
+		for (int step = 0; step < nsteps_blocked; ++step)
+		{
+		    push_b();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+		    for ( MFIter mfi(*E_seq[0],true); mfi.isValid(); ++mfi )
+		    {
+			const Box& tex  = mfi.tilebox(Ex_nodal_flag);
+			const Box& tey  = mfi.tilebox(Ey_nodal_flag);
+			const Box& tez  = mfi.tilebox(Ez_nodal_flag);
+			FieldKernels::push_evec(
+			    tex.loVect(), tex.hiVect(),
+			    tey.loVect(), tey.hiVect(),
+			    tez.loVect(), tez.hiVect(),
+			    BL_TO_FORTRAN_3D((*E_seq[0])[mfi]),
+			    BL_TO_FORTRAN_3D((*E_seq[1])[mfi]),
+			    BL_TO_FORTRAN_3D((*E_seq[2])[mfi]),
+			    BL_TO_FORTRAN_3D((*B_seq[0])[mfi]),
+			    BL_TO_FORTRAN_3D((*B_seq[1])[mfi]),
+			    BL_TO_FORTRAN_3D((*B_seq[2])[mfi]),
+			    BL_TO_FORTRAN_3D((*j[0])[mfi]),
+			    BL_TO_FORTRAN_3D((*j[1])[mfi]),
+			    BL_TO_FORTRAN_3D((*j[2])[mfi]),
+			    &mu_c2_dt,
+			    &dtsdx_c2[0], &dtsdx_c2[1], &dtsdx_c2[2]);
+		    }
+		    for (int i = 0; i < 3; ++i) {
+			E_seq[i]->FillBoundary(period);
+		    }
+
+		    push_b();
+		}
+
+		for (int step = 0; step < nsteps_blocked; ++step)
+		{
+		    // As in WarpX::EvolveFieldsBlocked, where all of the directions are periodic
+		    for (MFIter mfi(*E_blk[0]); mfi.isValid(); ++mfi)
+		    {
+			const Box& cbx = grids[mfi.index()];
+			std::array<Box,3> rB1, rE, rB2;
+			for (int i = 0; i < 3; ++i) {
+			    rB1[i] = amrex::grow(amrex::convert(cbx, Bflag[i]), 2) & (*B_blk[i])[mfi].box();
+			    rE[i]  = amrex::grow(amrex::convert(cbx, Eflag[i]), 1) & (*E_blk[i])[mfi].box();
+			    rB2[i] = amrex::convert(cbx, Bflag[i]);
+			}
+			FieldKernels::PushBlocked(rB1, rE, rB2,
+						  (*E_blk[0])[mfi], (*E_blk[1])[mfi], (*E_blk[2])[mfi],
+						  (*B_blk[0])[mfi], (*B_blk[1])[mfi], (*B_blk[2])[mfi],
+						  (*j[0])[mfi], (*j[1])[mfi], (*j[2])[mfi],
+						  dtsdx, mu_c2_dt, dtsdx_c2, solver_id);
+		    }
+		    for (int i = 0; i < 3; ++i) {
+			E_blk[i]->FillBoundary(period);
+			B_blk[i]->FillBoundary(period);
+		    }
+		}
+
+		Real maxdiff = 0.0;
+		for (int i = 0; i < 3; ++i) {
+		    maxdiff = std::max(maxdiff, relative_difference(*E_blk[i], *E_seq[i]));
+		    maxdiff = std::max(maxdiff, relative_difference(*B_blk[i], *B_seq[i]));
+		}
+		amrex::Print() << "Temporally blocked FDTD push, " << ((solver_id == 1) ? "CKC" : "Yee")
+			       << " solver, max relative difference with the sequential push: "
+			       << maxdiff << "\n";
+		AMREX_ALWAYS_ASSERT_WITH_MESSAGE(maxdiff < 1.e-12,
+		    "The temporally blocked FDTD push does not match the sequential push");
+	    }
+	}
     }
 
     amrex::Finalize();
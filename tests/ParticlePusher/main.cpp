@@ -1,4 +1,6 @@
 
+#include <cmath>
+#include <algorithm>
 #include <limits>
 #include <random>
 
@@ -7,9 +9,11 @@
 #include <AMReX_Vector.H>
 #include <AMReX_MultiFab.H>
 #include <AMReX_PlotFileUtil.H>
+#include <AMReX_Print.H>
 
 #include <WarpXConst.H>
 #include <WarpX_f.H>
+#include <WarpXParticleKernels.H>
 
 using namespace amrex;
 
@@ -24,6 +28,12 @@ int main(int argc, char* argv[])
 	    pp.query("particle_pusher", particle_pusher_algo);
 	}
 
+	int nsteps = 100;
+	{
+	    ParmParse pp("benchmark");
+	    pp.query("nsteps", nsteps);
+	}
+
 	long nx = 64, ny = 64, nz = 64;
 	long np = nx*ny*nz;
 
@@ -78,6 +88,11 @@ int main(int argc, char* argv[])
 	Real charge = -PhysConst::q_e;
 	Real mass   =  PhysConst::m_e;
 	Real dt     = 1.e-10;
+
+	// Initial particles, for the benchmark below
+	const Vector<Real> xp0 = xp, yp0 = yp, zp0 = zp;
+	const Vector<Real> uxp0 = uxp, uyp0 = uyp, uzp0 = uzp;
+
 	warpx_particle_pusher(&np, xp.data(), yp.data(), zp.data(),
 			      uxp.data(), uyp.data(), uzp.data(), giv.data(),
 			      Exp.dataPtr(), Eyp.dataPtr(), Ezp.dataPtr(),
@@ -113,6 +128,52 @@ int main(int argc, char* argv[])
 	std::string plotname{"plotfiles/plt00000"};
 	Vector<std::string> varnames{"x", "y", "z", "ux", "uy", "uz", "gamma"};
 	amrex::WriteSingleLevelPlotfile(plotname, plotmf, varnames, geom, 0.0, 0);
+
+	//
+	// Benchmark of the PICSAR pusher and of the native pushers for each instruction
+	// set supported by the CPU (see algo.use_native_pusher), on one core. The
+	// particles are pushed nsteps times, and the momenta are compared with PICSAR.
+	//
+	Vector<std::string> pushers{"picsar"};
+	for (const auto& isa : ParticleKernels::SupportedPusherISAs()) {
+	    pushers.push_back(isa);
+	}
+
+	Vector<Real> uxp_ref, uyp_ref, uzp_ref;
+	amrex::Print() << "Particle push of " << np << " particles, " << nsteps << " steps, "
+		       << ((particle_pusher_algo == 1) ? "Vay" : "Boris") << " pusher\n";
+	for (const auto& pusher : pushers)
+	{
+	    ParticleKernels::SelectPusher(pusher != "picsar", pusher);
+
+	    xp = xp0; yp = yp0; zp = zp0;
+	    uxp = uxp0; uyp = uyp0; uzp = uzp0;
+
+	    Real t = amrex::second();
+	    for (int step = 0; step < nsteps; ++step) {
+		ParticleKernels::particle_pusher(&np, xp.data(), yp.data(), zp.data(),
+						 uxp.data(), uyp.data(), uzp.data(), giv.data(),
+						 Exp.dataPtr(), Eyp.dataPtr(), Ezp.dataPtr(),
+						 Bxp.dataPtr(), Byp.dataPtr(), Bzp.dataPtr(),
+						 &charge, &mass, &dt,
+						 &particle_pusher_algo);
+	    }
+	    t = amrex::second() - t;
+
+	    if (pusher == "picsar") {
+		uxp_ref = uxp; uyp_ref = uyp; uzp_ref = uzp;
+	    }
+	    Real maxdiff = 0.0;
+	    for (int i = 0; i < np; ++i) {
+		const Real u = std::sqrt(uxp_ref[i]*uxp_ref[i] + uyp_ref[i]*uyp_ref[i] + uzp_ref[i]*uzp_ref[i]);
+		maxdiff = std::max(maxdiff, std::abs(uxp[i]-uxp_ref[i])/u);
+		maxdiff = std::max(maxdiff, std::abs(uyp[i]-uyp_ref[i])/u);
+		maxdiff = std::max(maxdiff, std::abs(uzp[i]-uzp_ref[i])/u);
+	    }
+
+	    amrex::Print() << "  " << pusher << ": " << np*nsteps/t << " particles/s per core"
+			   << ", max relative difference with picsar: " << maxdiff << "\n";
+	}
     }
 
     amrex::Finalize();
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Vector.H>
+#include <AMReX_Print.H>
+
+#include <WarpXConst.H>
+#include <ParticleResampling.H>
+
+using namespace amrex;
+
+//
+// Check of the merging of the particles of an over-populated cell
+// (<species>.resample_algo = merge): the total weight, momentum and kinetic energy
+// of the cell must be conserved to round-off, the merged particles must sit at the
+// position of one of the original particles, and at most max_particles_per_cell
+// particles must be left.
+//
+int main(int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    {
+        int ppc = 200;
+        int max_particles_per_cell = 16;
+        {
+            ParmParse pp("resampling");
+            pp.query("ppc", ppc);
+            pp.query("max_particles_per_cell", max_particles_per_cell);
+        }
+
+        const Real c = PhysConst::c;
+        const Real dx = 1.e-6;
+
+        std::mt19937 rand_eng(42);
+        std::uniform_real_distribution<Real> rand_pos(0.0, dx);
+        std::uniform_real_distribution<Real> rand_w(0.5e10, 1.5e10);
+        std::normal_distribution<Real> rand_u(0.0, 2.0*c);
+
+        Vector<Real> w(ppc), x(ppc), y(ppc), z(ppc), ux(ppc), uy(ppc), uz(ppc);
+        for (int ip = 0; ip < ppc; ++ip) {
+            w[ip] = rand_w(rand_eng);
+            x[ip] = rand_pos(rand_eng);
+            y[ip] = rand_pos(rand_eng);
+            z[ip] = rand_pos(rand_eng);
+            ux[ip] = rand_u(rand_eng) + c;
+            uy[ip] = rand_u(rand_eng);
+            uz[ip] = rand_u(rand_eng);
+        }
+        const Vector<Real> x0 = x, y0 = y, z0 = z;
+
+        // Weight, momentum and kinetic energy of the kept particles
+        auto moments = [&] (const Vector<char>& keep) {
+            std::array<Real,5> m {0.0, 0.0, 0.0, 0.0, 0.0};
+            for (int ip = 0; ip < ppc; ++ip) {
+                if (!keep[ip]) continue;
+                const Real gamma = std::sqrt(1.0 + (ux[ip]*ux[ip] + uy[ip]*uy[ip] + uz[ip]*uz[ip])/(c*c));
+                m[0] += w[ip];
+                m[1] += w[ip]*ux[ip];
+                m[2] += w[ip]*uy[ip];
+                m[3] += w[ip]*uz[ip];
+                m[4] += w[ip]*(gamma - 1.0);
+            }
+            return m;
+        };
+
+        Vector<char> keep(ppc, 1);
+        const std::array<Real,5> m0 = moments(keep);
+
+        Vector<long> pid(ppc);
+        for (int ip = 0; ip < ppc; ++ip) pid[ip] = ip;
+        Vector<long> merged;
+        const ParticleResampling::ParticleArrays particles {w.data(), x.data(), y.data(), z.data(),
+                                                            ux.data(), uy.data(), uz.data()};
+        const long nremoved = ParticleResampling::MergeCell(pid.data(), pid.data()+ppc,
+                                                            max_particles_per_cell, particles,
+                                                            keep.data(), merged);
+
+        const std::array<Real,5> m1 = moments(keep);
+
+        const long nleft = std::count(keep.begin(), keep.end(), 1);
+        amrex::Print() << "Merged " << ppc << " particles into " << nleft << "\n";
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(nleft == ppc - nremoved && nleft <= max_particles_per_cell,
+                                         "Wrong number of particles after merging");
+
+        // The momentum is compared with the sum of the momentum magnitudes
+        Real umag = 0.0;
+        for (int ip = 0; ip < ppc; ++ip) {
+            umag += w[ip]*std::sqrt(ux[ip]*ux[ip] + uy[ip]*uy[ip] + uz[ip]*uz[ip]);
+        }
+        const Real tol = 1.e-12;
+        const std::array<Real,5> scale {m0[0], umag, umag, umag, m0[4]};
+        const char* names[5] = {"weight", "x momentum", "y momentum", "z momentum", "energy"};
+        for (int i = 0; i < 5; ++i) {
+            const Real err = std::abs(m1[i] - m0[i])/scale[i];
+            amrex::Print() << "  relative change of the " << names[i] << ": " << err << "\n";
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(err < tol, "Merging does not conserve the cell moments");
+        }
+
+        for (const long ip : merged) {
+            bool found = false;
+            for (int jp = 0; jp < ppc; ++jp) {
+                found = found || (x[ip] == x0[jp] && y[ip] == y0[jp] && z[ip] == z0[jp]);
+            }
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(found, "Merged particle away from the original particles");
+        }
+
+        amrex::Print() << "SUCCESS\n";
+    }
+
+    amrex::Finalize();
+}
@@ -0,0 +1,301 @@
+#include <random>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Vector.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Print.H>
+
+#include <WarpX_f.H>
+#include <WarpXConst.H>
+
+using namespace amrex;
+
+//
+// Benchmark of the two ways of depositing the current of the particles of
+// many tiles onto one grid with OpenMP (see particles.use_tile_coloring):
+//  - atomic:  each thread deposits a tile onto a thread-local buffer, which is
+//             then added to the grid with atomic updates;
+//  - colored: the tiles are processed one color at a time, and deposited
+//             directly onto the grid.
+// Run it with e.g. OMP_NUM_THREADS=16, 32 and 64.
+//
+
+namespace
+{
+    void AtomicAccumulate (const FArrayBox& src, FArrayBox& dst)
+    {
+        const Box& bx = src.box();
+        for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv))
+        {
+            const Real v = src(iv);
+            Real& d = dst(iv);
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+            d += v;
+        }
+    }
+
+    int TileColor (const Box& tile, const Box& domain, const IntVect& tile_size)
+    {
+        int color = 0;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const int itile = (tile.smallEnd(idim) - domain.smallEnd(idim)) / tile_size[idim];
+            color |= (itile % 2) << idim;
+        }
+        return color;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    {
+        long nox=1, noy=1, noz=1;
+        {
+            ParmParse pp("interpolation");
+            pp.query("nox", nox);
+            pp.query("noy", noy);
+            pp.query("noz", noz);
+            if (nox != noy || nox != noz) {
+                amrex::Abort("warpx.nox, noy and noz must be equal");
+            }
+            if (nox < 1) {
+                amrex::Abort("warpx.nox must >= 1");
+            }
+        }
+
+        long current_deposition_algo = 3;
+        {
+            ParmParse pp("algo");
+            pp.query("current_deposition", current_deposition_algo);
+        }
+
+        int n_cell = 128;
+        int tile_size = 8;
+        int ppc = 8;
+        int nsteps = 10;
+        {
+            ParmParse pp("benchmark");
+            pp.query("n_cell", n_cell);
+            pp.query("tile_size", tile_size);
+            pp.query("ppc", ppc);
+            pp.query("nsteps", nsteps);
+        }
+
+        const int ng = nox;
+        if (tile_size <= 2*ng) {
+            amrex::Abort("benchmark.tile_size must be larger than twice the number of guard cells");
+        }
+
+        Real charge = -PhysConst::q_e;
+        Real weight = 10.0;
+        Real dt = 1.e-10;
+        Real dx[3] = {1.0/n_cell, 1.0/n_cell, 1.0/n_cell};
+        Real xyzmin[3] = {0.5, 1.4, 0.3};
+
+        Box domain_box {IntVect{D_DECL(0,0,0)}, IntVect{D_DECL(n_cell-1,n_cell-1,n_cell-1)}};
+
+        // The tiles of the grid
+        BoxArray tiles{domain_box};
+        tiles.maxSize(tile_size);
+        const int ntiles = tiles.size();
+        const IntVect tsize(D_DECL(tile_size,tile_size,tile_size));
+
+        // The particles of each tile, uniformly distributed in the tile
+        struct TileParticles {
+            Vector<Real> xp, yp, zp, uxp, uyp, uzp, giv, wp;
+        };
+        Vector<TileParticles> particles(ntiles);
+
+        std::mt19937 rand_eng(42);
+        std::uniform_real_distribution<Real> rand_dis(0.0,1.0);
+
+        for (int t = 0; t < ntiles; ++t)
+        {
+            TileParticles& ptile = particles[t];
+            const Box& tbx = tiles[t];
+            for (IntVect iv = tbx.smallEnd(); iv <= tbx.bigEnd(); tbx.next(iv))
+            {
+                for (int ip = 0; ip < ppc; ++ip)
+                {
+#if (AMREX_SPACEDIM == 3)
+                    ptile.xp.push_back(xyzmin[0] + (iv[0] + rand_dis(rand_eng))*dx[0]);
+                    ptile.yp.push_back(xyzmin[1] + (iv[1] + rand_dis(rand_eng))*dx[1]);
+                    ptile.zp.push_back(xyzmin[2] + (iv[2] + rand_dis(rand_eng))*dx[2]);
+#else
+                    ptile.xp.push_back(xyzmin[0] + (iv[0] + rand_dis(rand_eng))*dx[0]);
+                    ptile.yp.push_back(0.0);
+                    ptile.zp.push_back(xyzmin[2] + (iv[1] + rand_dis(rand_eng))*dx[2]);
+#endif
+                    ptile.wp.push_back(weight);
+                    Real vx,vy,vz,v2;
+                    do {
+                        vx = rand_dis(rand_eng);
+                        vy = rand_dis(rand_eng);
+                        vz = rand_dis(rand_eng);
+                        v2 = vx*vx + vy*vy + vz*vz;
+                    } while(v2 >= 0.999999);
+                    Real gam = 1.0/sqrt(1.0-v2);
+                    ptile.uxp.push_back(vx*gam);
+                    ptile.uyp.push_back(vy*gam);
+                    ptile.uzp.push_back(vz*gam);
+                    ptile.giv.push_back(1.0/gam);
+                }
+            }
+        }
+
+#if (AMREX_SPACEDIM == 3)
+        IntVect jx_nodal_flag(0,1,1);
+        IntVect jy_nodal_flag(1,0,1);
+        IntVect jz_nodal_flag(1,1,0);
+#elif (AMREX_SPACEDIM == 2)
+        IntVect jx_nodal_flag(0,1);  // x is the first dimension to AMReX
+        IntVect jy_nodal_flag(1,1);  // y is the missing dimension to 2D AMReX
+        IntVect jz_nodal_flag(1,0);  // z is the second dimension to 2D AMReX
+#endif
+
+        const long ngJ = ng;
+        long lvect = 8;
+
+        FArrayBox jx_atomic(amrex::grow(amrex::convert(domain_box,jx_nodal_flag),ng));
+        FArrayBox jy_atomic(amrex::grow(amrex::convert(domain_box,jy_nodal_flag),ng));
+        FArrayBox jz_atomic(amrex::grow(amrex::convert(domain_box,jz_nodal_flag),ng));
+        FArrayBox jx_colored(jx_atomic.box());
+        FArrayBox jy_colored(jy_atomic.box());
+        FArrayBox jz_colored(jz_atomic.box());
+
+        //
+        // Atomic accumulation of thread-local buffers
+        //
+        jx_atomic.setVal(0.0);
+        jy_atomic.setVal(0.0);
+        jz_atomic.setVal(0.0);
+
+        Real t_atomic = amrex::second();
+        for (int step = 0; step < nsteps; ++step)
+        {
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+            {
+                FArrayBox local_jx, local_jy, local_jz;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+                for (int t = 0; t < ntiles; ++t)
+                {
+                    TileParticles& ptile = particles[t];
+                    long np = ptile.xp.size();
+                    const Box& tbx = tiles[t];
+                    Real txyzmin[3] = {xyzmin[0], xyzmin[1], xyzmin[2]};
+#if (AMREX_SPACEDIM == 3)
+                    txyzmin[0] += tbx.smallEnd(0)*dx[0];
+                    txyzmin[1] += tbx.smallEnd(1)*dx[1];
+                    txyzmin[2] += tbx.smallEnd(2)*dx[2];
+#else
+                    txyzmin[0] += tbx.smallEnd(0)*dx[0];
+                    txyzmin[2] += tbx.smallEnd(1)*dx[2];
+#endif
+
+                    local_jx.resize(amrex::grow(amrex::convert(tbx,jx_nodal_flag),ng));
+                    local_jy.resize(amrex::grow(amrex::convert(tbx,jy_nodal_flag),ng));
+                    local_jz.resize(amrex::grow(amrex::convert(tbx,jz_nodal_flag),ng));
+                    local_jx.setVal(0.0);
+                    local_jy.setVal(0.0);
+                    local_jz.setVal(0.0);
+
+                    warpx_current_deposition(local_jx.dataPtr(), &ngJ, local_jx.length(),
+                                             local_jy.dataPtr(), &ngJ, local_jy.length(),
+                                             local_jz.dataPtr(), &ngJ, local_jz.length(),
+                                             &np, ptile.xp.data(), ptile.yp.data(), ptile.zp.data(),
+                                             ptile.uxp.data(), ptile.uyp.data(), ptile.uzp.data(),
+                                             ptile.giv.data(), ptile.wp.data(), &charge,
+                                             &txyzmin[0], &txyzmin[1], &txyzmin[2],
+                                             &dt, &dx[0], &dx[1], &dx[2],
+                                             &nox, &noy, &noz,
+                                             &lvect, &current_deposition_algo);
+
+                    AtomicAccumulate(local_jx, jx_atomic);
+                    AtomicAccumulate(local_jy, jy_atomic);
+                    AtomicAccumulate(local_jz, jz_atomic);
+                }
+            }
+        }
+        t_atomic = amrex::second() - t_atomic;
+
+        //
+        // Tile coloring, with direct deposition onto the grid
+        //
+        jx_colored.setVal(0.0);
+        jy_colored.setVal(0.0);
+        jz_colored.setVal(0.0);
+
+        const int ncolors = 1 << AMREX_SPACEDIM;
+        Vector<Vector<int> > color_tiles(ncolors);
+        for (int t = 0; t < ntiles; ++t) {
+            color_tiles[TileColor(tiles[t], domain_box, tsize)].push_back(t);
+        }
+
+        Real t_colored = amrex::second();
+        for (int step = 0; step < nsteps; ++step)
+        {
+            for (int color = 0; color < ncolors; ++color)
+            {
+                const Vector<int>& ctiles = color_tiles[color];
+                const int nctiles = ctiles.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+                for (int it = 0; it < nctiles; ++it)
+                {
+                    TileParticles& ptile = particles[ctiles[it]];
+                    long np = ptile.xp.size();
+                    warpx_current_deposition(jx_colored.dataPtr(), &ngJ, jx_colored.length(),
+                                             jy_colored.dataPtr(), &ngJ, jy_colored.length(),
+                                             jz_colored.dataPtr(), &ngJ, jz_colored.length(),
+                                             &np, ptile.xp.data(), ptile.yp.data(), ptile.zp.data(),
+                                             ptile.uxp.data(), ptile.uyp.data(), ptile.uzp.data(),
+                                             ptile.giv.data(), ptile.wp.data(), &charge,
+                                             &xyzmin[0], &xyzmin[1], &xyzmin[2],
+                                             &dt, &dx[0], &dx[1], &dx[2],
+                                             &nox, &noy, &noz,
+                                             &lvect, &current_deposition_algo);
+                }
+            }
+        }
+        t_colored = amrex::second() - t_colored;
+
+        //
+        // Both methods must give the same current, up to round-off
+        //
+        Real maxdiff = 0.0, maxval = 0.0;
+        const FArrayBox* atomic_fabs[3] = {&jx_atomic, &jy_atomic, &jz_atomic};
+        FArrayBox* colored_fabs[3] = {&jx_colored, &jy_colored, &jz_colored};
+        for (int i = 0; i < 3; ++i) {
+            maxval = std::max(maxval, atomic_fabs[i]->norm(0));
+            colored_fabs[i]->minus(*atomic_fabs[i]);
+            maxdiff = std::max(maxdiff, colored_fabs[i]->norm(0));
+        }
+
+#ifdef _OPENMP
+        const int nthreads = omp_get_max_threads();
+#else
+        const int nthreads = 1;
+#endif
+        amrex::Print() << "Current deposition of " << n_cell << "^" << AMREX_SPACEDIM << " cells, "
+                       << ppc << " particles per cell, tiles of " << tile_size << " cells, "
+                       << nthreads << " threads, " << nsteps << " steps\n"
+                       << "  atomic accumulation: " << t_atomic << " s\n"
+                       << "  tile coloring:       " << t_colored << " s\n"
+                       << "  max relative difference: " << maxdiff/maxval << "\n";
+    }
+
+    amrex::Finalize();
+}